@@ -0,0 +1,452 @@
+/*  File: ONEarrow.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: export the lines of a ONE file as Arrow C Data Interface arrays
+ *   each line type has a table of columns that grow as lines are read; at the end of a
+ *   batch their buffers pass to an arena that is freed when its last array is released
+ * Exported functions: see ONEarrow.h
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEarrow.h"
+
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+typedef struct
+  { I64     n, max ;	// elements in data: rows for INT, REAL, CHAR, else list elements
+    void   *data ;
+    I64    *off ;	// rows+1 offsets into data, or for STRING_LIST into soff
+    I64     nStr, maxStr ;
+    I64    *soff ;	// for STRING_LIST, nStr+1 offsets into data
+  } Column ;
+
+typedef struct
+  { char     lineType ;
+    int      nField ;
+    OneType *fieldType ;
+    I64      nRow, maxRow ;
+    I64     *object ;
+    Column  *col ;
+  } Table ;
+
+struct OneArrowReaderStruct
+  { OneFile *vf ;
+    int      nType ;
+    char    *types ;
+    Table   *table ;
+    Table   *tableOf[128] ;
+    bool     isPending ;	// the current line of vf starts the next batch
+    bool     isEnd ;
+  } ;
+
+typedef struct
+  { int    refs ;		// arrays not yet released, plus one while exporting
+    int    nBuf, maxBuf ;
+    void **buf ;
+    pthread_mutex_t lock ;
+  } Arena ;
+
+typedef struct
+  { Arena       *arena ;
+    const void  *buffers[3] ;
+    struct ArrowArray  *child ;
+    struct ArrowArray **children ;
+  } ArrayPrivate ;
+
+typedef struct
+  { char         name[16] ;
+    struct ArrowSchema  *child ;
+    struct ArrowSchema **children ;
+  } SchemaPrivate ;
+
+/************************** arena ***************************/
+
+static Arena *arenaCreate (void)
+{ Arena *arena = new0 (1, Arena) ;
+
+  arena->refs = 1 ;
+  pthread_mutex_init (&arena->lock, 0) ;
+  return arena ;
+}
+
+static void arenaAdd (Arena *arena, void *x)
+{ if (arena->nBuf == arena->maxBuf)
+    { int newMax = arena->maxBuf ? 2*arena->maxBuf : 64 ;
+      resize (arena->buf, arena->maxBuf, newMax, void*) ;
+      arena->maxBuf = newMax ;
+    }
+  arena->buf[arena->nBuf++] = x ;
+}
+
+static void arenaRef (Arena *arena)
+{ pthread_mutex_lock (&arena->lock) ;
+  ++arena->refs ;
+  pthread_mutex_unlock (&arena->lock) ;
+}
+
+static void arenaUnref (Arena *arena)
+{ int i, refs ;
+
+  pthread_mutex_lock (&arena->lock) ;
+  refs = --arena->refs ;
+  pthread_mutex_unlock (&arena->lock) ;
+  if (refs) return ;
+
+  for (i = 0 ; i < arena->nBuf ; ++i)
+    free (arena->buf[i]) ;
+  free (arena->buf) ;
+  pthread_mutex_destroy (&arena->lock) ;
+  free (arena) ;
+}
+
+/********************** arrow structs ***********************/
+
+static void arrayRelease (struct ArrowArray *a)
+{ ArrayPrivate *p = (ArrayPrivate *) a->private_data ;
+  int i ;
+
+  for (i = 0 ; i < a->n_children ; ++i) // children moved out by the consumer have release 0
+    if (p->child[i].release)
+      p->child[i].release (&p->child[i]) ;
+  free (p->child) ;
+  free (p->children) ;
+  arenaUnref (p->arena) ;
+  free (p) ;
+  a->release = 0 ;
+}
+
+static void arrayInit (struct ArrowArray *a, Arena *arena, I64 length, int nBuffers, int nChildren)
+{ ArrayPrivate *p = new0 (1, ArrayPrivate) ;
+  int i ;
+
+  arenaRef (arena) ;
+  p->arena = arena ;
+  if (nChildren)
+    { p->child = new0 (nChildren, struct ArrowArray) ;
+      p->children = new (nChildren, struct ArrowArray*) ;
+      for (i = 0 ; i < nChildren ; ++i)
+	p->children[i] = &p->child[i] ;
+    }
+  memset (a, 0, sizeof(struct ArrowArray)) ;
+  a->length = length ;
+  a->n_buffers = nBuffers ;
+  a->n_children = nChildren ;
+  a->buffers = p->buffers ;	// buffers[0] is the validity bitmap, 0 as there are no nulls
+  a->children = p->children ;
+  a->release = arrayRelease ;
+  a->private_data = p ;
+}
+
+static void schemaRelease (struct ArrowSchema *s)
+{ SchemaPrivate *p = (SchemaPrivate *) s->private_data ;
+  int i ;
+
+  for (i = 0 ; i < s->n_children ; ++i)
+    if (p->child[i].release)
+      p->child[i].release (&p->child[i]) ;
+  free (p->child) ;
+  free (p->children) ;
+  free (p) ;
+  s->release = 0 ;
+}
+
+static void schemaInit (struct ArrowSchema *s, const char *format, char *name, int nChildren)
+{ SchemaPrivate *p = new0 (1, SchemaPrivate) ;
+  int i ;
+
+  snprintf (p->name, sizeof(p->name), "%s", name) ;
+  if (nChildren)
+    { p->child = new0 (nChildren, struct ArrowSchema) ;
+      p->children = new (nChildren, struct ArrowSchema*) ;
+      for (i = 0 ; i < nChildren ; ++i)
+	p->children[i] = &p->child[i] ;
+    }
+  memset (s, 0, sizeof(struct ArrowSchema)) ;
+  s->format = format ;		// static strings
+  s->name = p->name ;
+  s->n_children = nChildren ;
+  s->children = p->children ;
+  s->release = schemaRelease ;
+  s->private_data = p ;
+}
+
+/************************** tables **************************/
+
+static int eltSize (OneType type)
+{ return (type == oneCHAR || type == oneSTRING || type == oneDNA || type == oneSTRING_LIST)
+    ? 1 : 8 ;
+}
+
+static void *grow (void *x, I64 n, I64 *max, I64 need, int size)
+{ I64   newMax ;
+  void *z ;
+
+  if (need <= *max) return x ;
+  newMax = 2 * *max ;
+  if (newMax < need) newMax = need ;
+  z = myalloc (newMax * size) ;
+  if (n) memcpy (z, x, n * size) ;
+  free (x) ;
+  *max = newMax ;
+  return z ;
+}
+
+static bool isList (OneType type)
+{ return type >= oneSTRING ; }
+
+static void tableStart (Table *tb) // sized for the largest batch so far, to save regrowing
+{ int k ;
+
+  if (tb->maxRow < 16) tb->maxRow = 16 ;
+  tb->nRow = 0 ;
+  tb->object = new (tb->maxRow, I64) ;
+  for (k = 0 ; k < tb->nField ; ++k)
+    { Column *c = &tb->col[k] ;
+      OneType type = tb->fieldType[k] ;
+      if (isList (type))
+	{ c->off = new (tb->maxRow+1, I64) ;
+	  c->off[0] = 0 ;
+	  if (c->max < 64) c->max = 64 ;
+	}
+      else
+	c->max = tb->maxRow ;
+      c->n = 0 ;
+      c->data = myalloc (c->max * eltSize (type)) ;
+      if (type == oneSTRING_LIST)
+	{ if (c->maxStr < 16) c->maxStr = 16 ;
+	  c->nStr = 0 ;
+	  c->soff = new (c->maxStr, I64) ;
+	  c->soff[0] = 0 ;
+	}
+    }
+}
+
+static void tableGrow (Table *tb)
+{ I64 maxRow = tb->maxRow ;
+  int k ;
+
+  tb->object = (I64 *) grow (tb->object, tb->nRow, &maxRow, tb->nRow+1, sizeof(I64)) ;
+  for (k = 0 ; k < tb->nField ; ++k)
+    { Column *c = &tb->col[k] ;
+      if (isList (tb->fieldType[k]))
+	{ I64 maxOff = tb->maxRow+1 ;
+	  c->off = (I64 *) grow (c->off, tb->nRow+1, &maxOff, maxRow+1, sizeof(I64)) ;
+	}
+      else
+	c->data = grow (c->data, c->n, &c->max, maxRow, eltSize (tb->fieldType[k])) ;
+    }
+  tb->maxRow = maxRow ;
+}
+
+static void columnAddList (Column *c, void *x, I64 len, int size)
+{ c->data = grow (c->data, c->n, &c->max, c->n + len, size) ;
+  memcpy ((char *) c->data + c->n*size, x, len*size) ;
+  c->n += len ;
+}
+
+static void tableAddLine (Table *tb, OneFile *vf)
+{ I64 row = tb->nRow, len, i ;
+  int k ;
+
+  if (row == tb->maxRow) tableGrow (tb) ;
+  tb->object[row] = (vf->lineType == vf->groupType) ? vf->object : vf->object - 1 ;
+  for (k = 0 ; k < tb->nField ; ++k)
+    { Column *c = &tb->col[k] ;
+      switch (tb->fieldType[k])
+	{
+	case oneINT:  ((I64 *) c->data)[c->n++] = oneInt (vf, k) ; break ;
+	case oneREAL: ((double *) c->data)[c->n++] = oneReal (vf, k) ; break ;
+	case oneCHAR: ((U8 *) c->data)[c->n++] = (U8) oneChar (vf, k) ; break ;
+	case oneSTRING: case oneDNA:
+	  len = oneLen (vf) ;
+	  if (len) columnAddList (c, oneList (vf), len, 1) ;
+	  break ;
+	case oneINT_LIST: case oneREAL_LIST:
+	  len = oneLen (vf) ;
+	  if (len) columnAddList (c, oneList (vf), len, 8) ;
+	  break ;
+	case oneSTRING_LIST:
+	  { char *s = oneString (vf) ;
+	    len = oneLen (vf) ;
+	    c->soff = (I64 *) grow (c->soff, c->nStr+1, &c->maxStr, c->nStr + len + 1, sizeof(I64)) ;
+	    for (i = 0 ; i < len ; ++i, s = oneNextString (vf, s))
+	      { columnAddList (c, s, strlen (s), 1) ;
+		c->soff[++c->nStr] = c->n ;
+	      }
+	    c->off[row+1] = c->nStr ;
+	    continue ;
+	  }
+	}
+      if (isList (tb->fieldType[k]))
+	c->off[row+1] = c->n ;
+    }
+  tb->nRow = row + 1 ;
+}
+
+static char *typeFormat (OneType type)
+{ switch (type)
+    { case oneINT: case oneINT_LIST: return "l" ;
+      case oneREAL: case oneREAL_LIST: return "g" ;
+      case oneCHAR: return "C" ;
+      default: return "U" ;	// STRING, DNA and the strings of STRING_LIST
+    }
+}
+
+static void tableExport (Table *tb, Arena *arena, struct ArrowSchema *s, struct ArrowArray *a)
+{ char name[16] ;
+  int  k ;
+
+  name[0] = tb->lineType ; name[1] = 0 ;
+  schemaInit (s, "+s", name, tb->nField+1) ;
+  arrayInit (a, arena, tb->nRow, 1, tb->nField+1) ;
+
+  schemaInit (s->children[0], "l", "object", 0) ;
+  arrayInit (a->children[0], arena, tb->nRow, 2, 0) ;
+  a->children[0]->buffers[1] = tb->object ;
+  arenaAdd (arena, tb->object) ;
+
+  for (k = 0 ; k < tb->nField ; ++k)
+    { struct ArrowSchema *cs = s->children[k+1] ;
+      struct ArrowArray  *ca = a->children[k+1] ;
+      Column  *c = &tb->col[k] ;
+      OneType  type = tb->fieldType[k] ;
+      sprintf (name, "%c.%d", tb->lineType, k) ;
+      arenaAdd (arena, c->data) ;
+      if (!isList (type))
+	{ schemaInit (cs, typeFormat (type), name, 0) ;
+	  arrayInit (ca, arena, tb->nRow, 2, 0) ;
+	  ca->buffers[1] = c->data ;
+	  continue ;
+	}
+      arenaAdd (arena, c->off) ;
+      if (type == oneSTRING || type == oneDNA)
+	{ schemaInit (cs, "U", name, 0) ;
+	  arrayInit (ca, arena, tb->nRow, 3, 0) ;
+	  ca->buffers[1] = c->off ;
+	  ca->buffers[2] = c->data ;
+	  continue ;
+	}
+      schemaInit (cs, "+L", name, 1) ;	// a large list of the elements in a child array
+      arrayInit (ca, arena, tb->nRow, 2, 1) ;
+      ca->buffers[1] = c->off ;
+      if (type == oneSTRING_LIST)
+	{ schemaInit (cs->children[0], "U", "item", 0) ;
+	  arrayInit (ca->children[0], arena, c->nStr, 3, 0) ;
+	  ca->children[0]->buffers[1] = c->soff ;
+	  ca->children[0]->buffers[2] = c->data ;
+	  arenaAdd (arena, c->soff) ;
+	}
+      else
+	{ schemaInit (cs->children[0], typeFormat (type), "item", 0) ;
+	  arrayInit (ca->children[0], arena, c->n, 2, 0) ;
+	  ca->children[0]->buffers[1] = c->data ;
+	}
+    }
+  tb->object = 0 ;		// the buffers now belong to the arena
+  for (k = 0 ; k < tb->nField ; ++k)
+    { tb->col[k].data = 0 ; tb->col[k].off = 0 ; tb->col[k].soff = 0 ; }
+}
+
+/************************** reader **************************/
+
+OneArrowReader *oneArrowReaderCreate (OneFile *vf, char *lineTypes)
+{ OneArrowReader *ar ;
+  char  all[128], *t ;
+  int   i, n = 0 ;
+
+  if (!lineTypes)
+    { for (i = 'A' ; i <= 'z' ; ++i)
+	if (isalpha (i) && vf->info[i] && vf->info[i]->given.count > 0)
+	  all[n++] = i ;
+      all[n] = 0 ;
+      lineTypes = all ;
+    }
+
+  for (t = lineTypes ; *t ; ++t)
+    if (!isalpha (*t) || !vf->info[(int) *t])
+      { fprintf (stderr, "line type %c is not a data line type of this file\n", *t) ;
+	return 0 ;
+      }
+    else if (vf->info[(int) *t]->isStream)
+      { fprintf (stderr, "line type %c is streamed, so its lists can not be exported\n", *t) ;
+	return 0 ;
+      }
+
+  ar = new0 (1, OneArrowReader) ;
+  ar->vf = vf ;
+  ar->nType = strlen (lineTypes) ;
+  ar->types = strdup (lineTypes) ;
+  ar->table = new0 (ar->nType, Table) ;
+  for (i = 0 ; i < ar->nType ; ++i)
+    { Table   *tb = &ar->table[i] ;
+      OneInfo *li = vf->info[(int) lineTypes[i]] ;
+      if (ar->tableOf[(int) lineTypes[i]])
+	{ fprintf (stderr, "line type %c is given twice\n", lineTypes[i]) ;
+	  oneArrowReaderDestroy (ar) ;
+	  return 0 ;
+	}
+      ar->tableOf[(int) lineTypes[i]] = tb ;
+      tb->lineType = lineTypes[i] ;
+      tb->nField = li->nField ;
+      tb->fieldType = li->fieldType ;
+      tb->col = new0 (li->nField, Column) ;
+    }
+  return ar ;
+}
+
+const char *oneArrowLineTypes (OneArrowReader *ar)
+{ return ar->types ; }
+
+bool oneArrowReadBatch (OneArrowReader *ar, I64 maxObjects,
+			struct ArrowSchema *schemas, struct ArrowArray *arrays)
+{ OneFile *vf = ar->vf ;
+  I64      nObject = 0 ;
+  Arena   *arena ;
+  char     t ;
+  int      i ;
+
+  if (ar->isEnd) return false ;
+  t = ar->isPending ? vf->lineType : oneReadLine (vf) ;
+  ar->isPending = false ;
+  if (!t)
+    { ar->isEnd = true ; return false ; }
+  if (maxObjects < 1) maxObjects = 1 ;
+
+  for (i = 0 ; i < ar->nType ; ++i)
+    tableStart (&ar->table[i]) ;
+
+  for ( ; t ; t = oneReadLine (vf))
+    { if (t == vf->objectType || t == vf->groupType)
+	{ if (nObject == maxObjects)
+	    { ar->isPending = true ; break ; }
+	  if (t == vf->objectType) ++nObject ;
+	}
+      if (ar->tableOf[(int) t])
+	tableAddLine (ar->tableOf[(int) t], vf) ;
+    }
+  if (!t) ar->isEnd = true ;
+
+  arena = arenaCreate () ;
+  for (i = 0 ; i < ar->nType ; ++i)
+    tableExport (&ar->table[i], arena, &schemas[i], &arrays[i]) ;
+  arenaUnref (arena) ;		// now held only by the arrays
+
+  return true ;
+}
+
+void oneArrowReaderDestroy (OneArrowReader *ar)
+{ int i ;
+
+  for (i = 0 ; i < ar->nType ; ++i)
+    free (ar->table[i].col) ;
+  free (ar->table) ;
+  free (ar->types) ;
+  free (ar) ;
+}
+
+/******************* end of file **************/
@@ -0,0 +1,105 @@
+/*  File: ONEarrow.h
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: export the lines of a ONE file as Arrow C Data Interface arrays
+ *
+ * The Arrow C Data Interface is an ABI, two plain C structs given in its specification and
+ * copied below, so a program that links an Arrow implementation, e.g. pyarrow, polars,
+ * DuckDB or arrow-rs, can take data from this without a conversion, and without this
+ * needing any Arrow library.  Objects are read in batches, and for each line type asked
+ * for a batch is a struct array with a row for each line of that type, with columns
+ *    object    int64 "l"     the object the line is in, or for a group line the first object
+ *                              of the group, numbered from 0 as by oneGotoObject(), or -1
+ *                              for a line before the first object
+ *    X.k       field k of line type X, named as in ONEview -f, of Arrow type
+ *                INT "l" int64, REAL "g" float64, CHAR "C" uint8,
+ *                STRING and DNA "U" large utf8, INT_LIST "+L" of "l", REAL_LIST "+L" of "g",
+ *                STRING_LIST "+L" of "U"
+ * There are no nulls.  Large (64 bit offset) strings and lists are used so that a batch
+ * can hold more than 2GB of sequence.  The buffers of a batch are allocated as the lines
+ * are decoded, owned by the batch, and freed when the consumer has released all the arrays
+ * of the batch, including any children it moved out.  Releases can be from any thread.
+ *
+ * Exported functions: see below
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#ifndef ONE_ARROW_DEFINED
+#define ONE_ARROW_DEFINED
+
+#include "ONElib.h"
+
+#ifndef ARROW_C_DATA_INTERFACE	// as given in the Arrow specification
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+typedef struct OneArrowReaderStruct OneArrowReader ;
+
+OneArrowReader *oneArrowReaderCreate (OneFile *vf, char *lineTypes) ;
+
+  // Prepare to read batches from vf, from its current position, which must be at the start
+  //   of the data or at the end of a previous batch, for the line types in lineTypes, e.g.
+  //   "AIT" for an aln file, or all the line types of the file with data if NULL.  Returns
+  //   NULL with a message to stderr if a type is not in the schema of vf, or is streamed.
+  //   Other line types are skipped.
+
+const char *oneArrowLineTypes (OneArrowReader *ar) ;
+
+  // The line types of the reader in order, as a string.
+
+bool oneArrowReadBatch (OneArrowReader *ar, I64 maxObjects,
+			struct ArrowSchema *schemas, struct ArrowArray *arrays) ;
+
+  // Read up to maxObjects objects and fill in schemas[i] and arrays[i] for line type i of
+  //   oneArrowLineTypes(), which the caller must release by calling their release callbacks.
+  //   The lines before the first object go in the first batch, and a group line in the batch
+  //   of the first object of its group.  Returns false at the end of the data, when schemas
+  //   and arrays are not filled in.
+
+void oneArrowReaderDestroy (OneArrowReader *ar) ;
+
+  // Free the reader, not vf.  Batches already returned remain valid until released.
+
+#endif // ONE_ARROW_DEFINED
+
+/******************* end of file **************/
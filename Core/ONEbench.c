@@ -0,0 +1,342 @@
+/*  File: ONEbench.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: end-to-end throughput benchmark for ONElib reading and writing
+ *   Generates synthetic seq, irp, aln, rmp and hit files with the VGP schema, and times
+ *   writing and reading them in ascii, binary and binary without list codecs, with 1..N
+ *   threads, and random access by oneGotoObject().  Each measurement runs in its own
+ *   forked process so that its peak RSS is its own.  Output is tab separated, one line
+ *   per measurement, after a header line starting with '#'.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+#include "../VGP/VGPschema.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+typedef struct {
+  char *name ;			// name used in output and file names
+  char *fileType ;		// type passed to oneFileOpenWriteNew(), may be a secondary type
+  I64   objBytes ;		// approximate ascii bytes per object, to set the number of objects
+} BenchType ;
+
+static BenchType benchTypes[] = {
+  { "seq", "seq", 10030 },	// S 1000-9000 random DNA, I name, Q qualities
+  { "irp", "irp", 330 },	// pairs of S 150 and Q, with P before each pair
+  { "aln", "sxs", 670 },	// A, I, D, and trace point lists W and X of length 100
+  { "rmp", "rmm", 950 },	// R length and 50 sites, E enzymes and I intensities
+  { "hit", "s2k", 400 },	// H with 20 targets, O and P offsets
+  { 0, 0, 0 }
+} ;
+
+typedef struct {
+  BenchType *bt ;
+  char      *format ;		// "ascii", "binary" or "binary-nocodec"
+  char      *path ;
+  int        nthreads ;
+  char      *op ;		// "write", "read" or "goto"
+  I64        nObj ;		// objects to write
+  I64        nGoto ;		// random accesses
+  I64        bytes, objects ;	// results
+} Bench ;
+
+static OneSchema *schema ;
+
+/****************** synthetic data ******************/
+
+#define POOL (1 << 22)
+#define MAX_SEQ 10000
+
+static char *dnaPool, *qvPool ;
+
+static inline U64 rnd (U64 *s)	// splitmix64, so objects are the same whatever the threads
+{ U64 z = (*s += 0x9e3779b97f4a7c15ULL) ;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL ;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL ;
+  return z ^ (z >> 31) ;
+}
+
+static void makePools (void)
+{ U64 s = 17 ;
+  int i, q = 30 ;
+  dnaPool = new (POOL + MAX_SEQ, char) ;
+  qvPool = new (POOL + MAX_SEQ, char) ;
+  for (i = 0 ; i < POOL + MAX_SEQ ; ++i)
+    { U64 r = rnd (&s) ;
+      dnaPool[i] = "acgt"[r & 3] ;
+      q += (int)((r >> 8) % 5) - 2 ; // a random walk is more like real quality values
+      if (q < 0) q = 0 ; else if (q > 40) q = 40 ;
+      qvPool[i] = '!' + q ;
+    }
+}
+
+static void writeObject (OneFile *vf, BenchType *bt, I64 i)
+{ U64    s = i ;
+  I64    j, n, x, list[128] ;
+  double real[64] ;
+  char   name[32] ;
+
+  switch (*bt->name)
+    {
+    case 's':			// seq
+      n = 1000 + rnd(&s) % 8000 ;
+      oneWriteLine (vf, 'S', n, dnaPool + rnd(&s) % POOL) ;
+      oneWriteLine (vf, 'Q', n, qvPool + rnd(&s) % POOL) ;
+      n = sprintf (name, "read/%lld", (long long) i) ;
+      oneWriteLine (vf, 'I', n, name) ;
+      break ;
+    case 'i':			// irp
+      if (!(i & 1)) oneWriteLine (vf, 'P', 0, 0) ;
+      oneWriteLine (vf, 'S', 150, dnaPool + rnd(&s) % POOL) ;
+      oneWriteLine (vf, 'Q', 150, qvPool + rnd(&s) % POOL) ;
+      break ;
+    case 'a':			// aln
+      oneInt(vf,0) = i / 10 ; oneInt(vf,1) = rnd(&s) % 1000000 ;
+      oneWriteLine (vf, 'A', 0, 0) ;
+      x = rnd(&s) % 10000 ;
+      oneInt(vf,0) = x ; oneInt(vf,1) = x + 10000 ; oneInt(vf,2) = 20000 ;
+      x = rnd(&s) % 10000 ;
+      oneInt(vf,3) = x ; oneInt(vf,4) = x + 10000 ; oneInt(vf,5) = 20000 ;
+      oneWriteLine (vf, 'I', 0, 0) ;
+      oneInt(vf,0) = rnd(&s) % 1500 ;
+      oneWriteLine (vf, 'D', 0, 0) ;
+      for (j = 0 ; j < 100 ; ++j) list[j] = 95 + rnd(&s) % 11 ;
+      oneWriteLine (vf, 'W', 100, list) ;
+      for (j = 0 ; j < 100 ; ++j) list[j] = rnd(&s) % 8 ;
+      oneWriteLine (vf, 'X', 100, list) ;
+      break ;
+    case 'r':			// rmp
+      for (x = 0, j = 0 ; j < 50 ; ++j) list[j] = (x += 1 + rnd(&s) % 10000) ;
+      oneInt(vf,0) = x + rnd(&s) % 10000 ;
+      oneWriteLine (vf, 'R', 50, list) ;
+      for (j = 0 ; j < 50 ; ++j) list[j] = rnd(&s) & 1 ;
+      oneWriteLine (vf, 'E', 50, list) ;
+      for (j = 0 ; j < 50 ; ++j) real[j] = (rnd(&s) % 100000) / 1000.0 ;
+      oneWriteLine (vf, 'I', 50, real) ;
+      break ;
+    case 'h':			// hit
+      oneInt(vf,0) = i ;
+      for (x = 0, j = 0 ; j < 20 ; ++j) list[j] = (x += 1 + rnd(&s) % 100000) ;
+      oneWriteLine (vf, 'H', 20, list) ;
+      for (j = 0 ; j < 20 ; ++j) list[j] = rnd(&s) % 10000 ;
+      oneWriteLine (vf, 'O', 20, list) ;
+      for (j = 0 ; j < 20 ; ++j) list[j] = rnd(&s) % 1000000 ;
+      oneWriteLine (vf, 'P', 20, list) ;
+      break ;
+    }
+}
+
+/****************** benchmark phases ******************/
+
+typedef struct {
+  OneFile   *vf ;
+  Bench     *b ;
+  I64        i0, iN ;
+  I64        objects ;
+} Job ;
+
+static void *writeJob (void *arg)
+{ Job *job = (Job *) arg ;
+  I64  i ;
+  for (i = job->i0 ; i < job->iN ; ++i)
+    writeObject (job->vf, job->b->bt, i) ;
+  job->objects = job->iN - job->i0 ;
+  return 0 ;
+}
+
+static void *readJob (void *arg)	// reads objects [i0,iN), decoding every list
+{ Job     *job = (Job *) arg ;
+  OneFile *vf = job->vf ;
+
+  if (vf->share < 0 && !oneGotoObject (vf, job->i0))
+    die ("failed to go to object %lld", job->i0) ;
+  while (oneReadLine (vf))
+    { if (vf->lineType == vf->objectType && vf->object > job->iN) break ;
+      if (vf->info[(int)vf->lineType]->listEltSize) oneList (vf) ;
+    }
+  job->objects = vf->object - job->i0 - (vf->lineType ? 1 : 0) ;
+  return 0 ;
+}
+
+static void runJobs (OneFile *vf, Bench *b, I64 nObj, void *(*fn)(void*))
+{ int        i, n = b->nthreads ;
+  Job       *job = new0 (n, Job) ;
+  pthread_t *threads = new (n, pthread_t) ;
+
+  for (i = 0 ; i < n ; ++i)
+    { job[i].vf = vf + i ; job[i].b = b ;
+      job[i].i0 = (nObj * i) / n ; job[i].iN = (nObj * (i+1)) / n ;
+    }
+  for (i = 1 ; i < n ; ++i) pthread_create (&threads[i], 0, fn, &job[i]) ;
+  fn (&job[0]) ;
+  for (i = 1 ; i < n ; ++i) pthread_join (threads[i], 0) ;
+  for (i = 0 ; i < n ; ++i) b->objects += job[i].objects ;
+
+  free (threads) ; free (job) ;
+}
+
+static I64 fileSize (char *path)
+{ struct stat st ;
+  if (stat (path, &st)) die ("failed to stat %s", path) ;
+  return st.st_size ;
+}
+
+static void benchWrite (Bench *b)
+{ bool     isBinary = (*b->format == 'b') ;
+  OneFile *vf = oneFileOpenWriteNew (b->path, schema, b->bt->fileType, isBinary, b->nthreads) ;
+  int      i ;
+
+  if (!vf) die ("failed to open %s to write", b->path) ;
+  if (!strcmp (b->format, "binary-nocodec"))
+    for (i = 0 ; i < b->nthreads ; ++i) vf[i].codecTrainingSize = I64MAX ;
+  oneAddProvenance (vf, "ONEbench", "0.1", "ONEbench", 0) ;
+  oneWriteHeader (vf) ;
+  runJobs (vf, b, b->nObj, writeJob) ;
+  oneFileClose (vf) ;
+  b->bytes = fileSize (b->path) ;
+}
+
+static void benchRead (Bench *b)
+{ OneFile *vf = oneFileOpenRead (b->path, schema, 0, b->nthreads) ;
+  if (!vf) die ("failed to open %s to read", b->path) ;
+  runJobs (vf, b, vf->isBinary ? vf->info[(int)vf->objectType]->given.count : I64MAX, readJob) ;
+  oneFileClose (vf) ;
+  b->bytes = fileSize (b->path) ;
+}
+
+static void benchGoto (Bench *b)
+{ OneFile *vf = oneFileOpenRead (b->path, schema, 0, 1) ;
+  I64      i, n, start, end ;
+  U64      s = 1 ;
+
+  if (!vf) die ("failed to open %s to read", b->path) ;
+  n = vf->info[(int)vf->objectType]->given.count ;
+  for (i = 0 ; i < b->nGoto ; ++i)
+    { if (!oneGotoObject (vf, rnd(&s) % n)) die ("goto failed") ;
+      start = end = ftello (vf->f) ;
+      oneReadLine (vf) ;
+      do			// read the whole object, up to the next object line
+	{ if (vf->info[(int)vf->lineType]->listEltSize) oneList (vf) ;
+	  end = ftello (vf->f) ;
+	} while (oneReadLine (vf) && vf->lineType != vf->objectType) ;
+      b->bytes += end - start ;
+    }
+  oneFileClose (vf) ;
+  b->objects = b->nGoto ;
+}
+
+static void run (Bench *b, void (*phase)(Bench*))
+{ pid_t pid ;
+  int   status ;
+
+  fflush (stdout) ;
+  if ((pid = fork ()) < 0) die ("fork failed") ;
+  if (!pid)
+    { struct timespec t0, t1 ;
+      struct rusage   ru ;
+      double          secs ;
+      clock_gettime (CLOCK_MONOTONIC, &t0) ;
+      (*phase) (b) ;
+      clock_gettime (CLOCK_MONOTONIC, &t1) ;
+      secs = (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec) ;
+      getrusage (RUSAGE_SELF, &ru) ;
+      printf ("%s\t%s\t%s\t%d\t%lld\t%lld\t%.4f\t%.2f\t%.0f\t%ld\n",
+	      b->bt->name, b->format, b->op, b->nthreads, (long long) b->bytes,
+	      (long long) b->objects, secs, b->bytes / (1e6 * secs), b->objects / secs,
+	      ru.ru_maxrss) ;
+      fflush (stdout) ;
+      _exit (0) ;
+    }
+  if (waitpid (pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+    die ("benchmark %s %s %s with %d threads failed", b->bt->name, b->format, b->op, b->nthreads) ;
+}
+
+/****************** main ******************/
+
+int main (int argc, char **argv)
+{
+  I64    megabytes = 64, nGoto = 100000 ;
+  int    maxThreads = 4, threadList[32], nThreadList = 0, nthreads, f ;
+  char  *dir = "." ;
+  bool   isKeep = false ;
+  char  *formats[] = { "ascii", "binary", "binary-nocodec" } ;
+  BenchType *bt ;
+
+  --argc ; ++argv ;		/* drop the program name */
+  while (argc && **argv == '-')
+    if (!strcmp (*argv, "-s") && argc > 1)
+      { megabytes = atoll (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-T") && argc > 1)
+      { maxThreads = atoi (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-n") && argc > 1)
+      { nGoto = atoll (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-d") && argc > 1)
+      { dir = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-k"))
+      { isKeep = true ; --argc ; ++argv ; }
+    else
+      { fprintf (stderr, "ONEbench [options] [seq|irp|aln|rmp|hit]*\n") ;
+	fprintf (stderr, "  -s <MB>     approximate ascii size of each test file [64]\n") ;
+	fprintf (stderr, "  -T <n>      maximum number of threads, run for 1,2,4..,n [4]\n") ;
+	fprintf (stderr, "  -n <n>      number of random oneGotoObject() accesses [100000]\n") ;
+	fprintf (stderr, "  -d <dir>    directory for test files [.]\n") ;
+	fprintf (stderr, "  -k          keep the test files\n") ;
+	fprintf (stderr, "default is all file types; output columns are described by the header line\n") ;
+	exit (1) ;
+      }
+  if (megabytes < 1 || maxThreads < 1 || nGoto < 0)
+    die ("size, threads and accesses must be positive") ;
+
+  for (nthreads = 1 ; nthreads < maxThreads && nThreadList < 31 ; nthreads *= 2)
+    threadList[nThreadList++] = nthreads ;
+  threadList[nThreadList++] = maxThreads ;
+
+  schema = oneSchemaCreateFromText (vgpSchemaText) ;
+  makePools () ;
+
+  printf ("#type\tformat\top\tthreads\tbytes\tobjects\tseconds\tMB/s\tobjects/s\tmaxRSS_KB\n") ;
+  for (bt = benchTypes ; bt->name ; ++bt)
+    { int i ;
+      for (i = 0 ; i < argc ; ++i) if (!strcmp (argv[i], bt->name)) break ;
+      if (argc && i == argc) continue ;
+
+      for (f = 0 ; f < 3 ; ++f)
+	{ Bench b ;
+	  char    path[1024] ;
+
+	  snprintf (path, 1024, "%s/ONEbench.%s.%s", dir, formats[f], bt->name) ;
+	  memset (&b, 0, sizeof(Bench)) ;
+	  b.bt = bt ; b.format = formats[f] ; b.path = path ;
+	  b.nObj = (megabytes * 1000000) / bt->objBytes ;
+	  b.nGoto = nGoto ;
+
+	  b.op = "write" ;	// written last with 1 thread, so all reads are of the same file
+	  for (i = nThreadList ; i-- ; )
+	    { b.nthreads = threadList[i] ; run (&b, benchWrite) ; }
+
+	  b.op = "read" ;	// ascii files can not be split for reading by object
+	  for (i = 0 ; i < (f ? nThreadList : 1) ; ++i)
+	    { b.nthreads = threadList[i] ; run (&b, benchRead) ; }
+
+	  if (f && nGoto)
+	    { b.op = "goto" ; b.nthreads = 1 ; run (&b, benchGoto) ; }
+
+	  if (!isKeep) unlink (path) ;
+	}
+    }
+
+  oneSchemaDestroy (schema) ;
+  exit (0) ;
+}
+
+/********************* end of file ***********************/
@@ -0,0 +1,149 @@
+/*  File: ONEcat.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: concatenate binary ONE files of the same type
+ *   the data sections are copied byte for byte where the codecs allow, see oneFileCat()
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+#include <sys/stat.h>		/* for stat() */
+
+static void addNewReferences (OneFile *vfOut, OneFile *vfIn)
+{
+  I64 i, j ;
+
+  for (i = 0 ; i < vfIn->info['<']->accum.count ; ++i)
+    { for (j = 0 ; j < vfOut->info['<']->accum.count ; ++j)
+	if (!strcmp (vfIn->reference[i].filename, vfOut->reference[j].filename)) break ;
+      if (j == vfOut->info['<']->accum.count)
+	oneAddReference (vfOut, vfIn->reference[i].filename, vfIn->reference[i].count) ;
+    }
+  for (i = 0 ; i < vfIn->info['>']->accum.count ; ++i)
+    { for (j = 0 ; j < vfOut->info['>']->accum.count ; ++j)
+	if (!strcmp (vfIn->deferred[i].filename, vfOut->deferred[j].filename)) break ;
+      if (j == vfOut->info['>']->accum.count)
+	oneAddDeferred (vfOut, vfIn->deferred[i].filename) ;
+    }
+}
+
+int main (int argc, char **argv)
+{
+  int i ;
+  char *outFileName = 0, *appendFileName = 0 ;
+  bool isVerbose = false ;
+
+  timeUpdate (0) ;
+
+  char *command = commandLine (argc, argv) ;
+  --argc ; ++argv ;		/* drop the program name */
+
+  if (!argc)
+    { fprintf (stderr, "ONEcat [options] onefile1 onefile2 ...\n") ;
+      fprintf (stderr, "  -o --output <filename>    output file name - required unless -a\n") ;
+      fprintf (stderr, "  -a --append <filename>    append to this existing binary file instead, keeping its header\n") ;
+      fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
+      fprintf (stderr, "inputs must be binary ONE files of the same type; output is binary\n") ;
+      fprintf (stderr, "data are copied directly when the list codecs allow, else re-encoded\n") ;
+      exit (0) ;
+    }
+
+  while (argc && **argv == '-')
+    if (argc > 1 && (!strcmp (*argv, "-o") || !strcmp (*argv, "--output")))
+      { outFileName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-a") || !strcmp (*argv, "--append")))
+      { appendFileName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
+      { isVerbose = true ; --argc ; ++argv ; }
+    else die ("unknown option %s - run without arguments to see options", *argv) ;
+
+  if (appendFileName && outFileName)
+    die ("can't both append with -a and write a new file with -o") ;
+  if (!appendFileName && (!outFileName || !strcmp (outFileName, "-")))
+    die ("need to give a named output file with -o") ;
+  if (argc < 1)
+    die ("need to give at least one input file") ;
+
+  { char *target = appendFileName ? appendFileName : outFileName ;
+    struct stat st, sti ;	// writing the target would destroy an input that is the same file
+    if (!stat (target, &st))
+      for (i = 0 ; i < argc ; ++i)
+	if (!stat (argv[i], &sti) && sti.st_dev == st.st_dev && sti.st_ino == st.st_ino)
+	  die ("input %s is the same file as the %s file %s", argv[i],
+	       appendFileName ? "append" : "output", target) ;
+  }
+
+  OneFile **vfIn = new (argc, OneFile*) ;
+  for (i = 0 ; i < argc ; ++i)
+    { vfIn[i] = oneFileOpenRead (argv[i], 0, 0, 1) ;
+      if (!vfIn[i]) die ("failed to open ONE file %s", argv[i]) ;
+      if (!vfIn[i]->isBinary) die ("%s is not a binary ONE file - convert with ONEview -b", argv[i]) ;
+      if (strcmp (vfIn[i]->fileType, vfIn[0]->fileType))
+	die ("file type %s of %s differs from %s of %s",
+	     vfIn[i]->fileType, argv[i], vfIn[0]->fileType, argv[0]) ;
+    }
+
+  OneFile *vfOut ;
+  if (appendFileName) // check the target before opening it to append, which cuts its footer
+    { OneFile *vf = oneFileOpenRead (appendFileName, 0, 0, 1) ;
+      if (!vf) die ("failed to open ONE file %s", appendFileName) ;
+      if (!vf->isBinary) die ("can only append to a binary file, not %s", appendFileName) ;
+      if (strcmp (vf->fileType, vfIn[0]->fileType))
+	die ("file type %s of %s differs from %s of %s",
+	     vf->fileType, appendFileName, vfIn[0]->fileType, argv[0]) ;
+      if (vf->sortType)
+	die ("%s is declared sorted - merge into it with ONEmerge instead", appendFileName) ;
+      oneFileClose (vf) ;
+      if (!(vfOut = oneFileOpenAppend (appendFileName, 1)))
+	die ("failed to open %s to append to it", appendFileName) ;
+      for (i = 0 ; i < argc ; ++i) // the header is kept, so this provenance goes in the footer
+	oneInheritNewProvenance (vfOut, vfIn[i]) ;
+      oneAddProvenance (vfOut, "ONEcat", "0.0", command, 0) ;
+      for (i = 0 ; i < argc ; ++i)
+	oneInheritCodecs (vfOut, vfIn[i]) ;
+    }
+  else
+    { vfOut = oneFileOpenWriteFrom (outFileName, vfIn[0], true, 1) ;
+      if (!vfOut) die ("failed to open output file %s", outFileName) ;
+
+      for (i = 1 ; i < argc ; ++i)
+	{ oneInheritNewProvenance (vfOut, vfIn[i]) ;
+	  addNewReferences (vfOut, vfIn[i]) ;
+	}
+      oneAddProvenance (vfOut, "ONEcat", "0.0", command, 0) ;
+      for (i = 0 ; i < argc ; ++i)
+	oneInheritCodecs (vfOut, vfIn[i]) ;
+      oneWriteHeader (vfOut) ;
+    }
+
+  for (i = 0 ; i < argc ; ++i)
+    { bool isRaw = oneFileCat (vfOut, vfIn[i]) ;
+      if (isVerbose)
+	fprintf (stderr, "%s: %" PRId64 " objects %s\n", argv[i],
+		 vfIn[i]->info[(int) vfIn[i]->objectType]->given.count,
+		 isRaw ? "copied" : "re-encoded") ;
+      oneFileClose (vfIn[i]) ;
+    }
+  oneFileClose (vfOut) ;
+
+  free (vfIn) ;
+  free (command) ;
+
+  if (isVerbose)
+    timeTotal (stderr) ;
+
+  exit (0) ;
+}
+
+/******************* end of file **************/
@@ -0,0 +1,397 @@
+/*  File: ONEexpr.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: filter expression parser and evaluator for ONE files
+ *   recursive descent parser modelled on Gene Myers' VGP/pb_expr.c
+ * Exported functions: see ONEexpr.h
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEexpr.h"
+
+#include <ctype.h>
+#include <string.h>
+
+enum { OP_OR, OP_AND, OP_NOT, OP_LT, OP_LE, OP_GT, OP_GE, OP_NE, OP_EQ, OP_NUM, OP_SLOT } ;
+
+typedef struct NodeStruct {
+  int                op ;
+  struct NodeStruct *lft, *rgt ;
+  bool               isReal ;	// for OP_NUM and OP_SLOT: the value is REAL, else INT
+  int                slot ;	// for OP_SLOT
+  OneField           x ;	// for OP_NUM
+} Node ;
+
+typedef struct {
+  char t ;			// line type
+  int  k ;			// field number, or -1 for the list length
+} Slot ;
+
+#define MAX_SLOT 64
+
+struct OneExprStruct {
+  Node *root ;
+  int   nSlot ;
+  Slot  slot[MAX_SLOT] ;
+  bool  isUsed[128] ;		// line types referenced
+} ;
+
+struct OneExprValStruct {
+  OneExpr *ex ;
+  bool     isSeen[128] ;	// a line of this type has been recorded for this object
+  OneField val[MAX_SLOT] ;
+} ;
+
+/***************** parser ******************/
+
+static char *Error_Messages[] =
+  { "Unrecognized token",
+    "Expecting closing paren",
+    "Expecting comparison operator",
+    "Unknown line type",
+    "Field number out of range",
+    "Field is a list or string - use .len",
+    "Line type has no list - .len not available",
+    "Too many field references",
+    "Unterminated character constant"
+  } ;
+
+static char    *Scan ;
+static int      Error ;
+static OneFile *Vf ;
+static OneExpr *Ex ;
+
+#define ERROR(msg) { Error = msg ; return NULL ; }
+
+static void skipSpace (void) { while (isspace(*Scan)) ++Scan ; }
+
+static Node *node (int op, Node *lft, Node *rgt)
+{ Node *v = new0 (1, Node) ;
+  v->op = op ; v->lft = lft ; v->rgt = rgt ;
+  return v ;
+}
+
+static void nodeDestroy (Node *v)
+{ if (!v) return ;
+  nodeDestroy (v->lft) ;
+  nodeDestroy (v->rgt) ;
+  free (v) ;
+}
+
+static Node *terminal (void)
+{ Node *v ;
+
+  skipSpace () ;
+  if (isalpha(*Scan) && Scan[1] == '.')	// a field reference X.k or X.len
+    { char     t = *Scan ;
+      OneInfo *li = Vf->info[(int)t] ;
+      int      k, i ;
+
+      if (!li) ERROR(3) ;
+      Scan += 2 ;
+      if (!strncmp (Scan, "len", 3) && !isalnum(Scan[3]))
+	{ if (!li->listEltSize) ERROR(6) ;
+	  k = -1 ; Scan += 3 ;
+	}
+      else if (isdigit(*Scan))
+	{ k = strtol (Scan, &Scan, 10) ;
+	  if (k >= li->nField) ERROR(4) ;
+	  if (li->fieldType[k] != oneINT && li->fieldType[k] != oneREAL
+	      && li->fieldType[k] != oneCHAR)
+	    ERROR(5) ;
+	}
+      else
+	ERROR(0) ;
+
+      for (i = 0 ; i < Ex->nSlot ; ++i)
+	if (Ex->slot[i].t == t && Ex->slot[i].k == k) break ;
+      if (i == Ex->nSlot)
+	{ if (i == MAX_SLOT) ERROR(7) ;
+	  Ex->slot[i].t = t ; Ex->slot[i].k = k ;
+	  ++Ex->nSlot ;
+	}
+      Ex->isUsed[(int)t] = true ;
+      v = node (OP_SLOT, 0, 0) ;
+      v->slot = i ;
+      v->isReal = (k >= 0 && li->fieldType[k] == oneREAL) ;
+    }
+  else if (*Scan == '\'')		// a character constant
+    { if (!Scan[1] || Scan[2] != '\'') ERROR(8) ;
+      v = node (OP_NUM, 0, 0) ;
+      v->x.i = (unsigned char) Scan[1] ;
+      Scan += 3 ;
+    }
+  else if (isdigit(*Scan) || *Scan == '-' || *Scan == '+' || *Scan == '.')
+    { char *s = Scan ;
+      I64   i = strtoll (Scan, &s, 10) ;
+      v = node (OP_NUM, 0, 0) ;
+      if (*s == '.' || *s == 'e' || *s == 'E')
+	{ v->isReal = true ;
+	  v->x.r = strtod (Scan, &s) ;
+	}
+      else
+	v->x.i = i ;
+      if (s == Scan) { free (v) ; ERROR(0) ; }
+      Scan = s ;
+    }
+  else
+    ERROR(0) ;
+
+  return v ;
+}
+
+static Node *or (void) ;
+
+static Node *pred (void)
+{ Node *v, *w ;
+  int   op ;
+
+  skipSpace () ;
+  if (*Scan == '(')
+    { ++Scan ;
+      if (!(v = or ())) return NULL ;
+      skipSpace () ;
+      if (*Scan != ')') { nodeDestroy (v) ; ERROR(1) ; }
+      ++Scan ;
+      return v ;
+    }
+  if (*Scan == '!' && Scan[1] != '=')
+    { ++Scan ;
+      if (!(v = pred ())) return NULL ;
+      return node (OP_NOT, v, 0) ;
+    }
+
+  if (!(v = terminal ())) return NULL ;
+  skipSpace () ;
+  if (*Scan == '<')
+    { if (Scan[1] == '=') { Scan += 2 ; op = OP_LE ; } else { Scan += 1 ; op = OP_LT ; } }
+  else if (*Scan == '>')
+    { if (Scan[1] == '=') { Scan += 2 ; op = OP_GE ; } else { Scan += 1 ; op = OP_GT ; } }
+  else if (*Scan == '!' && Scan[1] == '=')
+    { Scan += 2 ; op = OP_NE ; }
+  else if (*Scan == '=' && Scan[1] == '=')
+    { Scan += 2 ; op = OP_EQ ; }
+  else
+    { nodeDestroy (v) ; ERROR(2) ; }
+
+  if (!(w = terminal ())) { nodeDestroy (v) ; return NULL ; }
+  return node (op, v, w) ;
+}
+
+static Node *and (void)
+{ Node *v, *w ;
+
+  if (!(v = pred ())) return NULL ;
+  while (true)
+    { skipSpace () ;
+      if (*Scan != '&') return v ;
+      if (Scan[1] != '&') { nodeDestroy (v) ; ERROR(0) ; }
+      Scan += 2 ;
+      if (!(w = pred ())) { nodeDestroy (v) ; return NULL ; }
+      v = node (OP_AND, v, w) ;
+    }
+}
+
+static Node *or (void)
+{ Node *v, *w ;
+
+  if (!(v = and ())) return NULL ;
+  while (true)
+    { skipSpace () ;
+      if (*Scan != '|') return v ;
+      if (Scan[1] != '|') { nodeDestroy (v) ; ERROR(0) ; }
+      Scan += 2 ;
+      if (!(w = and ())) { nodeDestroy (v) ; return NULL ; }
+      v = node (OP_OR, v, w) ;
+    }
+}
+
+OneExpr *oneExprCreate (OneFile *vf, char *text)
+{
+  Ex = new0 (1, OneExpr) ;
+  Vf = vf ;
+  Scan = text ;
+  Ex->root = or () ;
+  if (Ex->root)
+    { skipSpace () ;
+      if (*Scan) { nodeDestroy (Ex->root) ; Ex->root = 0 ; Error = 0 ; }
+    }
+  if (!Ex->root)
+    { fprintf (stderr, "filter expression syntax error:\n\n") ;
+      fprintf (stderr, "    %s\n", text) ;
+      fprintf (stderr, "%*s^ %s\n", (int) ((Scan-text)+4), "", Error_Messages[Error]) ;
+      free (Ex) ;
+      return NULL ;
+    }
+  return Ex ;
+}
+
+void oneExprDestroy (OneExpr *ex)
+{ nodeDestroy (ex->root) ;
+  free (ex) ;
+}
+
+/***************** evaluation ******************/
+
+OneExprVal *oneExprValCreate (OneExpr *ex)
+{ OneExprVal *ev = new0 (1, OneExprVal) ;
+  ev->ex = ex ;
+  return ev ;
+}
+
+void oneExprValDestroy (OneExprVal *ev) { free (ev) ; }
+
+void oneExprClear (OneExprVal *ev)
+{ int i ;
+  for (i = 0 ; i < ev->ex->nSlot ; ++i)
+    ev->isSeen[(int)ev->ex->slot[i].t] = false ;
+}
+
+void oneExprRecord (OneExprVal *ev, OneFile *vf)
+{ OneExpr *ex = ev->ex ;
+  char     t = vf->lineType ;
+  int      i ;
+
+  if (!ex->isUsed[(int)t] || ev->isSeen[(int)t]) return ;
+  for (i = 0 ; i < ex->nSlot ; ++i)
+    if (ex->slot[i].t == t)
+      { if (ex->slot[i].k < 0)
+	  ev->val[i].i = oneLen(vf) ;
+	else if (vf->info[(int)t]->fieldType[ex->slot[i].k] == oneCHAR)
+	  ev->val[i].i = (unsigned char) oneChar(vf,ex->slot[i].k) ;
+	else
+	  ev->val[i] = vf->field[ex->slot[i].k] ;
+      }
+  ev->isSeen[(int)t] = true ;
+}
+
+static inline bool value (Node *v, OneExprVal *ev, OneField *x)
+{ if (v->op == OP_NUM)
+    *x = v->x ;
+  else if (ev->isSeen[(int)ev->ex->slot[v->slot].t])
+    *x = ev->val[v->slot] ;
+  else
+    return false ;
+  return true ;
+}
+
+static bool eval (Node *v, OneExprVal *ev)
+{ OneField a, b ;
+  double   d ;
+
+  switch (v->op)
+    {
+    case OP_OR:  return eval (v->lft, ev) || eval (v->rgt, ev) ;
+    case OP_AND: return eval (v->lft, ev) && eval (v->rgt, ev) ;
+    case OP_NOT: return !eval (v->lft, ev) ;
+    }
+
+  if (!value (v->lft, ev, &a) || !value (v->rgt, ev, &b))
+    return false ;
+  if (v->lft->isReal || v->rgt->isReal) // compare as doubles
+    d = (v->lft->isReal ? a.r : (double) a.i) - (v->rgt->isReal ? b.r : (double) b.i) ;
+  else
+    d = (a.i < b.i) ? -1 : (a.i > b.i) ? 1 : 0 ;
+
+  switch (v->op)
+    {
+    case OP_LT: return d < 0 ;
+    case OP_LE: return d <= 0 ;
+    case OP_GT: return d > 0 ;
+    case OP_GE: return d >= 0 ;
+    case OP_NE: return d != 0 ;
+    case OP_EQ: return d == 0 ;
+    }
+  return false ;
+}
+
+bool oneExprEval (OneExprVal *ev) { return eval (ev->ex->root, ev) ; }
+
+/***************** sort keys ******************/
+
+struct OneKeyStruct {
+  OneExpr     ex ;		// only the slots are used
+  bool        isDescending[MAX_SLOT] ;
+  bool        isReal[MAX_SLOT] ;
+  OneExprVal *ev ;
+} ;
+
+OneKey *oneKeyCreate (OneFile *vf, char *text)
+{ OneKey *key = new0 (1, OneKey) ;
+  bool    isDown ;
+  Node   *v ;
+
+  Ex = &key->ex ;
+  Vf = vf ;
+  Scan = text ;
+  Error = 0 ;
+  while (true)
+    { skipSpace () ;
+      isDown = (*Scan == '-') ;
+      if (isDown) ++Scan ;
+      if (!(v = terminal ()))
+	break ;
+      if (v->op != OP_SLOT || v->slot < Ex->nSlot-1) // a number, or a repeated term
+	{ nodeDestroy (v) ; Error = 0 ; break ; }
+      key->isDescending[v->slot] = isDown ;
+      key->isReal[v->slot] = v->isReal ;
+      nodeDestroy (v) ;
+      skipSpace () ;
+      if (*Scan == ',')
+	++Scan ;
+      else if (!*Scan)
+	{ key->ev = oneExprValCreate (Ex) ;
+	  return key ;
+	}
+      else
+	break ;
+    }
+
+  fprintf (stderr, "sort key syntax error:\n\n") ;
+  fprintf (stderr, "    %s\n", text) ;
+  fprintf (stderr, "%*s^ %s\n", (int) ((Scan-text)+4), "", Error_Messages[Error]) ;
+  free (key) ;
+  return NULL ;
+}
+
+void oneKeyDestroy (OneKey *key) { oneExprValDestroy (key->ev) ; free (key) ; }
+
+int oneKeySize (OneKey *key) { return 8 * key->ex.nSlot ; }
+
+void oneKeyClear (OneKey *key) { oneExprClear (key->ev) ; }
+
+void oneKeyRecord (OneKey *key, OneFile *vf) { oneExprRecord (key->ev, vf) ; }
+
+bool oneKeyFirstTerm (OneKey *key, char *lineType, int *field)
+{ *lineType = key->ex.slot[0].t ;
+  *field    = key->ex.slot[0].k ;
+  return !key->isDescending[0] && !key->isReal[0] ;
+}
+
+void oneKeyBytes (OneKey *key, unsigned char *bytes)
+{ OneExprVal *ev = key->ev ;
+  int         i, j ;
+  U64         u ;
+
+  for (i = 0 ; i < key->ex.nSlot ; ++i, bytes += 8)
+    { Slot *s = &key->ex.slot[i] ;
+      if (!ev->isSeen[(int)s->t])
+	{ memset (bytes, 0, 8) ;
+	  continue ;
+	}
+      u = (U64) ev->val[i].i ;
+      if (key->isReal[i])
+	u = (u >> 63) ? ~u : u ^ ((U64) 1 << 63) ; // IEEE order to unsigned order
+      else
+	u ^= (U64) 1 << 63 ;                         // two's complement to unsigned order
+      if (key->isDescending[i])
+	u = ~u ;
+      for (j = 7 ; j >= 0 ; --j, u >>= 8)          // most significant byte first
+	bytes[j] = u & 0xff ;
+    }
+}
+
+/******************* end of file **************/
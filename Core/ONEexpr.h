@@ -0,0 +1,73 @@
+/*  File: ONEexpr.h
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: filter expressions and sort keys on the field values of objects of a ONE file
+ *
+ * Expressions follow VGP/pb_expr.c, with comparisons combined by &&, || and !, and
+ * parentheses.  A comparison takes two terms which may be numbers, 'c' character
+ * constants, or references to the first line of a given type in the object:
+ *    X.k    field k (numbering from 0) of the X line, for INT, REAL and CHAR fields
+ *    X.len  the length of the list (or string) in the X line
+ * e.g. "S.len >= 10000 && W.3 > 0.8" for seq files or "D.0 < 500" for aln files.
+ * A comparison involving a line type that is absent from the object is false.
+ *
+ * Values are taken from the fields as read, so list data never needs to be decoded.
+ *
+ * Exported functions: see below
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#ifndef ONE_EXPR_DEFINED
+#define ONE_EXPR_DEFINED
+
+#include "ONElib.h"
+
+typedef struct OneExprStruct    OneExpr ;	// compiled expression, shareable between threads
+typedef struct OneExprValStruct OneExprVal ;	// the values for one object, one per thread
+
+OneExpr *oneExprCreate (OneFile *vf, char *text) ;
+
+  // Compile text against the schema of vf.  On a syntax or schema error writes a message
+  //   showing the position of the error to stderr and returns NULL.  Not re-entrant.
+
+void oneExprDestroy (OneExpr *ex) ;
+
+OneExprVal *oneExprValCreate  (OneExpr *ex) ;
+void        oneExprValDestroy (OneExprVal *ev) ;
+
+void oneExprClear  (OneExprVal *ev) ;
+void oneExprRecord (OneExprVal *ev, OneFile *vf) ;
+bool oneExprEval   (OneExprVal *ev) ;
+
+  // Call oneExprClear() before the object line is read, oneExprRecord() after reading each
+  //   line of the object, and then oneExprEval() to find if the object passes the filter.
+
+  // Sort keys are comma separated lists of terms X.k or X.len as above, each optionally
+  //   preceded by '-' for descending order, e.g. "A.0,I.0" or "-S.len".  The key of an object
+  //   is written as bytes that compare with memcmp() in the order of the key, 8 per term.  A
+  //   term whose line type is absent from the object sorts first.
+
+typedef struct OneKeyStruct OneKey ;	// not shareable between threads
+
+OneKey *oneKeyCreate  (OneFile *vf, char *text) ;   // NULL and message to stderr on error
+void    oneKeyDestroy (OneKey *key) ;
+int     oneKeySize    (OneKey *key) ;		    // number of bytes in a key
+
+void oneKeyClear  (OneKey *key) ;
+void oneKeyRecord (OneKey *key, OneFile *vf) ;
+void oneKeyBytes  (OneKey *key, unsigned char *bytes) ;
+
+  // Use oneKeyClear() and oneKeyRecord() as for expressions, then oneKeyBytes() to write
+  //   oneKeySize() bytes of the key of the object into bytes.
+
+bool oneKeyFirstTerm (OneKey *key, char *lineType, int *field) ;
+
+  // Sets the line type and field (-1 for len) of the first term of the key, and returns true
+  //   if it is ascending and not REAL, so that a file sorted on the key can be declared
+  //   sorted on it with oneSetSorted().
+
+#endif // ONE_EXPR_DEFINED
+
+/******************* end of file **************/
@@ -0,0 +1,119 @@
+/*  File: ONEindex.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: build and query a binned interval index of a binary ONE file
+ *   by default over the a sequence intervals of the alignments of an aln file
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+#include "ONEinterval.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+
+static void printObjects (I64 n, I64 *obj) // as a list of ranges a-b, excluding b, for ONEview -i
+{ I64 i, j ;
+
+  for (i = 0 ; i < n ; i = j)
+    { j = i+1 ;
+      while (j < n && obj[j] == obj[j-1]+1) ++j ;
+      if (i) putchar (',') ;
+      if (j == i+1)
+	printf ("%" PRId64 "", obj[i]) ;
+      else
+	printf ("%" PRId64 "-%" PRId64 "", obj[i], obj[j-1]+1) ;
+    }
+  putchar ('\n') ;
+}
+
+int main (int argc, char **argv)
+{
+  char *key = 0, *indexName = 0, *query = 0 ;
+  bool  isVerbose = false ;
+
+  timeUpdate (0) ;
+
+  --argc ; ++argv ;		/* drop the program name */
+
+  if (!argc)
+    { fprintf (stderr, "ONEindex [options] onefile\n") ;
+      fprintf (stderr, "  -k --key <T.k,S.k,E.k>    INT fields for target, start, end (default A.0,I.0,I.1)\n") ;
+      fprintf (stderr, "  -b --bSide                index the b sequence intervals, i.e. -k A.1,I.3,I.4\n") ;
+      fprintf (stderr, "  -o --output <filename>    index file name (default <onefile>.1oix)\n") ;
+      fprintf (stderr, "  -q --query <t:start-end>  read the index and print the objects overlapping the region\n") ;
+      fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
+      fprintf (stderr, "onefile must be binary; the objects found by -q are printed as a list for ONEview -i\n") ;
+      exit (0) ;
+    }
+
+  while (argc && **argv == '-')
+    if (argc > 1 && (!strcmp (*argv, "-k") || !strcmp (*argv, "--key")))
+      { key = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-b") || !strcmp (*argv, "--bSide"))
+      { key = "A.1,I.3,I.4" ; --argc ; ++argv ; }
+    else if (argc > 1 && (!strcmp (*argv, "-o") || !strcmp (*argv, "--output")))
+      { indexName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-q") || !strcmp (*argv, "--query")))
+      { query = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
+      { isVerbose = true ; --argc ; ++argv ; }
+    else die ("unknown option %s - run without arguments to see options", *argv) ;
+
+  if (argc != 1)
+    die ("need to give a single binary ONE file as argument") ;
+
+  OneFile *vf = oneFileOpenRead (argv[0], 0, 0, 1) ;
+  if (!vf) die ("failed to open ONE file %s", argv[0]) ;
+  if (!vf->isBinary) die ("%s is not a binary ONE file - convert with ONEview -b", argv[0]) ;
+
+  if (!indexName)
+    { indexName = new (strlen(argv[0]) + 6, char) ;
+      sprintf (indexName, "%s.1oix", argv[0]) ;
+    }
+
+  OneIntervalIndex *ix ;
+  if (query)
+    { I64 target, start, end, n, *obj ;
+      int k ;
+      if (sscanf (query, "%" SCNd64 ":%" SCNd64 "-%" SCNd64 "%n", &target, &start, &end, &k) != 3
+	  || query[k])
+	die ("query %s is not of the form target:start-end", query) ;
+      if (!(ix = oneIntervalIndexRead (indexName, vf)))
+	die ("failed to read index %s for %s", indexName, argv[0]) ;
+      if (!vf->isIndexIn) die ("%s has no object index", argv[0]) ;
+      n = oneIntervalQuery (ix, vf, target, start, end, &obj) ;
+      printObjects (n, obj) ;
+      if (isVerbose)
+	fprintf (stderr, "found %" PRId64 " objects overlapping %s\n", n, query) ;
+      free (obj) ;
+    }
+  else
+    { if (!(ix = oneIntervalIndexBuild (vf, key)))
+	die ("failed to build index of %s", argv[0]) ;
+      if (!oneIntervalIndexWrite (ix, indexName, argv[0]))
+	die ("failed to write index %s", indexName) ;
+      if (isVerbose)
+	fprintf (stderr, "indexed %s in %s\n", argv[0], indexName) ;
+    }
+
+  oneIntervalIndexDestroy (ix) ;
+  oneFileClose (vf) ;
+
+  if (isVerbose)
+    timeTotal (stderr) ;
+
+  exit (0) ;
+}
+
+/******************* end of file **************/
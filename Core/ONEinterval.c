@@ -0,0 +1,347 @@
+/*  File: ONEinterval.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: binned interval index over the objects of a ONE file
+ *   the binning follows the CSI index of htslib, with 2^14 positions in the finest bins
+ * Exported functions: see ONEinterval.h
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEinterval.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#define MIN_SHIFT 14
+
+static char *schemaText =
+  "P 3 oix INTERVAL INDEX\n"
+  "O T 1 3 INT                 target: object number of the target in its file\n"
+  "D K 3 6 STRING 3 INT 3 INT  key: target,start,end terms, min shift, depth of bins\n"
+  "D B 2 3 INT 8 INT_LIST      bin: number, start,end pairs of the ranges of objects in it\n" ;
+
+struct OneIntervalIndexStruct {
+  char  *key ;
+  char   type[3] ;		// target, start and end line types
+  int    field[3] ;		//   and fields
+  int    minShift, depth ;
+  I64    nObject ;		// in the indexed file
+  I64    nTarget, *target ;	// targets in order
+  I64   *targetBin ;		// bins of target i are targetBin[i]..targetBin[i+1]-1
+  I64    nBin, *bin ;		// bin numbers, in order within each target
+  I64   *binChunk ;		// ranges of bin j are chunk[2*binChunk[j]]..chunk[2*binChunk[j+1]]-1
+  I64    nChunk, *chunk ;	// start,end pairs of object ranges
+} ;
+
+static OneIntervalIndex *indexCreate (OneFile *vf, char *key) // parse the key against vf
+{ OneIntervalIndex *ix = new0 (1, OneIntervalIndex) ;
+  char *s = key ;
+  int   i ;
+
+  for (i = 0 ; i < 3 ; ++i)
+    { OneInfo *li = vf->info[(int)*s] ;
+      if (!isupper(*s) || s[1] != '.' || !isdigit(s[2]) || !li)
+	break ;
+      ix->type[i] = *s ;
+      for (s += 2, ix->field[i] = 0 ; isdigit(*s) ; ++s)
+	ix->field[i] = ix->field[i]*10 + (*s - '0') ;
+      if (ix->field[i] >= li->nField || li->fieldType[ix->field[i]] != oneINT)
+	break ;
+      if (*s != (i < 2 ? ',' : 0))
+	break ;
+      ++s ;
+    }
+  if (i < 3)
+    { fprintf (stderr, "interval key %s needs three INT fields T.k,S.k,E.k for target, start, end\n", key) ;
+      free (ix) ;
+      return NULL ;
+    }
+  ix->key = new (strlen(key)+1, char) ;
+  strcpy (ix->key, key) ;
+  return ix ;
+}
+
+void oneIntervalIndexDestroy (OneIntervalIndex *ix)
+{ free (ix->key) ;
+  free (ix->target) ;
+  free (ix->targetBin) ;
+  free (ix->bin) ;
+  free (ix->binChunk) ;
+  free (ix->chunk) ;
+  free (ix) ;
+}
+
+  // Read the lines of the object whose object line has just been read, up to the next object
+  //   or group line, which is left read.  Returns true if it has all three terms.
+
+static bool objectInterval (OneIntervalIndex *ix, OneFile *vf, I64 *val)
+{ bool isSeen[3] = { false, false, false } ;
+  char t = vf->lineType ;
+  int  i ;
+
+  do
+    for (i = 0 ; i < 3 ; ++i)
+      if (t == ix->type[i] && !isSeen[i])
+	{ val[i] = oneInt(vf, ix->field[i]) ;
+	  isSeen[i] = true ;
+	}
+  while ((t = oneReadLine (vf)) && t != vf->objectType && t != vf->groupType) ;
+
+  if (!isSeen[0] || !isSeen[1] || !isSeen[2])
+    return false ;
+  if (val[1] < 0) val[1] = -val[1] ; // negative positions are on the reverse strand
+  if (val[2] < 0) val[2] = -val[2] ;
+  if (val[1] > val[2]) { I64 x = val[1] ; val[1] = val[2] ; val[2] = x ; }
+  if (val[2] == val[1]) ++val[2] ; // an empty interval is treated as its start position
+  return true ;
+}
+
+static I64 reg2bin (I64 beg, I64 end, int minShift, int depth) // smallest bin holding beg..end-1
+{ int l, s = minShift ;
+  I64 t = (((I64) 1 << depth*3) - 1) / 7 ;
+
+  for (--end, l = depth ; l > 0 ; --l, s += 3, t -= (I64) 1 << l*3)
+    if (beg >> s == end >> s)
+      return t + (beg >> s) ;
+  return 0 ;
+}
+
+typedef struct { I64 target, start, end, object ; } Entry ; // end is then the bin
+
+static int entryOrder (const void *a, const void *b)
+{ const Entry *x = (const Entry *) a, *y = (const Entry *) b ;
+
+  if (x->target != y->target) return x->target < y->target ? -1 : 1 ;
+  if (x->end != y->end)       return x->end < y->end ? -1 : 1 ;
+  return x->object < y->object ? -1 : (x->object > y->object) ;
+}
+
+OneIntervalIndex *oneIntervalIndexBuild (OneFile *vf, char *key)
+{ OneIntervalIndex *ix ;
+  Entry *e ;
+  I64    i, n = 0, nMax = 1024, maxEnd = 1, val[3] ;
+  char   t ;
+
+  if (!(ix = indexCreate (vf, key ? key : "A.0,I.0,I.1")))
+    return NULL ;
+
+  e = new (nMax, Entry) ;
+  while ((t = oneReadLine (vf)) && t != vf->objectType) ;
+  while (t == vf->objectType)
+    { I64 object = vf->object - 1 ;
+      if (objectInterval (ix, vf, val))
+	{ if (n == nMax)
+	    { Entry *e2 = new (nMax *= 2, Entry) ;
+	      memcpy (e2, e, n*sizeof(Entry)) ;
+	      free (e) ;
+	      e = e2 ;
+	    }
+	  e[n].target = val[0] ; e[n].start = val[1] ; e[n].end = val[2] ; e[n].object = object ;
+	  if (val[2] > maxEnd) maxEnd = val[2] ;
+	  ++n ;
+	}
+      for (t = vf->lineType ; t && t != vf->objectType ; t = oneReadLine (vf)) ;
+    }
+  ix->nObject = vf->object ;
+
+  // choose the depth so that the top bin holds every interval, then bin and sort them
+
+  ix->minShift = MIN_SHIFT ;
+  for (ix->depth = 0 ; ((I64) 1 << (ix->minShift + 3*ix->depth)) < maxEnd ; ++ix->depth) ;
+  for (i = 0 ; i < n ; ++i)
+    e[i].end = reg2bin (e[i].start, e[i].end, ix->minShift, ix->depth) ;
+  qsort (e, n, sizeof(Entry), entryOrder) ;
+
+  // runs of consecutive objects in a bin become chunks
+
+  ix->target    = new (n+1, I64) ;
+  ix->targetBin = new (n+2, I64) ;
+  ix->bin       = new (n+1, I64) ;
+  ix->binChunk  = new (n+2, I64) ;
+  ix->chunk     = new (2*n+2, I64) ;
+  for (i = 0 ; i < n ; ++i)
+    { bool isNewTarget = (i == 0 || e[i].target != e[i-1].target) ;
+      bool isNewBin = (isNewTarget || e[i].end != e[i-1].end) ;
+      if (isNewTarget)
+	{ ix->targetBin[ix->nTarget] = ix->nBin ;
+	  ix->target[ix->nTarget++] = e[i].target ;
+	}
+      if (isNewBin)
+	{ ix->binChunk[ix->nBin] = ix->nChunk ;
+	  ix->bin[ix->nBin++] = e[i].end ;
+	}
+      if (!isNewBin && ix->chunk[2*ix->nChunk-1] == e[i].object)
+	++ix->chunk[2*ix->nChunk-1] ;
+      else
+	{ ix->chunk[2*ix->nChunk]   = e[i].object ;
+	  ix->chunk[2*ix->nChunk+1] = e[i].object + 1 ;
+	  ++ix->nChunk ;
+	}
+    }
+  ix->targetBin[ix->nTarget] = ix->nBin ;
+  ix->binChunk[ix->nBin] = ix->nChunk ;
+
+  free (e) ;
+  return ix ;
+}
+
+bool oneIntervalIndexWrite (OneIntervalIndex *ix, char *path, char *indexedPath)
+{ OneSchema *vs = oneSchemaCreateFromText (schemaText) ;
+  OneFile   *vf = oneFileOpenWriteNew (path, vs, "oix", true, 1) ;
+  I64        i, j, max = 0, *buf ;
+
+  oneSchemaDestroy (vs) ;
+  if (!vf)
+    return false ;
+  oneAddReference (vf, indexedPath, ix->nObject) ;
+  oneWriteHeader (vf) ;
+
+  oneInt(vf,1) = ix->minShift ;
+  oneInt(vf,2) = ix->depth ;
+  oneWriteLine (vf, 'K', strlen(ix->key), ix->key) ;
+
+  for (j = 0 ; j < ix->nBin ; ++j)
+    if (ix->binChunk[j+1] - ix->binChunk[j] > max)
+      max = ix->binChunk[j+1] - ix->binChunk[j] ;
+  buf = new (2*max+1, I64) ; // writing compacts an INT_LIST in place, so copy the chunks
+  for (i = 0 ; i < ix->nTarget ; ++i)
+    { oneInt(vf,0) = ix->target[i] ;
+      oneWriteLine (vf, 'T', 0, 0) ;
+      for (j = ix->targetBin[i] ; j < ix->targetBin[i+1] ; ++j)
+	{ I64 n = 2 * (ix->binChunk[j+1] - ix->binChunk[j]) ;
+	  memcpy (buf, &ix->chunk[2*ix->binChunk[j]], n*sizeof(I64)) ;
+	  oneInt(vf,0) = ix->bin[j] ;
+	  oneWriteLine (vf, 'B', n, buf) ;
+	}
+    }
+  free (buf) ;
+
+  oneFileClose (vf) ;
+  return true ;
+}
+
+OneIntervalIndex *oneIntervalIndexRead (char *path, OneFile *vfData)
+{ OneFile          *vf = oneFileOpenRead (path, 0, "oix", 1) ;
+  OneIntervalIndex *ix ;
+  char             *key ;
+  I64               n ;
+
+  if (!vf)
+    return NULL ;
+  if (oneReadLine (vf) != 'K' || vf->info['<']->accum.count != 1)
+    { fprintf (stderr, "%s is not an interval index\n", path) ;
+      oneFileClose (vf) ;
+      return NULL ;
+    }
+  if (vfData && vfData->info[(int) vfData->objectType]->given.count != vf->reference[0].count)
+    { fprintf (stderr, "index %s is for %" PRId64 " objects in %s, not %" PRId64 "\n", path,
+	       vf->reference[0].count, vf->reference[0].filename,
+	       vfData->info[(int) vfData->objectType]->given.count) ;
+      oneFileClose (vf) ;
+      return NULL ;
+    }
+
+  key = new0 (oneLen(vf)+1, char) ;
+  memcpy (key, oneString(vf), oneLen(vf)) ;
+  ix = vfData ? indexCreate (vfData, key) : new0 (1, OneIntervalIndex) ;
+  if (!ix)
+    { free (key) ;
+      oneFileClose (vf) ;
+      return NULL ;
+    }
+  if (!vfData) ix->key = key ; else free (key) ;
+  ix->minShift = oneInt(vf,1) ;
+  ix->depth    = oneInt(vf,2) ;
+  ix->nObject  = vf->reference[0].count ;
+
+  n = vf->info['T']->given.count ;
+  ix->target    = new (n+1, I64) ;
+  ix->targetBin = new (n+2, I64) ;
+  n = vf->info['B']->given.count ;
+  ix->bin       = new (n+1, I64) ;
+  ix->binChunk  = new (n+2, I64) ;
+  n = vf->info['B']->given.total ;
+  ix->chunk     = new (n+2, I64) ;
+  while (oneReadLine (vf))
+    if (vf->lineType == 'T')
+      { ix->targetBin[ix->nTarget] = ix->nBin ;
+	ix->target[ix->nTarget++] = oneInt(vf,0) ;
+      }
+    else if (vf->lineType == 'B')
+      { ix->binChunk[ix->nBin] = ix->nChunk ;
+	ix->bin[ix->nBin++] = oneInt(vf,0) ;
+	memcpy (&ix->chunk[2*ix->nChunk], oneIntList(vf), oneLen(vf)*sizeof(I64)) ;
+	ix->nChunk += oneLen(vf) / 2 ;
+      }
+  ix->targetBin[ix->nTarget] = ix->nBin ;
+  ix->binChunk[ix->nBin] = ix->nChunk ;
+
+  oneFileClose (vf) ;
+  return ix ;
+}
+
+static int chunkOrder (const void *a, const void *b)
+{ I64 x = *(const I64 *) a, y = *(const I64 *) b ;
+  return x < y ? -1 : (x > y) ;
+}
+
+I64 oneIntervalQuery (OneIntervalIndex *ix, OneFile *vf, I64 target, I64 start, I64 end,
+		      I64 **objects)
+{ I64 lo, hi, mid, i, j, l, n = 0, nCand = 0, *cand, val[3] ;
+  I64 maxPos = (I64) 1 << (ix->minShift + 3*ix->depth) ;
+
+  *objects = new (1, I64) ;
+  if (start < 0) start = 0 ;
+  if (end > maxPos) end = maxPos ;
+  for (lo = 0, hi = ix->nTarget ; lo < hi ; )  // find the target
+    { mid = (lo + hi) / 2 ;
+      if (ix->target[mid] < target) lo = mid + 1 ; else hi = mid ;
+    }
+  if (end <= start || lo == ix->nTarget || ix->target[lo] != target)
+    return 0 ;
+
+  // at each level take the bins from that of start to that of end-1, and their chunks
+
+  I64 b0 = ix->targetBin[lo], b1 = ix->targetBin[lo+1] ;
+  cand = new (2*(ix->binChunk[b1] - ix->binChunk[b0]) + 2, I64) ;
+  for (l = 0 ; l <= ix->depth ; ++l)
+    { int s = ix->minShift + 3*(ix->depth - l) ;
+      I64 t = (((I64) 1 << 3*l) - 1) / 7 ;
+      I64 first = t + (start >> s), last = t + ((end-1) >> s) ;
+      for (lo = b0, hi = b1 ; lo < hi ; )
+	{ mid = (lo + hi) / 2 ;
+	  if (ix->bin[mid] < first) lo = mid + 1 ; else hi = mid ;
+	}
+      for (j = lo ; j < b1 && ix->bin[j] <= last ; ++j)
+	for (i = ix->binChunk[j] ; i < ix->binChunk[j+1] ; ++i, ++nCand)
+	  { cand[2*nCand]   = ix->chunk[2*i] ;
+	    cand[2*nCand+1] = ix->chunk[2*i+1] ;
+	  }
+    }
+  qsort (cand, nCand, 2*sizeof(I64), chunkOrder) ;
+
+  // read the candidates, a chunk at a time, and keep those that overlap
+
+  for (i = 0 ; i < nCand ; ++i)
+    n += cand[2*i+1] - cand[2*i] ;
+  free (*objects) ;
+  *objects = new (n+1, I64) ;
+  n = 0 ;
+  for (i = 0 ; i < nCand ; ++i)
+    { if (!oneGotoObject (vf, cand[2*i]) || oneReadLine (vf) != vf->objectType)
+	die ("interval query can't read object %" PRId64 "", cand[2*i]) ;
+      for (j = cand[2*i] ; j < cand[2*i+1] ; ++j)
+	{ if (objectInterval (ix, vf, val) && val[0] == target && val[1] < end && val[2] > start)
+	    (*objects)[n++] = j ;
+	  while (vf->lineType && vf->lineType != vf->objectType)
+	    oneReadLine (vf) ;
+	}
+    }
+  free (cand) ;
+  return n ;
+}
+
+/******************* end of file **************/
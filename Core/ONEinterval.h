@@ -0,0 +1,62 @@
+/*  File: ONEinterval.h
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: binned interval index over the objects of a ONE file, like tabix
+ *
+ * Each object is an interval start..end-1 on a target, taken from INT fields of the first
+ * line of given types in the object, by default A.0,I.0,I.1 for an aln file, i.e. the a
+ * sequence and the aligned interval on it, or A.1,I.3,I.4 for the b side.  Negative positions,
+ * which mark the reverse strand, are taken by absolute value, and if start > end they are
+ * swapped.  Intervals are placed in the smallest bin of a hierarchical binning
+ * scheme, as in SAM/BAM and CSI indices, that holds them, with bins of 2^14 positions at the
+ * finest level and 8 times larger at each level up.  For each target the index holds for
+ * each bin the ranges of consecutive objects in it, so a file sorted on target and start
+ * has a small index, but the file need not be sorted.
+ *
+ * The index is kept in a binary ONE file of type oix beside the indexed file, which it
+ * refers to with a '<' line giving the number of objects, with lines
+ *    K <key> <min shift> <depth>    the terms, and the binning: 2^(shift+3*depth) positions
+ *    T <target>                     object, one per target with intervals, in order
+ *    B <bin> <list>                 for each bin with intervals, in order, the start,end pairs
+ *                                     of the ranges of objects in the bin
+ *
+ * Exported functions: see below
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#ifndef ONE_INTERVAL_DEFINED
+#define ONE_INTERVAL_DEFINED
+
+#include "ONElib.h"
+
+typedef struct OneIntervalIndexStruct OneIntervalIndex ;
+
+OneIntervalIndex *oneIntervalIndexBuild (OneFile *vf, char *key) ;
+
+  // Read vf from its current position, which must be before the first object, and index
+  //   its objects.  key is "T.k,S.k,E.k" for the target, start and end fields, or NULL for
+  //   "A.0,I.0,I.1".  Objects without all three line types are not indexed.  Returns NULL
+  //   with a message to stderr if key does not give three INT fields of vf.
+
+bool oneIntervalIndexWrite (OneIntervalIndex *ix, char *path, char *indexedPath) ;
+OneIntervalIndex *oneIntervalIndexRead (char *path, OneFile *vf) ;
+
+  // Write the index of the file indexedPath to path, or read it back.  Reading returns NULL
+  //   with a message to stderr if path is not an index, or if vf is given and its number of
+  //   objects differs from that of the indexed file.
+
+void oneIntervalIndexDestroy (OneIntervalIndex *ix) ;
+
+I64 oneIntervalQuery (OneIntervalIndex *ix, OneFile *vf, I64 target, I64 start, I64 end,
+		      I64 **objects) ;
+
+  // Find the objects of vf, a binary file open for reading, whose intervals on target overlap
+  //   start..end-1.  Candidates from the bins that can hold such intervals are read with
+  //   oneGotoObject() and checked.  Returns the number found and sets *objects to a new array
+  //   of their numbers in increasing order, which the caller must free.
+
+#endif // ONE_INTERVAL_DEFINED
+
+/******************* end of file **************/
@@ -16,6 +16,10 @@
  *
  ****************************************************************************************/
 
+#ifdef WITH_LIBDEFLATE
+#define _GNU_SOURCE  // for fopencookie()
+#endif
+
 #include <assert.h>
 #include <sys/errno.h>
 #include <sys/types.h>
@@ -49,19 +53,19 @@ static void *mycalloc(size_t number, size_t size);    //  allocate & zero # obje
 
 static pthread_mutex_t mutexInit = PTHREAD_MUTEX_INITIALIZER;
 
-// forward declarations of serialisation functions lower in the file
-// RD 220818: I think that many of int below should be I64, e.g. for len, ilen etc.
+// forward declarations of serialisation functions lower in the file - lengths are I64 so that
+//   a single list can hold a chromosome of more than 2^31 bases
 
 OneCodec *vcCreate();
-void      vcAddToTable(OneCodec *vc, int len, char *bytes);
+void      vcAddToTable(OneCodec *vc, I64 len, char *bytes);
 void      vcAddHistogram(OneCodec *vc, OneCodec *vh);
 void      vcCreateCodec(OneCodec *vc, int partial);
 void      vcDestroy(OneCodec *vc);
-int       vcMaxSerialSize();
-int       vcSerialize(OneCodec *vc, void *out);
 OneCodec *vcDeserialize(void *in);
-int       vcEncode(OneCodec *vc, int ilen, char *ibytes, char *obytes);
-int       vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes);
+I64       vcEncode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes);
+I64       vcDecode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes);
+I64       Compress_DNA(I64 len, char *s, char *t);
+I64       Uncompress_DNA(char *s, I64 len, char *t);
 
 // forward declarations of 64-bit integer encoding/decoding
 
@@ -164,6 +168,7 @@ static void schemaAddInfoFromArray (OneSchema *vs, int n, OneType *a, char t, ch
   else if (t == '*') vi->binaryTypePack = (54 << 2) | (char) 0x80 ;
   else if (t == '/') vi->binaryTypePack = (55 << 2) | (char) 0x80 ;
   else if (t == '.') vi->binaryTypePack = (56 << 2) | (char) 0x80 ;
+  else if (t == '=') vi->binaryTypePack = (57 << 2) | (char) 0x80 ;
 
   vs->info[(int)t] = vi ;
 }
@@ -246,6 +251,7 @@ OneSchema *oneSchemaCreateFromFile (char *filename)
 {
   FILE *fs = fopen (filename, "r") ;
   if (!fs) return 0 ;
+  fclose (fs) ;  // only checks that the file can be read; it is opened again below
   OneSchema *vs = new0 (1, OneSchema) ;
 
   OneFile *vf = new0 (1, OneFile) ;      // shell object to support bootstrap
@@ -303,6 +309,8 @@ OneSchema *oneSchemaCreateFromFile (char *filename)
   fprintf (vf->f, "D & 1 8 INT_LIST                   binary file: object index\n") ;
   fprintf (vf->f, "D * 1 8 INT_LIST                   binary file: group index\n") ;
   fprintf (vf->f, "D ; 2 4 CHAR 6 STRING              binary file: list codec\n") ;
+  fprintf (vf->f, "D : 2 4 CHAR 3 INT                 sorted: objects sorted on linetype, field\n") ;
+  fprintf (vf->f, "D = 4 4 CHAR 3 INT 3 INT 8 INT_LIST binary file: zone map: linetype, field, block size, min max per block\n") ;
   fprintf (vf->f, "D / 1 6 STRING                     binary file: comment\n") ;
   if (fseek (vf->f, 0, SEEK_SET)) die ("ONE schema failure: cannot rewind tmp file") ;
   while (oneReadLine (vf))
@@ -533,6 +541,14 @@ static void oneFileDestroy (OneFile *vf)
 
   if (vf->field) free (vf->field) ;
 
+  for (j = 0; j < (vf->share ? vf->share : 1); j++) // each thread has its own zone maps
+    { for (i = 0; i < vf[j].nZoneMap; i++)
+	{ free (vf[j].zoneMap[i].min) ;
+	  free (vf[j].zoneMap[i].max) ;
+	}
+      if (vf[j].zoneMap) free (vf[j].zoneMap) ;
+    }
+
   if (vf->headerText)
     { OneHeaderText *t = vf->headerText ;
       while (t)
@@ -647,7 +663,7 @@ static inline void readString(OneFile *vf, char *buf, I64 n)
     }
   else
     { if ((I64) fread (buf, 1, n, vf->f) != n)
-	die ("ONE parse error: failed to read %d byte string", n);
+	die ("ONE parse error: failed to read %" PRId64 " byte string", n);
       buf[n] = 0 ;
     }
 }
@@ -912,6 +928,135 @@ static void readStringList(OneFile *vf, char t, I64 len)
   free (string);
 }
 
+  // Streamed lists: see oneStreamList() and oneWriteListBegin().  Lists are moved in pieces
+  //   of up to STREAM_BYTES, through codecBuf when they are compressed DNA.
+
+#define STREAM_BYTES 0x10000
+
+enum { STREAM_RAW = 1, STREAM_PACKED, STREAM_BUFFER, STREAM_ASCII } ;
+
+static bool isStreamable (OneInfo *li)
+{ OneType type ;
+
+  if (li == NULL || li->listEltSize == 0 || li->listField != li->nField-1)
+    return false ;
+  type = li->fieldType[li->listField] ;
+  return (type == oneSTRING || type == oneDNA || type == oneREAL_LIST) ;
+}
+
+static void streamCodecBuf (OneFile *vf) // codecBuf must hold a piece of a list
+{ if (vf->codecBufSize < STREAM_BYTES+1)
+    { free (vf->codecBuf) ;
+      vf->codecBufSize = STREAM_BYTES+1 ;
+      vf->codecBuf     = new (vf->codecBufSize, char) ;
+    }
+}
+
+static void streamListStart (OneFile *vf, OneInfo *li, I64 len, char mode)
+{ li->accum.total += len ;
+  if (len > li->accum.max)
+    li->accum.max = len ;
+  vf->streamMode = mode ;
+  vf->streamLeft = len ;
+  vf->streamStart = (mode == STREAM_BUFFER) ? -1 : ftello (vf->f) ;
+}
+
+  // packed DNA has 4 bases per byte, the first in the top 2 bits, with a,c,g,t as 0,1,2,3,
+  //   and 4 bit DNA 2 bases per byte, the first in the top 4 bits, as nt16 in htslib
+
+static const U8 code2[256] = { ['c'] = 1, ['C'] = 1, ['g'] = 2, ['G'] = 2, ['t'] = 3, ['T'] = 3 } ;
+static const U8 code4[256] = { ['a'] = 1, ['A'] = 1, ['c'] = 2, ['C'] = 2,
+			       ['g'] = 4, ['G'] = 4, ['t'] = 8, ['T'] = 8 } ; // else 15 for n
+static const char base4[16] = "nacngnnntnnnnnnn" ;
+
+static void packDNA (char *in, I64 len, U8 *out)
+{ I64 i ;
+
+  memset (out, 0, (len+3) >> 2) ;
+  for (i = 0 ; i < len ; ++i)
+    out[i >> 2] |= code2[(U8) in[i]] << (6 - 2*(i & 3)) ;
+}
+
+static void shiftDNA (U8 *in, I64 skip, I64 len, U8 *out) // packed bases skip.. of in, skip < 4
+{ I64 j, nOut = (len+3) >> 2, nIn = (skip+len+3) >> 2 ;
+  int s = 2*skip ;
+
+  if (s == 0)
+    memcpy (out, in, nOut) ;
+  else
+    for (j = 0 ; j < nOut ; ++j)
+      out[j] = (in[j] << s) | (j+1 < nIn ? in[j+1] >> (8-s) : 0) ;
+  if (len & 3)  // clear the bits past the end
+    out[nOut-1] &= (U8) (0xff << (8 - 2*(len & 3))) ;
+}
+
+static void nibbleDNA (char *in, I64 len, U8 *out) // to 4 bit from text
+{ I64 i ;
+  U8  x ;
+
+  memset (out, 0, (len+1) >> 1) ;
+  for (i = 0 ; i < len ; ++i)
+    { x = code4[(U8) in[i]] ;
+      out[i >> 1] |= (x ? x : 15) << ((i & 1) ? 0 : 4) ;
+    }
+}
+
+static void unpackDNA (U8 *in, I64 start, I64 len, char *out) // bases start.. of packed in
+{ static char base[4] = { 'a', 'c', 'g', 't' } ;
+  I64 i ;
+
+  in += start >> 2 ;
+  start &= 3 ;
+  for (i = start ; i < start+len ; ++i)
+    *out++ = base[(in[i >> 2] >> (6 - 2*(i & 3))) & 0x3] ;
+}
+
+static void readStreamStart (OneFile *vf, OneInfo *li, I64 len, bool isCompressed)
+{ if (!isCompressed)
+    streamListStart (vf, li, len, STREAM_RAW) ;
+  else if (li->listCodec == DNAcodec) // 2 bits per base, so read in pieces
+    { ltfRead (vf->f) ;               //   and the number of bits is known
+      streamCodecBuf (vf) ;
+      streamListStart (vf, li, len, STREAM_PACKED) ;
+    }
+  else                                // a trained codec can only decode the whole list
+    { I64 nBits = ltfRead (vf->f) ;
+      if (((nBits+7) >> 3) >= vf->codecBufSize)
+	{ free (vf->codecBuf) ;
+	  vf->codecBufSize = ((nBits+7) >> 3) + 1 ;
+	  vf->codecBuf     = new (vf->codecBufSize, char) ;
+	}
+      if (fread (vf->codecBuf, ((nBits+7) >> 3), 1, vf->f) != 1)
+	die ("ONE read error: fail to read compressed list") ;
+      if (!li->isUserBuf && li->bufSize < len+1)
+	{ free (li->buffer) ;
+	  li->bufSize = len+1 ;
+	  li->buffer  = new (li->bufSize*li->listEltSize, void) ;
+	}
+      vcDecode (li->listCodec, nBits, vf->codecBuf, li->buffer) ;
+      streamListStart (vf, li, len, STREAM_BUFFER) ;
+    }
+}
+
+static void readLineComment (OneFile *vf) // if the next line is a comment then read it
+{ char t = vf->lineType ;
+  U8   peek = getc(vf->f) ;
+
+  ungetc(peek, vf->f) ;
+  if (peek & 0x80)
+    peek = vf->binaryTypeUnpack[peek];
+  if (peek == '/') // a comment
+    { OneField keepField0 = vf->field[0] ;
+      oneReadLine (vf) ; // read comment line into vf->info['/']->buffer
+      vf->lineType = t ;
+      vf->field[0] = keepField0 ;
+    }
+}
+
+static bool catNextFile (OneFile *vf) ;
+static bool catSeek (OneFile *vf, I64 i) ;
+static void catDestroy (OneFile *vf) ;
+
 char oneReadLine (OneFile *vf)
 { bool      isAscii;
   U8        x;
@@ -921,8 +1066,23 @@ char oneReadLine (OneFile *vf)
   assert (!vf->isWrite) ;
   assert (!vf->isFinal) ;
 
+  if (vf->streamLeft)              // skip what is left of a streamed list
+    { I64 skip[1024] ;
+      I64 n = sizeof(skip) / vf->info[(int) vf->lineType]->listEltSize ;
+      while (oneReadListChunk (vf, skip, n)) ;
+    }
+
+  if (vf->partEnd && ftello (vf->f) >= vf->partEnd) // end of a partition
+    { vf->lineType = 0 ;
+      return 0;
+    }
+
   vf->linePos = 0;                 // must come before first vfGetc()
   x = vfGetc (vf);                 // read first char
+  while ((feof (vf->f) || x == '\n') && vf->cat && catNextFile (vf))
+    { vf->linePos = 0;             // the end of the data of one of a concatenation of files
+      x = vfGetc (vf);
+    }
   if (feof (vf->f) || x == '\n')   // blank line (x=='\n') is end of records marker before footer
     { vf->lineType = 0 ;           // additional marker of end of file
       return 0;
@@ -978,6 +1138,11 @@ char oneReadLine (OneFile *vf)
 	  case oneDNA:
             len = readInt (vf);
             vf->field[i].len = len;
+            if (li->isStream)
+              { eatWhite (vf);
+                streamListStart (vf, li, len, STREAM_ASCII);
+                break;
+              }
             updateCountsAndBuffer (vf, t, len, 1);
             readString (vf, (char*) li->buffer, len);
             break;
@@ -992,6 +1157,10 @@ char oneReadLine (OneFile *vf)
           case oneREAL_LIST:
             len = readInt (vf);
             vf->field[i].len = len;
+            if (li->isStream)
+              { streamListStart (vf, li, len, STREAM_ASCII);
+                break;
+              }
             updateCountsAndBuffer (vf, t, len, 0);
             rlst = (double *) li->buffer;
             for (j = 0; j < len; ++j)
@@ -1004,7 +1173,8 @@ char oneReadLine (OneFile *vf)
             readStringList (vf, t, len);
             break;
 	  }
-      readFlush (vf);
+      if (!vf->streamLeft)  // else the end of the line is read with the end of the list
+        readFlush (vf);
     }
 
   else        // binary - block read fields and list, potentially compressed
@@ -1024,11 +1194,21 @@ char oneReadLine (OneFile *vf)
       if (li->listEltSize > 0)
         { I64 listLen = oneLen(vf);
 
-          if (listLen > 0)
+          if (listLen > 0 && li->isStream)
+            { readStreamStart (vf, li, listLen, x & 0x1) ;
+              return t ;        // the comment, if any, is read at the end of the list
+            }
+          else if (listLen > 0)
             { li->accum.total += listLen;
 	      if (listLen > li->accum.max)
 		li->accum.max = listLen;
 
+	      if (t == '=' && listLen > li->bufSize) // zone map lengths are not counted
+		{ if (li->buffer) free (li->buffer) ;
+		  li->bufSize = listLen ;
+		  li->buffer  = new (listLen, I64) ;
+		}
+
 	      if (li->fieldType[li->listField] == oneINT_LIST)
 		{ *(I64*)li->buffer = ltfRead (vf->f) ;
 		  if (listLen == 1) goto doneLine ;
@@ -1055,23 +1235,13 @@ char oneReadLine (OneFile *vf)
                 }
             }
 
-          if (li->fieldType[li->listField] == oneSTRING)
+          if (li->fieldType[li->listField] == oneSTRING && li->buffer)
             ((char *) li->buffer)[listLen] = '\0'; // 0 terminate
         }
 
     doneLine:
 
-      { U8 peek = getc(vf->f) ; // check if next line is a comment - if so then read it
-	ungetc(peek, vf->f) ;
-	if (peek & 0x80)
-	  peek = vf->binaryTypeUnpack[peek];
-	if (peek == '/') // a comment
-	  { OneField keepField0 = vf->field[0] ;
-	    oneReadLine (vf) ; // read comment line into vf->info['/']->buffer
-	    vf->lineType = t ;
-	    vf->field[0] = keepField0 ;
-	  }
-      }
+      readLineComment (vf) ;
     }
 
   return t;
@@ -1108,11 +1278,709 @@ void *oneCompressedList (OneFile *vf)
   OneInfo *li = vf->info[(int) vf->lineType] ;
 
   if (!vf->nBits && oneLen(vf) > 0)      // need to compress
-    vcEncode (li->listCodec, oneLen(vf), vf->info[(int) vf->lineType]->buffer, vf->codecBuf);
+    { if (oneLen(vf)*li->listEltSize >= vf->codecBufSize) // ascii counts may be missing
+	{ free (vf->codecBuf) ;
+	  vf->codecBufSize = oneLen(vf)*li->listEltSize + 1 ;
+	  vf->codecBuf     = new (vf->codecBufSize, char) ;
+	}
+      vcEncode (li->listCodec, oneLen(vf), vf->info[(int) vf->lineType]->buffer, vf->codecBuf);
+    }
 
   return (void*) vf->codecBuf ;
 }
 
+  /* A saved line is a SavedLine, then its fields, its list as read, compressed or not, and
+   * its comment.  The size is rounded up to 8 bytes, so saved lines can follow each other.
+   */
+
+typedef struct { I64 size, nBits, intListBytes, listBytes ; char lineType ; } SavedLine ;
+
+I64 oneSaveLine (OneFile *vf, void *buf, I64 size)
+{ OneInfo   *li = vf->info[(int) vf->lineType] ;
+  SavedLine *x = (SavedLine *) buf ;
+  char      *s, *comment = oneReadComment (vf) ;
+  I64        fieldBytes = li->nField * sizeof(OneField), listBytes = 0, commentBytes, i, n ;
+
+  if (li->isStream)
+    die ("ONE error: can't save a line of streamed type %c", vf->lineType) ;
+  if (vf->nBits && vf->cat)	// the next file of a concatenation may have other codecs
+    oneList (vf) ;
+  if (!li->listEltSize || !li->buffer)
+    ;
+  else if (vf->nBits)		// an INT_LIST keeps its first element in the buffer
+    listBytes = ((vf->nBits+7) >> 3)
+      + (li->fieldType[li->listField] == oneINT_LIST ? sizeof(I64) : 0) ;
+  else if (li->fieldType[li->listField] == oneSTRING_LIST)
+    for (i = 0, s = (char *) li->buffer ; i < oneLen(vf) ; ++i, s = oneNextString(vf,s))
+      listBytes += strlen (s) + 1 ;
+  else if (li->fieldType[li->listField] == oneSTRING)
+    listBytes = oneLen(vf) + 1 ;
+  else
+    listBytes = oneLen(vf) * li->listEltSize ;
+  commentBytes = (comment ? strlen (comment) : 0) + 1 ;
+
+  n = (sizeof(SavedLine) + fieldBytes + listBytes + commentBytes + 7) & ~7 ;
+  if (n > size)
+    return n ;
+  x->size = n ; x->nBits = vf->nBits ; x->intListBytes = vf->intListBytes ;
+  x->listBytes = listBytes ; x->lineType = vf->lineType ;
+  s = (char *) (x+1) ;
+  memcpy (s, vf->field, fieldBytes) ; s += fieldBytes ;
+  if (vf->nBits && li->fieldType[li->listField] == oneINT_LIST)
+    { memcpy (s, li->buffer, sizeof(I64)) ;
+      memcpy (s + sizeof(I64), vf->codecBuf, listBytes - sizeof(I64)) ;
+    }
+  else if (vf->nBits)
+    memcpy (s, vf->codecBuf, listBytes) ;
+  else if (listBytes)
+    memcpy (s, li->buffer, listBytes) ;
+  s += listBytes ;
+  if (comment)
+    memcpy (s, comment, commentBytes) ;
+  else
+    *s = 0 ;
+  return n ;
+}
+
+I64 oneRestoreLine (OneFile *vf, void *buf)
+{ SavedLine *x = (SavedLine *) buf ;
+  OneInfo   *li = vf->info[(int) x->lineType] ;
+  char      *s = (char *) (x+1) ;
+
+  vf->lineType = x->lineType ;
+  vf->nBits = x->nBits ;
+  vf->intListBytes = x->intListBytes ;
+  memcpy (vf->field, s, li->nField * sizeof(OneField)) ; s += li->nField * sizeof(OneField) ;
+  if (x->nBits && li->fieldType[li->listField] == oneINT_LIST)
+    { memcpy (li->buffer, s, sizeof(I64)) ;
+      memcpy (vf->codecBuf, s + sizeof(I64), x->listBytes - sizeof(I64)) ;
+    }
+  else if (x->nBits)
+    memcpy (vf->codecBuf, s, x->listBytes) ;
+  else if (x->listBytes)
+    memcpy (li->buffer, s, x->listBytes) ;
+  s += x->listBytes ;
+  if (vf->info['/']->bufSize)	// as big as any comment read, so as this one
+    strcpy ((char *) vf->info['/']->buffer, s) ;
+  return x->size ;
+}
+
+bool oneReadDNARange (OneFile *vf, I64 start, I64 len, char *out)
+{ OneInfo *li = vf->info[(int) vf->lineType] ;
+  off_t    here ;
+  I64      i, m ;
+
+  if (!vf->lineType || li->listEltSize != 1 || start < 0 || len < 0 || start+len > oneLen(vf)
+      || li->fieldType[li->listField] == oneSTRING_LIST)
+    return false ;
+
+  if (!li->isStream || vf->streamMode == STREAM_BUFFER) // the line is in memory
+    { if (vf->nBits && li->listCodec == DNAcodec)       //   and not yet unpacked
+	unpackDNA ((U8 *) vf->codecBuf, start, len, out) ;
+      else
+	memcpy (out, (char *) oneList(vf) + start, len) ;
+      return true ;
+    }
+
+  if ((here = ftello (vf->f)) < 0 || vf->streamStart < 0)
+    die ("ONE read error: can't read a range of a list from a file that can't seek") ;
+  if (vf->streamMode == STREAM_PACKED)  // in pieces through codecBuf
+    for (i = 0 ; i < len ; i += m)
+      { I64 skip = (start+i) & 3 ;
+	m = len - i ;
+	if (m > 4*STREAM_BYTES - skip)
+	  m = 4*STREAM_BYTES - skip ;
+	if (fseeko (vf->f, vf->streamStart + ((start+i) >> 2), SEEK_SET) != 0
+	    || fread (vf->codecBuf, (skip+m+3) >> 2, 1, vf->f) != 1)
+	  die ("ONE read error: failed to read compressed DNA range") ;
+	unpackDNA ((U8 *) vf->codecBuf, skip, m, out + i) ;
+      }
+  else if (len > 0)                     // one byte per base, binary or ascii
+    { if (fseeko (vf->f, vf->streamStart + start, SEEK_SET) != 0 || fread (out, len, 1, vf->f) != 1)
+	die ("ONE read error: failed to read list range") ;
+    }
+  if (fseeko (vf->f, here, SEEK_SET) != 0)
+    die ("ONE read error: failed to seek back after reading a list range") ;
+  return true ;
+}
+
+#define DNA_PIECE 4096   // bases converted at a time through the stack
+
+static void zeroPad (U8 *out, I64 nBytes) // complete the last 8 byte word
+{ while (nBytes & 7)
+    out[nBytes++] = 0 ;
+}
+
+bool oneReadDNA2bit (OneFile *vf, I64 start, I64 len, U8 *out)
+{ OneInfo *li = vf->info[(int) vf->lineType] ;
+  char     text[DNA_PIECE] ;
+  off_t    here ;
+  I64      i, m ;
+
+  if (!vf->lineType || li->listEltSize != 1 || start < 0 || len < 0 || start+len > oneLen(vf)
+      || li->fieldType[li->listField] == oneSTRING_LIST)
+    return false ;
+
+  if (li->isStream && vf->streamMode == STREAM_PACKED) // read only the bytes of the range
+    { if ((here = ftello (vf->f)) < 0 || vf->streamStart < 0)
+	die ("ONE read error: can't read a range of a list from a file that can't seek") ;
+      for (i = 0 ; i < len ; i += m)  // pieces of whole output bytes through codecBuf
+	{ I64 skip = (start+i) & 3 ;
+	  m = len - i ;
+	  if (m > 4*STREAM_BYTES - 4)
+	    m = 4*STREAM_BYTES - 4 ;
+	  if (fseeko (vf->f, vf->streamStart + ((start+i) >> 2), SEEK_SET) != 0
+	      || fread (vf->codecBuf, (skip+m+3) >> 2, 1, vf->f) != 1)
+	    die ("ONE read error: failed to read compressed DNA range") ;
+	  shiftDNA ((U8 *) vf->codecBuf, skip, m, out + (i >> 2)) ;
+	}
+      if (fseeko (vf->f, here, SEEK_SET) != 0)
+	die ("ONE read error: failed to seek back after reading a list range") ;
+    }
+  else if (!li->isStream && vf->nBits && li->listCodec == DNAcodec) // packed in codecBuf
+    shiftDNA ((U8 *) vf->codecBuf + (start >> 2), start & 3, len, out) ;
+  else                                                   // from text, a piece at a time
+    for (i = 0 ; i < len ; i += m)
+      { m = (len - i < DNA_PIECE) ? len - i : DNA_PIECE ;
+	oneReadDNARange (vf, start+i, m, text) ;
+	packDNA (text, m, out + (i >> 2)) ;
+      }
+
+  zeroPad (out, (len+3) >> 2) ;
+  return true ;
+}
+
+bool oneReadDNA4bit (OneFile *vf, I64 start, I64 len, U8 *out)
+{ OneInfo *li = vf->info[(int) vf->lineType] ;
+  char     text[DNA_PIECE] ;
+  I64      i, m ;
+
+  if (!vf->lineType || li->listEltSize != 1 || start < 0 || len < 0 || start+len > oneLen(vf)
+      || li->fieldType[li->listField] == oneSTRING_LIST)
+    return false ;
+
+  for (i = 0 ; i < len ; i += m) // DNA_PIECE is even, so pieces fill whole bytes
+    { m = (len - i < DNA_PIECE) ? len - i : DNA_PIECE ;
+      oneReadDNARange (vf, start+i, m, text) ;
+      nibbleDNA (text, m, out + (i >> 1)) ;
+    }
+
+  zeroPad (out, (len+1) >> 1) ;
+  return true ;
+}
+
+void oneWriteDNA2bit (OneFile *vf, char lineType, I64 len, U8 *dna)
+{ char text[DNA_PIECE] ;
+  I64  i, m ;
+
+  oneWriteListBegin (vf, lineType, len) ;
+  if (vf->streamMode == STREAM_PACKED && len > 0) // the file format: write it directly
+    { I64 nBytes = (len+3) >> 2 ;
+      U8  last   = dna[nBytes-1] ;
+      if (len & 3)
+	last &= (U8) (0xff << (8 - 2*(len & 3))) ;
+      if ((nBytes > 1 && fwrite (dna, nBytes-1, 1, vf->f) != 1) || fputc (last, vf->f) == EOF)
+	die ("ONE write error: failed to write packed DNA") ;
+      vf->byte += nBytes ;
+      vf->streamLeft = 0 ;
+    }
+  else
+    for (i = 0 ; i < len ; i += m)
+      { m = (len - i < DNA_PIECE) ? len - i : DNA_PIECE ;
+	unpackDNA (dna, i, m, text) ;
+	oneWriteListChunk (vf, m, text) ;
+      }
+  oneWriteListEnd (vf) ;
+}
+
+void oneWriteDNA4bit (OneFile *vf, char lineType, I64 len, U8 *dna)
+{ char text[DNA_PIECE] ;
+  I64  i, j, m ;
+
+  oneWriteListBegin (vf, lineType, len) ;
+  for (i = 0 ; i < len ; i += m)
+    { m = (len - i < DNA_PIECE) ? len - i : DNA_PIECE ;
+      for (j = 0 ; j < m ; ++j)
+	text[j] = base4[(dna[(i+j) >> 1] >> (((i+j) & 1) ? 0 : 4)) & 0xf] ;
+      oneWriteListChunk (vf, m, text) ;
+    }
+  oneWriteListEnd (vf) ;
+}
+
+bool oneStreamList (OneFile *vf, char lineType)
+{ int j, n = (vf->share > 0) ? vf->share : 1 ;
+
+  if (vf->isWrite || !isStreamable (vf->info[(int) lineType]))
+    return false ;
+
+  for (j = 0 ; j < n ; ++j)  // each thread of a parallel read
+    { OneFile *v  = vf + j ;
+      OneInfo *li = v->info[(int) lineType] ;
+      I64      size = v->nFieldMax * sizeof(OneField) ;
+      int      i ;
+
+      li->isStream = true ;
+      if (!li->isUserBuf && li->buffer != NULL) // lists of lineType no longer go here
+	{ free (li->buffer) ;
+	  li->buffer  = NULL ;
+	  li->bufSize = 0 ;
+	}
+      for (i = 0 ; i < 128 ; ++i)               // nor into codecBuf, which can shrink
+	{ OneInfo *lk = v->info[i] ;
+	  if (lk && lk->listCodec && !lk->isStream && size < lk->given.max * lk->listEltSize)
+	    size = lk->given.max * lk->listEltSize ;
+	}
+      if (size < STREAM_BYTES)
+	size = STREAM_BYTES ;
+      if (size+1 < v->codecBufSize)
+	{ free (v->codecBuf) ;
+	  v->codecBufSize = size+1 ;
+	  v->codecBuf     = new (v->codecBufSize, char) ;
+	}
+    }
+  return true ;
+}
+
+I64 oneReadListChunk (OneFile *vf, void *buf, I64 maxLen)
+{ OneInfo *li = vf->info[(int) vf->lineType] ;
+  I64      i, m, n ;
+  char    *s = (char *) buf ;
+
+  if (vf->streamLeft == 0)
+    return 0 ;
+  n = (maxLen < vf->streamLeft) ? maxLen : vf->streamLeft ;
+
+  switch (vf->streamMode)
+    {
+    case STREAM_RAW:
+      if ((I64) fread (buf, li->listEltSize, n, vf->f) != n)
+	die ("ONE read error: failed to read list chunk of %" PRId64 "", n) ;
+      break ;
+    case STREAM_PACKED:     // whole bytes of 4 bases, except at the end of the list
+      if (n < vf->streamLeft)
+	{ n &= ~((I64) 3) ;
+	  if (n == 0)
+	    die ("ONE read error: compressed DNA must be read at least 4 bases at a time") ;
+	}
+      for (i = 0 ; i < n ; i += m)
+	{ m = n - i ;
+	  if (m > 4*STREAM_BYTES)
+	    m = 4*STREAM_BYTES ;
+	  if (fread (vf->codecBuf, (m+3) >> 2, 1, vf->f) != 1)
+	    die ("ONE read error: failed to read compressed DNA chunk of %" PRId64 "", m) ;
+	  Uncompress_DNA (vf->codecBuf, m, s + i) ;
+	}
+      break ;
+    case STREAM_BUFFER:
+      memcpy (buf, (char *) li->buffer + (oneLen(vf) - vf->streamLeft) * li->listEltSize,
+	      n * li->listEltSize) ;
+      break ;
+    case STREAM_ASCII:
+      if (li->fieldType[li->listField] == oneREAL_LIST)
+	for (i = 0 ; i < n ; ++i)
+	  ((double *) buf)[i] = readReal (vf) ;
+      else if (vf->isCheckString)
+	{ for (i = 0 ; i < n ; ++i)
+	    if ((s[i] = vfGetc (vf)) == '\n' || s[i] == EOF)
+	      parseError (vf, "line too short") ;
+	}
+      else if ((I64) fread (buf, 1, n, vf->f) != n)
+	die ("ONE parse error: failed to read %" PRId64 " byte string", n) ;
+      break ;
+    }
+
+  vf->streamLeft -= n ;
+  if (vf->streamLeft == 0)  // finish the line
+    { if (vf->streamMode == STREAM_ASCII)
+	readFlush (vf) ;
+      else
+	readLineComment (vf) ;
+    }
+  return n ;
+}
+
+/***********************************************************************************
+ *
+ *   COMPRESSED INPUT: gzip, BGZF and VGPzip files read through an inflating FILE
+ *
+ **********************************************************************************/
+
+  // A gzip file is inflated with libdeflate into memory a batch at a time, and handed to the
+  //   parser through a FILE from fopencookie() or funopen(), so ftello() and fseeko() work in
+  //   inflated positions.  If the gzip members can be found without inflating, from their
+  //   BGZF headers or from the .vzi index that VGPzip writes beside x.gz as x.vzi, a batch is
+  //   up to nThreads pieces of whole members inflated in parallel, and a seek back starts
+  //   again at the batch it falls in.  Any other gzip file is inflated as a stream with zlib
+  //   a batch at a time when compiled WITH_ZLIB, and a seek back then starts again at the
+  //   beginning.  Without zlib it is inflated whole in one batch.
+
+#ifdef WITH_LIBDEFLATE
+
+#include "libdeflate.h"
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#define ZIP_PIECE (1 << 22)   // target compressed bytes in a BGZF piece
+#define ZIP_STREAM (1 << 24)  // inflated bytes in a batch of a gzip stream
+#define ZIP_RATIO 1032        // the largest possible ratio of inflated to deflated size
+
+typedef struct {
+  struct libdeflate_decompressor *dz ;
+  U8  *in ;                   // whole gzip members, in ZipIn->zBuf
+  I64  inLen ;
+  U8  *out ;
+  I64  outLen, outSize ;
+} ZipPiece ;
+
+typedef struct {
+  int       fd ;
+  I64       zSize ;           // size of the compressed file
+  I64      *vzi, nVzi ;       // member ends from a VGPzip index, else 0
+  bool      isBgzf ;
+  int       nThreads, nPiece, iPiece ;
+  ZipPiece *piece ;
+  U8       *zBuf ;
+  I64       zBufSize ;
+  I64       zNext, uNext ;    // compressed and inflated offsets of the next batch
+  I64       uBatch, uPos, pos ; // inflated offsets of this batch and the read point, pos in piece
+  I64      *mark, nMark ;     // zNext,uNext pairs of the batches read so far
+#ifdef WITH_ZLIB
+  z_stream *zs ;              // for a gzip file that is neither BGZF nor indexed, else 0
+  bool      isStreamEnd ;     // zs has reached the end of its last member
+#endif
+} ZipIn ;
+
+static inline I64 le32 (U8 *p) { return p[0] | p[1] << 8 | p[2] << 16 | (I64) p[3] << 24 ; }
+
+static I64 bgzfSize (U8 *p, I64 n) // size of the BGZF member at p, or 0 if none is complete
+{ I64 i, xEnd ;
+
+  if (n < 18 || p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || !(p[3] & 4))
+    return 0 ;
+  xEnd = 12 + (p[10] | p[11] << 8) ;
+  for (i = 12 ; i + 6 <= xEnd && i + 6 <= n ; i += 4 + (p[i+2] | p[i+3] << 8))
+    if (p[i] == 'B' && p[i+1] == 'C' && (p[i+2] | p[i+3] << 8) == 2)
+      { I64 size = (p[i+4] | p[i+5] << 8) + 1 ;
+	return size <= n ? size : 0 ;
+      }
+  return 0 ;
+}
+
+static void *zipInflate (void *arg)
+{ ZipPiece *p = (ZipPiece *) arg ;
+  U8       *in = p->in, *end = p->in + p->inLen ;
+  size_t    inUsed, outUsed ;
+
+  p->outLen = 0 ;
+  while (in < end)
+    switch (libdeflate_gzip_decompress_ex (p->dz, in, end - in, p->out + p->outLen,
+					   p->outSize - p->outLen, &inUsed, &outUsed))
+      {
+      case LIBDEFLATE_SUCCESS:
+	in += inUsed ; p->outLen += outUsed ;
+	break ;
+      case LIBDEFLATE_INSUFFICIENT_SPACE: // only if the size was not known or is wrong
+	{ I64 size = 2*p->outSize, max = ZIP_RATIO * p->inLen + 1 ;
+	  U8 *out ;
+	  if (p->outSize >= max)
+	    die ("ONE file error: truncated or corrupt gzip") ;
+	  if (size > max) size = max ;
+	  out = new (size, U8) ;
+	  memcpy (out, p->out, p->outLen) ;
+	  free (p->out) ; p->out = out ; p->outSize = size ;
+	}
+	break ;
+      default:
+	die ("ONE file error: bad gzip data") ;
+      }
+  return 0 ;
+}
+
+#ifdef WITH_ZLIB
+
+static bool zipStream (ZipIn *z) // inflate up to ZIP_STREAM bytes of a gzip stream
+{ z_stream *zs = z->zs ;
+  ZipPiece *zp = z->piece ;
+  bool      inMember = true ;
+  int       ret ;
+
+  if (z->isStreamEnd) return false ;
+  if (!zp->outSize)
+    { zp->outSize = ZIP_STREAM ; zp->out = new (ZIP_STREAM, U8) ; }
+  if (z->zBufSize < ZIP_PIECE)
+    { free (z->zBuf) ; z->zBufSize = ZIP_PIECE ; z->zBuf = new (ZIP_PIECE, U8) ; }
+  zs->next_out = zp->out ; zs->avail_out = zp->outSize ;
+  while (zs->avail_out)
+    { if (!zs->avail_in)
+	{ I64 n = z->zSize - z->zNext ;
+	  if (!n) break ;
+	  if (n > z->zBufSize) n = z->zBufSize ;
+	  if ((n = pread (z->fd, z->zBuf, n, z->zNext)) <= 0)
+	    die ("ONE file error: failed to read compressed input") ;
+	  zs->next_in = z->zBuf ; zs->avail_in = n ; z->zNext += n ;
+	}
+      if (!inMember) // another member follows the last
+	{ inflateReset (zs) ; inMember = true ; }
+      ret = inflate (zs, Z_NO_FLUSH) ;
+      if (ret == Z_STREAM_END)
+	inMember = false ;
+      else if (ret != Z_OK)
+	die ("ONE file error: truncated or corrupt gzip") ;
+    }
+  if (zs->avail_out) // the input is all read
+    { if (inMember)
+	die ("ONE file error: truncated or corrupt gzip") ;
+      z->isStreamEnd = true ;
+    }
+  else if (!inMember && !zs->avail_in && z->zNext == z->zSize)
+    z->isStreamEnd = true ;
+  else if (!inMember)
+    inflateReset (zs) ;
+
+  zp->outLen = zp->outSize - zs->avail_out ;
+  z->uNext += zp->outLen ;
+  z->nPiece = 1 ;
+  return zp->outLen > 0 ;
+}
+
+#endif // WITH_ZLIB
+
+static bool zipRefill (ZipIn *z) // inflate the batch at zNext
+{ I64 want, got, j = 0 ;
+  U8 *p, *end ;
+  int i ;
+
+  z->uBatch = z->uPos = z->uNext ;
+  z->nPiece = z->iPiece = 0 ; z->pos = 0 ;
+#ifdef WITH_ZLIB
+  if (z->zs) return zipStream (z) ;
+#endif
+  if (z->zNext >= z->zSize) return false ;
+
+  if (!z->nMark || z->zNext > z->mark[2*z->nMark-2])
+    { if (!(z->nMark & (z->nMark-1))) // grow at powers of 2
+	{ I64 *mark = new (4*(z->nMark ? z->nMark : 1), I64) ;
+	  if (z->nMark) { memcpy (mark, z->mark, 2*z->nMark*sizeof(I64)) ; free (z->mark) ; }
+	  z->mark = mark ;
+	}
+      z->mark[2*z->nMark] = z->zNext ; z->mark[2*z->nMark+1] = z->uNext ; ++z->nMark ;
+    }
+
+  if (z->vzi)
+    { I64 lo = 0, hi = z->nVzi, mid ; // find the first member ending after zNext
+      while (lo < hi)
+	{ mid = (lo+hi)/2 ;
+	  if (z->vzi[mid] <= z->zNext) lo = mid+1 ; else hi = mid ;
+	}
+      j = lo ;
+      hi = (j + z->nThreads < z->nVzi) ? j + z->nThreads : z->nVzi ;
+      want = z->vzi[hi-1] - z->zNext ;
+    }
+  else if (z->isBgzf)
+    want = z->nThreads * (I64) ZIP_PIECE ;
+  else
+    want = z->zSize - z->zNext ;
+  if (want > z->zSize - z->zNext) want = z->zSize - z->zNext ;
+
+  if (want > z->zBufSize)
+    { free (z->zBuf) ; z->zBufSize = want ; z->zBuf = new (want, U8) ; }
+  for (got = 0 ; got < want ; )
+    { I64 n = pread (z->fd, z->zBuf + got, want - got, z->zNext + got) ;
+      if (n <= 0) die ("ONE file error: failed to read compressed input") ;
+      got += n ;
+    }
+
+  p = z->zBuf ; end = z->zBuf + want ;
+  while (p < end && z->nPiece < z->nThreads)
+    { ZipPiece *zp = z->piece + z->nPiece ;
+      I64 need = 0, size ;
+      zp->in = p ;
+      if (z->vzi)
+	{ p = z->zBuf + (z->vzi[j + z->nPiece] - z->zNext) ;
+	  need = le32 (p-4) ;
+	}
+      else if (z->isBgzf)
+	{ while (p < end && p - zp->in < ZIP_PIECE && (size = bgzfSize (p, end - p)))
+	    { p += size ; need += le32 (p-4) ; }
+	  if (p == zp->in)
+	    { if (z->nPiece) break ; // leave an incomplete member for the next batch
+	      die ("ONE file error: bad or truncated BGZF block") ;
+	    }
+	}
+      else
+	{ p = end ; need = 4 * (end - zp->in) ; }
+      zp->inLen = p - zp->in ;
+      if (need >= zp->outSize)
+	{ free (zp->out) ; zp->outSize = need+1 ; zp->out = new (zp->outSize, U8) ; }
+      ++z->nPiece ;
+    }
+  z->zNext += p - z->zBuf ;
+
+  if (z->nPiece > 1)
+    { pthread_t *threads = new (z->nPiece, pthread_t) ;
+      for (i = 1 ; i < z->nPiece ; ++i)
+	pthread_create (&threads[i], 0, zipInflate, &z->piece[i]) ;
+      zipInflate (&z->piece[0]) ;
+      for (i = 1 ; i < z->nPiece ; ++i)
+	pthread_join (threads[i], 0) ;
+      free (threads) ;
+    }
+  else
+    zipInflate (&z->piece[0]) ;
+
+  for (i = 0 ; i < z->nPiece ; ++i)
+    z->uNext += z->piece[i].outLen ;
+  return true ;
+}
+
+static I64 zipRead (ZipIn *z, char *buf, I64 n) // copy up to n bytes to buf, or skip if !buf
+{ I64 done = 0, k ;
+
+  while (done < n)
+    if (z->iPiece >= z->nPiece)
+      { if (!zipRefill (z)) break ; }
+    else if ((k = z->piece[z->iPiece].outLen - z->pos) <= 0)
+      { ++z->iPiece ; z->pos = 0 ; }
+    else
+      { if (k > n - done) k = n - done ;
+	if (buf) memcpy (buf + done, z->piece[z->iPiece].out + z->pos, k) ;
+	z->pos += k ; z->uPos += k ; done += k ;
+      }
+  return done ;
+}
+
+static I64 zipSeek (ZipIn *z, I64 off, int whence) // returns the new position, or -1
+{ I64 target = (whence == SEEK_CUR) ? z->uPos + off : off ;
+
+  if (whence == SEEK_END || target < 0)
+    { errno = EINVAL ; return -1 ; }
+  if (target < z->uBatch) // restart at the last batch starting at or before target
+    {
+#ifdef WITH_ZLIB
+      if (z->zs) // a stream can only restart at the beginning
+	{ inflateReset (z->zs) ; z->zs->avail_in = 0 ; z->isStreamEnd = false ;
+	  z->zNext = z->uNext = 0 ;
+	}
+      else
+#endif
+	{ I64 lo = 0, hi = z->nMark, mid ;
+	  while (lo < hi)
+	    { mid = (lo+hi)/2 ;
+	      if (z->mark[2*mid+1] <= target) lo = mid+1 ; else hi = mid ;
+	    }
+	  z->zNext = z->mark[2*lo-2] ; z->uNext = z->mark[2*lo-1] ;
+	}
+      zipRefill (z) ;
+    }
+  else
+    { z->iPiece = 0 ; z->pos = 0 ; z->uPos = z->uBatch ; }
+  zipRead (z, 0, target - z->uPos) ;
+  return z->uPos ;
+}
+
+static int zipClose (void *cookie)
+{ ZipIn *z = (ZipIn *) cookie ;
+  int i ;
+
+  for (i = 0 ; i < z->nThreads ; ++i)
+    { libdeflate_free_decompressor (z->piece[i].dz) ;
+      free (z->piece[i].out) ;
+    }
+  free (z->piece) ; free (z->zBuf) ; free (z->mark) ; free (z->vzi) ;
+#ifdef WITH_ZLIB
+  if (z->zs) { inflateEnd (z->zs) ; free (z->zs) ; }
+#endif
+  close (z->fd) ;
+  free (z) ;
+  return 0 ;
+}
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+static int    zipReadF (void *z, char *buf, int n) { return (int) zipRead ((ZipIn *) z, buf, n) ; }
+static fpos_t zipSeekF (void *z, fpos_t off, int whence)
+{ return (fpos_t) zipSeek ((ZipIn *) z, (I64) off, whence) ; }
+#else
+static ssize_t zipReadF (void *z, char *buf, size_t n) { return zipRead ((ZipIn *) z, buf, n) ; }
+static int     zipSeekF (void *z, off64_t *off, int whence)
+{ I64 x = zipSeek ((ZipIn *) z, (I64) *off, whence) ;
+  if (x < 0) return -1 ;
+  *off = x ;
+  return 0 ;
+}
+#endif
+
+static I64 *readVzi (const char *path, I64 zSize, I64 *nVzi) // member ends, or 0 if no good index
+{ int   len = strlen (path) ;
+  char *name = new (len+5, char) ;
+  FILE *f ;
+  I64   i, n, *vzi = 0 ;
+
+  strcpy (name, path) ;
+  if (len > 3 && !strcmp (name+len-3, ".gz")) name[len-3] = 0 ;
+  strcat (name, ".vzi") ;
+  if ((f = fopen (name, "r")))
+    { if (fread (&n, sizeof(I64), 1, f) == 1 && n > 0 && n < zSize)
+	{ vzi = new (n, I64) ;
+	  if ((I64) fread (vzi, sizeof(I64), n, f) != n || vzi[n-1] != zSize)
+	    { free (vzi) ; vzi = 0 ; }
+	  for (i = 1 ; vzi && i < n ; ++i)
+	    if (vzi[i] <= vzi[i-1]) { free (vzi) ; vzi = 0 ; }
+	}
+      fclose (f) ;
+    }
+  free (name) ;
+  *nVzi = vzi ? n : 0 ;
+  return vzi ;
+}
+
+static FILE *zipOpen (const char *path, int nThreads)
+{ ZipIn *z = new0 (1, ZipIn) ;
+  U8    head[18] ;
+  FILE *f ;
+  int   i ;
+
+  if ((z->fd = open (path, O_RDONLY)) < 0)
+    { free (z) ; return 0 ; }
+  z->zSize = lseek (z->fd, 0, SEEK_END) ;
+  z->isBgzf = (pread (z->fd, head, 18, 0) == 18 && bgzfSize (head, 18)) ;
+  if (!z->isBgzf)
+    z->vzi = readVzi (path, z->zSize, &z->nVzi) ;
+#ifdef WITH_ZLIB
+  if (!z->isBgzf && !z->vzi)
+    { z->zs = new0 (1, z_stream) ;
+      if (inflateInit2 (z->zs, 15 + 16) != Z_OK) // 16 to expect a gzip header
+	die ("ONE file error: failed to make a gzip stream decompressor") ;
+    }
+#endif
+  z->nThreads = (nThreads > 1 && (z->isBgzf || z->vzi)) ? nThreads : 1 ;
+  z->piece = new0 (z->nThreads, ZipPiece) ;
+  for (i = 0 ; i < z->nThreads ; ++i)
+    if (!(z->piece[i].dz = libdeflate_alloc_decompressor ()))
+      die ("ONE file error: failed to make a gzip decompressor") ;
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+  f = funopen (z, zipReadF, 0, zipSeekF, zipClose) ;
+#else
+  { cookie_io_functions_t io = { zipReadF, 0, zipSeekF, zipClose } ;
+    f = fopencookie (z, "r", io) ;
+  }
+#endif
+  if (!f) zipClose (z) ;
+  return f ;
+}
+
+#else // !WITH_LIBDEFLATE
+
+static FILE *zipOpen (const char *path, int nThreads)
+{ fprintf (stderr, "ONE file error %s: reading gzip input needs ONElib.c compiled "
+	   "with -DWITH_LIBDEFLATE\n", path) ;
+  (void) nThreads ;
+  return 0 ;
+}
+
+#endif // WITH_LIBDEFLATE
+
 /***********************************************************************************
  *
  *   ONE_FILE_OPEN_READ:
@@ -1124,12 +1992,16 @@ void *oneCompressedList (OneFile *vf)
  *
  **********************************************************************************/
 
+static OneZoneMap *zoneMapAdd (OneFile *vf, char t, int field, I64 blockSize) ; // in ZONE MAPS
+static void zoneMapGrow (OneZoneMap *z, I64 n) ;
+
 OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int nthreads)
 {
   OneFile   *vf ;
   off_t      startOff = 0, footOff;
   OneSchema *vs0 = vs ;
   bool       isDynamic = false ; // if we are making the schema from the header
+  bool       isCompressed = false ;
 
   assert (fileType == NULL || strlen(fileType) == 3) ;
 
@@ -1159,6 +2031,17 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
     if (feof(f))
       OPEN_ERROR1("file is empty") ;
 
+    if (c == 0x1f) // gzip magic number - read through an inflating FILE instead
+      { if (f == stdin)
+	  OPEN_ERROR1("compressed input must be named, not stdin") ;
+	fclose (f) ;
+	if (!(f = zipOpen (path, nthreads)))
+	  return NULL ;
+	nthreads = 1 ; // threads inflate the input, which only one OneFile can then read
+	isCompressed = true ;
+	c = getc(f) ;
+      }
+
     if (c == '1')
       { int  major, minor, slen;
       
@@ -1217,6 +2100,8 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
 
       if (isalpha(peek))
         break;    // loop exit at standard data line
+      if (peek == '\n' && vf->isBinary)
+        break;    // back from the footer to an empty data section
       
       oneReadLine(vf);  // can't fail because we checked file eof already
 
@@ -1360,6 +2245,8 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
           if (oneInt(vf,0) != vf->isBig)
             die ("ONE file error: endian mismatch - convert file to ascii");
           vf->isBinary = true;
+          if (isCompressed)
+            die ("ONE file error: binary files can't be read compressed - decompress first");
 
           startOff = ftello (vf->f);
           if (fseek (vf->f, -sizeof(off_t), SEEK_END) != 0)
@@ -1370,6 +2257,9 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
 
           if (fseeko (vf->f, footOff, SEEK_SET) != 0)
             die ("ONE file error: can't seek to start of footer");
+          vf->dataStart = startOff ;
+          vf->footOff = footOff ;
+          vf->nHeaderProv = vf->info['!']->accum.count ; // any later ones are in the footer
           break;
 
         case '^':    // end of footer - return to where we jumped from header
@@ -1385,7 +2275,28 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
           break;
 
         case ';':
-          vf->info[(int) oneChar(vf,0)]->listCodec = vcDeserialize (oneString(vf));
+          { OneInfo *li = vf->info[(int) oneChar(vf,0)];
+	    if (li->listCodec) vcDestroy (li->listCodec);
+	    li->listCodec = vcDeserialize (oneString(vf));
+	    li->isUseListCodec = true;
+	  }
+          break;
+
+        case ':':
+          vf->sortType  = oneChar(vf,0);
+          vf->sortField = oneInt(vf,1);
+          break;
+
+        case '=':
+          { OneZoneMap *z = zoneMapAdd (vf, oneChar(vf,0), oneInt(vf,1), oneInt(vf,2));
+	    I64        *x = oneIntList(vf);
+	    I64         b;
+	    zoneMapGrow (z, oneLen(vf)/2);
+	    for (b = 0; b < z->nBlock; b++)
+	      { z->min[b] = x[2*b];
+		z->max[b] = x[2*b+1];
+	      }
+	  }
           break;
 
         default:
@@ -1454,7 +2365,7 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
 		  if (li->listEltSize > 0)
 		    { li->bufSize = l0->bufSize;
 		      if (li->buffer) free (li->buffer) ;
-		      li->buffer  = new (l0->bufSize*l0->listEltSize, void);
+		      li->buffer  = l0->buffer ? new (l0->bufSize*l0->listEltSize, void) : NULL;
 		    }
 		  li->given = l0->given;
 		}
@@ -1472,6 +2383,9 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *vs, char *fileType, int n
 	  v->info['*'] = vf->info['*'];
 
 	  v->isIndexIn = vf->isIndexIn;
+	  v->isBinary = vf->isBinary;
+	  v->dataStart = vf->dataStart;
+	  v->footOff = vf->footOff;
 	  strcpy (v->subType, vf->subType) ;
 	}
     } // end of parallel threads block
@@ -1518,8 +2432,18 @@ void oneUserBuffer (OneFile *vf, char lineType, void *buffer)
 bool oneGotoObject (OneFile *vf, I64 i)
 { if (vf != NULL && vf->isIndexIn && vf->objectType)
     if (0 <= i && i < vf->info[(int) vf->objectType]->given.count)
-      if (fseek (vf->f, ((I64 *) vf->info['&']->buffer)[i], SEEK_SET) == 0)
+      if (vf->cat ? catSeek (vf, i) : fseek (vf->f, ((I64 *) vf->info['&']->buffer)[i], SEEK_SET) == 0)
         { vf->object = i;
+	  vf->streamLeft = 0;
+	  if (vf->groupType) // set group to the number of groups starting at or before i
+	    { I64 *groupIndex = (I64 *) vf->info['*']->buffer;
+	      I64  lo = 0, hi = vf->info[(int) vf->groupType]->given.count, mid ;
+	      while (lo < hi)   // so that the next group line read gets the right size
+		{ mid = (lo + hi) / 2 ;
+		  if (groupIndex[mid] <= i) lo = mid + 1 ; else hi = mid ;
+		}
+	      vf->group = lo ;
+	    }
           return true ;
         }
   return false ;
@@ -1538,15 +2462,75 @@ I64 oneGotoGroup (OneFile *vf, I64 i)
 
 /***********************************************************************************
  *
- *   ONE_OPEN_WRITE_(NEW | FROM)
+ *   SORTED FILES: declaring the sort order and binary search on it
  *
  **********************************************************************************/
 
-OneFile *oneFileOpenWriteNew (const char *path, OneSchema *vs, char *fileType,
-                              bool isBinary, int nthreads)
-{ OneFile   *vf ;
-  FILE      *f ;
-  OneSchema *vs0 = vs ;
+bool oneSetSorted (OneFile *vf, char lineType, int field)
+{ OneInfo *li = vf->info[(int) lineType] ;
+  int      j ;
+
+  if (!vf->isWrite || vf->share < 0 || vf->isHeaderOut)
+    die ("ONE sort error: declare the sort order of the master before writing the header") ;
+  if (!li || !isalpha(lineType))
+    return false ;
+  if (field < 0 ? !li->listEltSize : (field >= li->nField || li->fieldType[field] != oneINT))
+    return false ;
+
+  for (j = 0 ; j < (vf->share ? vf->share : 1) ; ++j) // each thread checks its own order
+    { vf[j].sortType  = lineType ;
+      vf[j].sortField = field < 0 ? -1 : field ;
+    }
+  return true ;
+}
+
+static bool sortValue (OneFile *vf, I64 i, I64 *x) // false if object i has no sortType line
+{ char t ;
+
+  if (!oneGotoObject (vf, i) || !(t = oneReadLine (vf)))
+    die ("ONE find error: can't read object %" PRId64 "", i) ;
+  do
+    { if (t == vf->sortType)
+	{ *x = vf->sortField < 0 ? oneLen(vf) : oneInt(vf, vf->sortField) ;
+	  return true ;
+	}
+    } while ((t = oneReadLine (vf)) && t != vf->objectType && t != vf->groupType) ;
+  return false ;
+}
+
+I64 oneFindObject (OneFile *vf, char lineType, int field, I64 value)
+{ I64 lo, hi, mid, x ;
+
+  if (vf->isWrite || !vf->isBinary || !vf->isIndexIn || !vf->sortType
+      || vf->sortType != lineType || vf->sortField != (field < 0 ? -1 : field))
+    return -1 ;
+
+  lo = 0 ;
+  hi = vf->info[(int) vf->objectType]->given.count ;
+  while (lo < hi)
+    { mid = (lo + hi) / 2 ;
+      if (!sortValue (vf, mid, &x) || x < value) lo = mid + 1 ; else hi = mid ;
+    }
+
+  if (!oneGotoObject (vf, lo)) // past the last object: go to the end of the data
+    { if (fseeko (vf->f, vf->footOff-1, SEEK_SET) != 0)
+	die ("ONE find error: can't seek to the end of the data") ;
+      vf->object = lo ;
+    }
+  return lo ;
+}
+
+/***********************************************************************************
+ *
+ *   ONE_OPEN_WRITE_(NEW | FROM)
+ *
+ **********************************************************************************/
+
+OneFile *oneFileOpenWriteNew (const char *path, OneSchema *vs, char *fileType,
+                              bool isBinary, int nthreads)
+{ OneFile   *vf ;
+  FILE      *f ;
+  OneSchema *vs0 = vs ;
 
   if (strcmp (path, "-") == 0)
     f = stdout;
@@ -1659,6 +2643,11 @@ OneFile *oneFileOpenWriteFrom (const char *path, OneFile *vfIn, bool isBinary, i
 	v->codecBuf     = new (size, void);
       }
 
+  if (isBinary) // keep the zone maps of vfIn
+    for (i = 0 ; i < vfIn->nZoneMap ; ++i)
+      oneAddZoneMap (vf, vfIn->zoneMap[i].lineType, vfIn->zoneMap[i].field,
+		     vfIn->zoneMap[i].blockSize) ;
+
   return vf ;
 }
 
@@ -1722,7 +2711,7 @@ static bool addProvenance(OneFile *vf, OneProvenance *from, int n)
 
   if (n == 0)
     return (false);
-  assert (!vf->isHeaderOut) ;
+  assert (!vf->isHeaderOut || vf->isAppend) ; // an appended file has it in the footer
 
   l->accum.count += n;
 
@@ -1749,6 +2738,24 @@ static bool addProvenance(OneFile *vf, OneProvenance *from, int n)
 bool oneInheritProvenance(OneFile *vf, OneFile *source)
 { return (addProvenance(vf, source->provenance, source->info['!']->accum.count)); }
 
+bool oneInheritNewProvenance(OneFile *vf, OneFile *source)
+{ I64  i, j, nOld = vf->info['!']->accum.count;
+  bool isAdded = false;
+
+  for (i = 0; i < source->info['!']->accum.count; i++)
+    { OneProvenance *p = &source->provenance[i];
+      for (j = 0; j < nOld; j++)
+        { OneProvenance *q = &vf->provenance[j];
+          if (!strcmp (p->program, q->program) && !strcmp (p->version, q->version)
+              && !strcmp (p->command, q->command) && !strcmp (p->date, q->date))
+            break;
+        }
+      if (j == nOld)
+        isAdded |= addProvenance (vf, p, 1);
+    }
+  return isAdded;
+}
+
 bool oneAddProvenance(OneFile *vf, char *prog, char *version, char *command, char *date)
 { OneProvenance p;
 
@@ -1822,6 +2829,39 @@ bool oneAddDeferred (OneFile *vf, char *filename)
   return (addReference (vf, &ref, 1, true));
 }
 
+bool oneInheritCodecs (OneFile *vf, OneFile *source)
+{ int   i, j ;
+  bool  isAdded = false ;
+  char *codecBuf ;
+
+  assert (vf->isWrite && vf->share >= 0) ;
+
+  codecBuf = new (vcMaxSerialSize()+1, char) ;
+  for (i = 0 ; i < 128 ; ++i)
+    { OneInfo *ls = source->info[i], *li = vf->info[i] ;
+      if (!ls || !li || !ls->isUseListCodec || !ls->listCodec || ls->listCodec == DNAcodec)
+	continue ;
+      if (!li->listEltSize || li->fieldType[li->listField] != ls->fieldType[ls->listField])
+	continue ;
+      if (li->isUseListCodec) // keep a codec already installed or trained
+	continue ;
+      vcSerialize (ls->listCodec, codecBuf) ; // serialize round trip makes an owned copy
+      if (li->listCodec) vcDestroy (li->listCodec) ;
+      li->listCodec = vcDeserialize (codecBuf) ;
+      li->isUseListCodec = true ;
+      for (j = 1 ; j < vf->share ; ++j) // slaves share the master's codec, as after training
+	{ OneInfo *lj = vf[j].info[i] ;
+	  if (lj->listCodec && lj->listCodec != li->listCodec) vcDestroy (lj->listCodec) ;
+	  lj->listCodec = li->listCodec ;
+	  lj->isUseListCodec = true ;
+	}
+      isAdded = true ;
+    }
+  free (codecBuf) ;
+
+  return isAdded ;
+}
+
 /***********************************************************************************
  *
  *   ONE_WRITE_HEADER / FOOTER
@@ -1846,6 +2886,51 @@ static void writeInfoSpec (OneFile *vf, char ci)
     oneWriteComment (vf, vi->comment) ;
 }
 
+  // ascii count lines of the accumulated counts for every line type, zero padded to a fixed
+  //   width so that those written with the header can be overwritten at close
+
+#define COUNT_WIDTH 19 // digits in INT64_MAX
+
+static void writeReservedCounts (OneFile *vf)
+{ int      i ;
+  OneInfo *li ;
+
+  for (i = 'A' ; i <= 'Z'+1 ; i++)
+    { if (i == 'Z'+1)
+	{ if (vf->groupType) // NB group types are all lower case so > 'Z'+1
+	    i = vf->groupType ;
+	  else
+	    break ;
+	}
+      if (!(li = vf->info[i]))
+	continue ;
+      fprintf (vf->f, "\n# %c %0*" PRId64 "", i, COUNT_WIDTH, li->accum.count) ;
+      if (li->listEltSize)
+	{ fprintf (vf->f, "\n@ %c %0*" PRId64 "", i, COUNT_WIDTH, li->accum.max) ;
+	  fprintf (vf->f, "\n+ %c %0*" PRId64 "", i, COUNT_WIDTH, li->accum.total) ;
+	}
+      if (vf->groupType && i != vf->groupType)
+	{ fprintf (vf->f, "\n%% %c # %c %0*" PRId64 "", vf->groupType, i,
+		   COUNT_WIDTH, li->accum.groupCount) ;
+	  if (li->listEltSize)
+	    fprintf (vf->f, "\n%% %c + %c %0*" PRId64 "", vf->groupType, i,
+		     COUNT_WIDTH, li->accum.groupTotal) ;
+	}
+    }
+}
+
+bool oneReserveCounts (OneFile *vf)
+{
+  assert (vf->isWrite && vf->share >= 0 && !vf->isHeaderOut) ;
+
+  if (vf->isBinary)
+    return true ;
+  if (ftello (vf->f) < 0)
+    return false ;
+  vf->countsOff = -1 ;
+  return true ;
+}
+
 void oneWriteHeader (OneFile *vf)
 { int         i,n;
   OneInfo   *li;
@@ -1873,6 +2958,7 @@ void oneWriteHeader (OneFile *vf)
 	  vf->line += 1;
 	}
     }
+  vf->nHeaderProv = vf->info['!']->accum.count;
 
   fprintf (vf->f, "\n.") ; // always have a spacer after this
 
@@ -1901,6 +2987,12 @@ void oneWriteHeader (OneFile *vf)
     if (isalnum(i) && vf->info[i] && i != vf->objectType && i != vf->groupType)
       writeInfoSpec (vf, i) ;
 
+  // declared sort order of the objects
+  if (vf->sortType)
+    { fprintf (vf->f, "\n: %c %d", vf->sortType, vf->sortField) ;
+      vf->line += 1 ;
+    }
+
   // any header text on '.' lines
   if (vf->headerText)
     { OneHeaderText *t = vf->headerText ;
@@ -1915,6 +3007,12 @@ void oneWriteHeader (OneFile *vf)
     { fprintf (vf->f, "\n$ %d", vf->isBig);
       vf->line += 1;
     }
+  else if (vf->countsOff) // reserve count lines, to be filled in by oneFileClose()
+    { fprintf (vf->f, "\n.") ;
+      vf->countsOff = ftello (vf->f) ;
+      writeReservedCounts (vf) ;
+      fprintf (vf->f, "\n.") ;
+    }
   else             // write counts based on those supplied in input header
     { fprintf (vf->f, "\n.") ;
       bool isCountWritten = false ;
@@ -1956,16 +3054,145 @@ void oneWriteHeader (OneFile *vf)
   vf->isHeaderOut = true;
 }
 
+/***********************************************************************************
+ *
+ *   ZONE MAPS: per block min/max of selected fields, kept in the footer
+ *
+ **********************************************************************************/
+
+static OneZoneMap *zoneMapAdd (OneFile *vf, char t, int field, I64 blockSize)
+{ OneZoneMap *z = new0 (vf->nZoneMap+1, OneZoneMap) ;
+
+  if (vf->nZoneMap)
+    { memcpy (z, vf->zoneMap, vf->nZoneMap*sizeof(OneZoneMap)) ;
+      free (vf->zoneMap) ;
+    }
+  vf->zoneMap = z ;
+  z += vf->nZoneMap++ ;
+  z->lineType  = t ;
+  z->field     = field ;
+  z->blockSize = blockSize ;
+  return z ;
+}
+
+static OneZoneMap *zoneMapFind (OneFile *vf, char t, int field)
+{ int i ;
+
+  for (i = 0 ; i < vf->nZoneMap ; ++i)
+    if (vf->zoneMap[i].lineType == t && vf->zoneMap[i].field == field)
+      return &vf->zoneMap[i] ;
+  return NULL ;
+}
+
+static void zoneMapGrow (OneZoneMap *z, I64 n) // ensure blocks 0..n-1, new ones empty
+{
+  if (n > z->bufSize)
+    { I64  ns = n + (z->bufSize << 1) + 0x400 ;
+      I64 *nmin = new (ns, I64), *nmax = new (ns, I64) ;
+      if (z->bufSize)
+	{ memcpy (nmin, z->min, z->nBlock*sizeof(I64)) ; free (z->min) ;
+	  memcpy (nmax, z->max, z->nBlock*sizeof(I64)) ; free (z->max) ;
+	}
+      z->min = nmin ;
+      z->max = nmax ;
+      z->bufSize = ns ;
+    }
+  for ( ; z->nBlock < n ; ++z->nBlock)
+    { z->min[z->nBlock] = INT64_MAX ;
+      z->max[z->nBlock] = INT64_MIN ;
+    }
+}
+
+static void zoneMapUnion (OneZoneMap *z, I64 first, I64 last, I64 min, I64 max) // objects
+{ I64 b ;
+
+  if (min > max) return ; // empty
+  zoneMapGrow (z, last / z->blockSize + 1) ;
+  for (b = first / z->blockSize ; b <= last / z->blockSize ; ++b)
+    { if (min < z->min[b]) z->min[b] = min ;
+      if (max > z->max[b]) z->max[b] = max ;
+    }
+}
+
+  // merge into z the zone map s of nObj objects that start at object off of z, or if s
+  //   is NULL mark their blocks as holding anything
+
+static void zoneMapShift (OneZoneMap *z, OneZoneMap *s, I64 off, I64 nObj)
+{ I64 b, last ;
+
+  if (nObj <= 0) return ;
+  if (!s)
+    { zoneMapUnion (z, off, off+nObj-1, INT64_MIN, INT64_MAX) ;
+      return ;
+    }
+  for (b = 0 ; b < s->nBlock && b*s->blockSize < nObj ; ++b)
+    { last = (b+1)*s->blockSize < nObj ? (b+1)*s->blockSize : nObj ;
+      zoneMapUnion (z, off + b*s->blockSize, off + last - 1, s->min[b], s->max[b]) ;
+    }
+}
+
+static inline void zoneUpdate (OneFile *vf, char t, I64 listLen) // current object's block
+{ int i ;
+
+  if (vf->object == 0) return ;
+  for (i = 0 ; i < vf->nZoneMap ; ++i)
+    { OneZoneMap *z = &vf->zoneMap[i] ;
+      if (z->lineType == t)
+	{ I64 x = z->field < 0 ? listLen : vf->field[z->field].i ;
+	  zoneMapUnion (z, vf->object-1, vf->object-1, x, x) ;
+	}
+    }
+}
+
+bool oneAddZoneMap (OneFile *vf, char lineType, int field, I64 blockSize)
+{ OneInfo *li = vf->info[(int) lineType] ;
+  int      j ;
+
+  if (!vf->isWrite || !vf->isBinary || vf->share < 0)
+    die ("ONE zone map error: can only add zone maps to the master of a binary file being written") ;
+  if (vf->line > 0)
+    die ("ONE zone map error: zone maps must be added before writing data") ;
+  if (!li || !isalpha(lineType) || blockSize < 1)
+    return false ;
+  if (field < 0 ? !li->listEltSize : (field >= li->nField || li->fieldType[field] != oneINT))
+    return false ;
+  if (zoneMapFind (vf, lineType, field))
+    return true ;
+
+  for (j = 0 ; j < (vf->share ? vf->share : 1) ; ++j) // each thread keeps its own
+    zoneMapAdd (&vf[j], lineType, field, blockSize) ;
+  return true ;
+}
+
+I64 oneZoneRanges (OneFile *vf, char lineType, int field, I64 lo, I64 hi, I64 **ranges)
+{ OneZoneMap *z = zoneMapFind (vf, lineType, field) ;
+  I64         b, n, nObj, *r ;
+
+  if (!z) return -1 ;
+  nObj = vf->info[(int) vf->objectType]->given.count ;
+  r = new (2*z->nBlock+2, I64) ;
+  for (n = 0, b = 0 ; b < z->nBlock && b*z->blockSize < nObj ; ++b)
+    if (z->min[b] <= hi && z->max[b] >= lo)
+      { if (n && r[2*n-1] == b*z->blockSize) // extend the previous range
+	  --n ;
+	else
+	  r[2*n] = b*z->blockSize ;
+	r[2*n+1] = (b+1)*z->blockSize < nObj ? (b+1)*z->blockSize : nObj ;
+	++n ;
+      }
+  *ranges = r ;
+  return n ;
+}
+
 /***********************************************************************************
  *
  *   ONE_WRITE_LINE
  *
  **********************************************************************************/
 
-static int writeStringList (OneFile *vf, char t, int len, char *buf)
+static I64 writeStringList (OneFile *vf, char t, I64 len, char *buf)
 { OneInfo *li;
-  int       j, nByteWritten = 0;
-  I64       sLen, totLen;
+  I64       j, sLen, totLen, nByteWritten = 0;
 
   totLen = 0;
   for (j = 0; j < len; j++)
@@ -1983,6 +3210,77 @@ static int writeStringList (OneFile *vf, char t, int len, char *buf)
   return nByteWritten ;
 }
 
+  // the start of a binary line up to its list: indices, zone maps, sort check, type and fields
+
+static U8 writeBinaryHead (OneFile *vf, char t, I64 listLen, bool isCompressed)
+{ OneInfo *li = vf->info[(int) t];
+  U8       x;
+
+  if (!vf->isLastLineBinary)
+    { fputc ('\n', vf->f) ;
+      vf->byte = ftello (vf->f) ;
+    }
+
+  if (t == vf->objectType) // update index and increment object count
+    { OneInfo *lx = vf->info['&'];
+
+      if (vf->object >= lx->bufSize) // first ensure enough space
+	{ I64  ns = (lx->bufSize << 1) + 0x20000;
+	  I64 *nb = new (ns, I64);
+
+	  memcpy(nb, lx->buffer, lx->bufSize*sizeof(I64));
+	  free (lx->buffer);
+	  lx->buffer  = nb;
+	  lx->bufSize = ns;
+	}
+      ((I64 *) lx->buffer)[vf->object] = vf->byte;
+      assert (ftello (vf->f) == vf->byte) ;
+
+      ++vf->object ;
+    }
+  if (vf->nZoneMap)
+    zoneUpdate (vf, t, listLen) ;
+  if (t == vf->sortType && vf->object > vf->sortObject) // first such line of the object
+    { I64 x = vf->sortField < 0 ? listLen : vf->field[vf->sortField].i ;
+      if (vf->sortObject > 0 && x < vf->sortLast)
+	die ("ONE write error: object %" PRId64 " breaks the declared sort order on %c",
+	     vf->object-1, t) ;
+      vf->sortObject = vf->object ;
+      vf->sortLast   = x ;
+    }
+  if (t == vf->groupType)
+    { OneInfo *lx = vf->info['*'];
+
+      if (vf->group >= lx->bufSize) // still room for final value because one ahead here
+	{ I64  ns, *nb;
+
+	  ns = (lx->bufSize << 1) + 0x20000;
+	  nb = new (ns, I64);
+	  memcpy(nb, lx->buffer, lx->bufSize*sizeof(I64));
+	  free (lx->buffer);
+	  lx->buffer  = nb;
+	  lx->bufSize = ns;
+	}
+
+      ((I64 *) lx->buffer)[vf->group-1] = vf->object; // group # already advanced
+    }
+
+  // write the line character
+
+  x = li->binaryTypePack;   //  Binary line code + compression flags
+  if (isCompressed)
+    x |= 0x01;
+  fputc (x, vf->f);
+  ++vf->byte ;
+
+  // write the fields
+
+  if (li->nField > 0)
+    vf->byte += writeCompressedFields (vf->f, vf->field, li) ;
+
+  return x;
+}
+
 // process is to fill fields by assigning to macros, then call - list contents are in buf
 // NB adds '\n' before writing line not after, so user fprintf() can add extra material
 // first call will write initial header, allowing space for count sizes to expand on close
@@ -1998,6 +3296,7 @@ void oneWriteLine (OneFile *vf, char t, I64 listLen, void *listBuf)
 
   li = vf->info[(int) t];
   assert (li) ;
+  assert (!vf->streamType) ;
 
   vf->line  += 1;
   li->accum.count += 1;
@@ -2012,59 +3311,7 @@ void oneWriteLine (OneFile *vf, char t, I64 listLen, void *listBuf)
   // BINARY - block write and optionally compress
 
   if (vf->isBinary)
-    { U8  x;
-
-      if (!vf->isLastLineBinary)
-	{ fputc ('\n', vf->f) ;
-	  vf->byte = ftello (vf->f) ;
-	}
-
-      if (t == vf->objectType) // update index and increment object count
-        { OneInfo *lx = vf->info['&'];
-
-          if (vf->object >= lx->bufSize) // first ensure enough space
-            { I64  ns = (lx->bufSize << 1) + 0x20000;
-              I64 *nb = new (ns, I64);
-	      
-              memcpy(nb, lx->buffer, lx->bufSize*sizeof(I64));
-              free (lx->buffer);
-              lx->buffer  = nb;
-              lx->bufSize = ns;
-            }
-          ((I64 *) lx->buffer)[vf->object] = vf->byte;
-          assert (ftello (vf->f) == vf->byte) ;
-
-          ++vf->object ;
-        }
-      if (t == vf->groupType)
-        { OneInfo *lx = vf->info['*'];
-	  
-          if (vf->group >= lx->bufSize) // still room for final value because one ahead here
-            { I64  ns, *nb;
-
-              ns = (lx->bufSize << 1) + 0x20000;
-              nb = new (ns, I64);
-              memcpy(nb, lx->buffer, lx->bufSize*sizeof(I64));
-              free (lx->buffer);
-              lx->buffer  = nb;
-              lx->bufSize = ns;
-            }
-       
-          ((I64 *) lx->buffer)[vf->group-1] = vf->object; // group # already advanced
-        }
-
-      // write the line character
-      
-      x = li->binaryTypePack;   //  Binary line code + compression flags
-      if (li->isUseListCodec)
-        x |= 0x01;
-      fputc (x, vf->f);
-      ++vf->byte ;
-
-      // write the fields
-
-      if (li->nField > 0)
-	vf->byte += writeCompressedFields (vf->f, vf->field, li) ;
+    { U8  x = writeBinaryHead (vf, t, listLen, li->isUseListCodec);
 
       // write the list if there is one
 
@@ -2196,9 +3443,9 @@ void oneWriteLine (OneFile *vf, char t, I64 listLen, void *listBuf)
 
             fprintf (vf->f, " %" PRId64 "", listLen);
             if (li->fieldType[i] == oneSTRING || li->fieldType[i] == oneDNA)
-              { if (listLen > INT_MAX)
-                  die ("ONE write error: string length %" PRId64 " > current max %d", listLen, INT_MAX);
-                fprintf (vf->f, " %.*s", (int) listLen, (char *) listBuf);
+              { fputc (' ', vf->f);
+                if (listLen && fwrite (listBuf, listLen, 1, vf->f) != 1)
+                  die ("ONE write error: failed to write string of length %" PRId64 "", listLen);
               }
             else if (li->fieldType[i] == oneINT_LIST)
               { I64 *b = (I64 *) listBuf;
@@ -2226,6 +3473,136 @@ void oneWriteComment (OneFile *vf, char *comment)
     fprintf (vf->f, " %s", comment) ;
 }
 
+void oneWriteListBegin (OneFile *vf, char t, I64 listLen)
+{ OneInfo *li = vf->info[(int) t];
+  int      i;
+
+  assert (vf->isWrite) ;
+  assert (!vf->isFinal) ;
+  assert (listLen >= 0) ;
+
+  if (!isStreamable (li))
+    die ("ONE write error: the list of line type %c can't be written in chunks", t);
+  if (vf->streamType)
+    die ("ONE write error: list of line type %c not ended", vf->streamType);
+
+  vf->line  += 1;
+  li->accum.count += 1;
+  if (t == vf->groupType) updateGroupCount(vf, true);
+  vf->field[li->listField].len = listLen ;
+  li->accum.total += listLen;
+  if (listLen > li->accum.max)
+    li->accum.max = listLen;
+
+  vf->streamType   = t;
+  vf->streamLeft   = listLen;
+  vf->nStreamCarry = 0;
+
+  if (vf->isBinary)
+    { bool isPacked = (li->isUseListCodec && li->listCodec == DNAcodec);
+
+      writeBinaryHead (vf, t, listLen, isPacked);
+      if (isPacked && listLen > 0) // the number of bits is known in advance
+	{ vf->byte += ltfWrite (2*listLen, vf->f) ;
+	  streamCodecBuf (vf) ;
+	}
+      vf->streamMode = isPacked ? STREAM_PACKED : STREAM_RAW ;
+    }
+  else
+    { if (!vf->isLastLineBinary)
+	fputc ('\n', vf->f);
+      fputc (t, vf->f);
+      for (i = 0; i < li->listField; i++) // the list is the last field
+        switch (li->fieldType[i])
+	  {
+	  case oneINT:
+            fprintf (vf->f, " %" PRId64 "", vf->field[i].i);
+            break;
+          case oneREAL:
+            fprintf (vf->f, " %f", vf->field[i].r);
+            break;
+          case oneCHAR:
+            fprintf (vf->f, " %c", vf->field[i].c);
+            break;
+	  default:
+	    die ("ONE write error: line type %c has more than one list", t);
+	  }
+      fprintf (vf->f, " %" PRId64 "", listLen);
+      if (li->fieldType[li->listField] != oneREAL_LIST)
+	fputc (' ', vf->f);
+      vf->streamMode = STREAM_ASCII ;
+      vf->isLastLineBinary = false;
+    }
+}
+
+static void writePackedDNA (OneFile *vf, I64 n, char *s) // n is a multiple of 4 unless last
+{ I64 m, nBytes;
+
+  for ( ; n > 0 ; n -= m, s += m)
+    { m = (n > 4*STREAM_BYTES) ? 4*STREAM_BYTES : n;
+      nBytes = (Compress_DNA (m, s, vf->codecBuf) + 7) >> 3;
+      if (fwrite (vf->codecBuf, nBytes, 1, vf->f) != 1)
+	die ("ONE write error: failed to write compressed DNA");
+      vf->byte += nBytes;
+    }
+}
+
+void oneWriteListChunk (OneFile *vf, I64 n, void *buf)
+{ OneInfo *li = vf->info[(int) vf->streamType];
+  char    *s = (char *) buf;
+  I64      j, m;
+
+  if (!vf->streamType)
+    die ("ONE write error: list chunk without oneWriteListBegin()");
+  if (n > vf->streamLeft)
+    die ("ONE write error: list chunks of line type %c exceed the length given", vf->streamType);
+  vf->streamLeft -= n;
+
+  switch (vf->streamMode)
+    {
+    case STREAM_RAW:
+      if (n && fwrite (buf, li->listEltSize, n, vf->f) != (size_t) n)
+	die ("ONE write error: failed to write list chunk of %" PRId64 "", n);
+      vf->byte += n * li->listEltSize;
+      break;
+    case STREAM_PACKED:   // pack whole bytes of 4 bases, carrying the rest to the next chunk
+      if (vf->nStreamCarry)
+	{ m = 4 - vf->nStreamCarry;
+	  if (m > n) m = n;
+	  memcpy (vf->streamCarry + vf->nStreamCarry, s, m);
+	  vf->nStreamCarry += m;
+	  s += m;
+	  n -= m;
+	  if (vf->nStreamCarry < 4 && (n > 0 || vf->streamLeft > 0))
+	    break;
+	  writePackedDNA (vf, vf->nStreamCarry, vf->streamCarry);
+	  vf->nStreamCarry = 0;
+	}
+      m = (vf->streamLeft > 0) ? (n & ~((I64) 3)) : n;
+      writePackedDNA (vf, m, s);
+      vf->nStreamCarry = n - m;
+      memcpy (vf->streamCarry, s + m, n - m);
+      break;
+    case STREAM_ASCII:
+      if (li->fieldType[li->listField] == oneREAL_LIST)
+	for (j = 0; j < n; ++j)
+	  fprintf (vf->f, " %f", ((double *) buf)[j]);
+      else if (n && fwrite (buf, n, 1, vf->f) != 1)
+	die ("ONE write error: failed to write string chunk of %" PRId64 "", n);
+      break;
+    }
+}
+
+void oneWriteListEnd (OneFile *vf)
+{ if (!vf->streamType)
+    die ("ONE write error: oneWriteListEnd() without oneWriteListBegin()");
+  if (vf->streamLeft)
+    die ("ONE write error: list of line type %c ended %" PRId64 " elements short",
+	 vf->streamType, vf->streamLeft);
+  vf->isLastLineBinary = vf->isBinary;
+  vf->streamType = 0;
+}
+
 /***********************************************************************************
  *
  *    MERGING, FOOTER HANDLING, AND CLOSE
@@ -2238,11 +3615,23 @@ static void oneWriteFooter (OneFile *vf)
   OneInfo *li;
   char    *codecBuf ;
   
+  if (!vf->isLastLineBinary) // no data, so the newline from oneFileClose() ended the header
+    { fputc ('\n', vf->f) ;  // and this one ends the empty data
+      vf->isLastLineBinary = true ;
+    }
   footOff = ftello (vf->f);
   if (footOff < 0)
     die ("ONE write error: failed footer ftell");
 
-  //  first the per-linetype information
+  //  first any provenance of appended data, which is read after that of the header
+  for (i = vf->nHeaderProv; i < vf->info['!']->accum.count; i++)
+    { OneProvenance *p = &vf->provenance[i];
+      fprintf (vf->f, "! 4 %lu %s %lu %s %lu %s %lu %s\n",
+	       strlen(p->program), p->program, strlen(p->version), p->version,
+	       strlen(p->command), p->command, strlen(p->date), p->date);
+    }
+
+  //  then the per-linetype information
   codecBuf = new (vcMaxSerialSize()+1, char) ; // +1 for added up unused 0-terminator
   for (i = 'A'; i <= 'Z'+1 ; i++)
     { if (i == 'Z'+1)
@@ -2288,6 +3677,23 @@ static void oneWriteFooter (OneFile *vf)
       oneWriteLine (vf, '*', vf->group+1, NULL); // number of groups in file + 1 = length of index
     }
 
+  for (i = 0; i < vf->nZoneMap; i++) // min and max interleaved, one pair per block
+    { OneZoneMap *z = &vf->zoneMap[i];
+      I64         b, *x;
+
+      zoneMapGrow (z, (vf->object + z->blockSize - 1) / z->blockSize);
+      x = new (2*z->nBlock+1, I64); // +1 in case there are no blocks
+      for (b = 0; b < z->nBlock; b++)
+        { x[2*b]   = z->min[b];
+          x[2*b+1] = z->max[b];
+        }
+      oneChar(vf,0) = z->lineType;
+      oneInt(vf,1)  = z->field;
+      oneInt(vf,2)  = z->blockSize;
+      oneWriteLine (vf, '=', 2*z->nBlock, x);
+      free (x);
+    }
+
   fprintf (vf->f, "^\n"); // end of footer marker
 
   if (fwrite (&footOff, sizeof(off_t), 1, vf->f) != 1)
@@ -2396,6 +3802,17 @@ void oneFinalizeCounts(OneFile *vf)
       vf->group = ns;
     }
 
+  //  Merge the zone maps of the slaves, whose objects follow those of the parts before them
+
+  { I64 off = vf[0].object;
+
+    for (j = 1; j < len; j++)
+      { for (i = 0; i < vf->nZoneMap; i++)
+          zoneMapShift (&vf->zoneMap[i], &vf[j].zoneMap[i], off, vf[j].object);
+        off += vf[j].object;
+      }
+  }
+
   //  Stitch the object index together
 
   { int  ns;
@@ -2455,13 +3872,841 @@ void oneFileClose (OneFile *vf)
           free(buf);
         }
       fputc ('\n', vf->f);  // end of file if ascii, end of data marker if binary
+      if (vf->countsOff > 0) // fill in the count lines reserved in the ascii header
+	{ if (fseeko (vf->f, vf->countsOff, SEEK_SET) != 0)
+	    die ("ONE write error: can't seek back to the header to write counts");
+	  writeReservedCounts (vf);
+	}
       if (vf->isBinary) // write the footer
         oneWriteFooter (vf);
     }
+  else if (vf->cat)
+    catDestroy (vf);
   
   oneFileDestroy (vf);
 }
 
+/***********************************************************************************
+ *
+ *   ONE_FILE_CAT: append the data of a binary file to a binary file being written
+ *
+ **********************************************************************************/
+
+  // The data section of source is copied byte for byte when every line type has the same
+  //   binary code in both files and every list codec of source is identical to that of vf,
+  //   else each line is decoded and re-encoded.  Counts are merged from the source footer
+  //   and its object and group indices appended, shifted to their new offsets.
+
+static bool isRawCopyable (OneFile *vf, OneFile *source)
+{ int   i ;
+  bool  isRaw = true ;
+  char *bufS, *bufV ;
+
+  bufS = new (vcMaxSerialSize()+1, char) ;
+  bufV = new (vcMaxSerialSize()+1, char) ;
+  for (i = 0 ; i < 128 && isRaw ; ++i)
+    { OneInfo *ls = source->info[i], *li = vf->info[i] ;
+      if (!ls)
+	continue ;
+      if (!li || li->binaryTypePack != ls->binaryTypePack)
+	isRaw = false ;
+      else if (ls->isUseListCodec && ls->listCodec != DNAcodec)
+	{ int n ;
+	  if (!li->isUseListCodec || li->listCodec == DNAcodec)
+	    isRaw = false ;
+	  else if ((n = vcSerialize (ls->listCodec, bufS)) != vcSerialize (li->listCodec, bufV)
+		   || memcmp (bufS, bufV, n))
+	    isRaw = false ;
+	}
+    }
+  free (bufS) ;
+  free (bufV) ;
+
+  return isRaw ;
+}
+
+static void *growIndex (OneInfo *li, I64 n) // ensure the I64 index buffer holds n entries
+{
+  if (n > li->bufSize)
+    { I64  ns = n + (li->bufSize << 1) + 0x20000;
+      I64 *nb = new (ns, I64);
+
+      if (li->buffer)
+	{ memcpy (nb, li->buffer, li->bufSize*sizeof(I64));
+	  free (li->buffer);
+	}
+      li->buffer  = nb;
+      li->bufSize = ns;
+    }
+  return li->buffer ;
+}
+
+static void countLines (OneFile *vf, char stop, I64 *count, I64 *total) // up to line type stop
+{ char t ;
+
+  while ((t = oneReadLine (vf)) && t != stop)
+    if (isupper(t))
+      { count[(int)t] += 1 ;
+	if (vf->info[(int)t]->listEltSize)
+	  total[(int)t] += oneLen(vf) ;
+      }
+}
+
+static void checkCatSource (OneFile *vf, OneFile *source)
+{ int i ;
+
+  assert (vf->isWrite && vf->isBinary && vf->share == 0 && vf->isHeaderOut && !vf->isFinal) ;
+
+  if (source->isWrite || !source->isBinary || source->share < 0 || source->cat)
+    die ("ONE cat error: source must be a binary file open for reading") ;
+  if (strcmp (source->fileType, vf->fileType))
+    die ("ONE cat error: file type %s differs from %s", source->fileType, vf->fileType) ;
+  for (i = 0 ; i < 128 ; ++i)
+    { OneInfo *ls = source->info[i], *li = vf->info[i] ;
+      if (ls && isalpha(i) && ls->given.count)
+	{ if (!li || li->nField != ls->nField
+	      || memcmp (li->fieldType, ls->fieldType, li->nField*sizeof(OneType)))
+	    die ("ONE cat error: line type %c differs between schemas", i) ;
+	}
+    }
+}
+
+static void seekSource (OneFile *source, off_t pos, I64 object) // pos is the start of object
+{ I64 *groupIndex, nGroup ;
+
+  if (fseeko (source->f, pos, SEEK_SET))
+    die ("ONE cat error: can't seek in source data") ;
+  source->object = object ;
+  source->group  = 0 ;                          // number of groups started before object
+  if (source->groupType)
+    { I64 lo = 0, hi, mid ;
+      groupIndex = (I64 *) source->info['*']->buffer ;
+      nGroup     = source->info[(int) source->groupType]->given.count ;
+      for (hi = nGroup ; lo < hi ; )
+	{ mid = (lo + hi) / 2 ;
+	  if (groupIndex[mid] < object) lo = mid + 1 ; else hi = mid ;
+	}
+      source->group = lo ;
+    }
+}
+
+static void copyLine (OneFile *vf, OneFile *source, char t) // decode and re-encode
+{ OneInfo *ls = source->info[(int)t] ;
+  char    *s ;
+
+  memcpy (vf->field, source->field, ls->nField*sizeof(OneField)) ;
+  oneWriteLine (vf, t, oneLen(source), ls->listEltSize ? oneList(source) : NULL) ;
+  if ((s = oneReadComment (source)))
+    oneWriteComment (vf, s) ;
+}
+
+static void copyLines (OneFile *vf, OneFile *source, off_t end)
+{ char t ;
+
+  while (ftello (source->f) < end && (t = oneReadLine (source)))
+    copyLine (vf, source, t) ;
+}
+
+static void startRawData (OneFile *vf)
+{
+  if (!vf->isLastLineBinary)
+    { fputc ('\n', vf->f) ;
+      vf->isLastLineBinary = true ;
+    }
+  fflush (vf->f) ;
+  vf->byte = ftello (vf->f) ;
+}
+
+static void copyBytes (OneFile *vf, OneFile *source, off_t start, off_t end, char *buf)
+{ I64   len, n ;
+
+  if (fseeko (source->f, start, SEEK_SET))
+    die ("ONE cat error: can't seek in source data") ;
+  for (len = end - start ; len > 0 ; len -= n)
+    { n = len < (1 << 20) ? len : (1 << 20) ;
+      if (fread (buf, 1, n, source->f) != (size_t) n)
+	die ("ONE cat error: failed to read data section") ;
+      if (fwrite (buf, 1, n, vf->f) != (size_t) n)
+	die ("ONE cat error: failed to write data section") ;
+      vf->byte += n ;
+    }
+}
+
+static void countRawLine (OneFile *vf, OneFile *source, char t, off_t pos) // pos in vf
+{ OneInfo *li = vf->info[(int)t] ;
+
+  vf->line += 1 ;
+  li->accum.count += 1 ;
+  if (t == vf->groupType)
+    { updateGroupCount (vf, true) ;
+      ((I64 *) growIndex (vf->info['*'], vf->group+1))[vf->group-1] = vf->object ;
+    }
+  if (t == vf->objectType)
+    { ((I64 *) growIndex (vf->info['&'], vf->object+1))[vf->object] = pos ;
+      ++vf->object ;
+    }
+  if (vf->nZoneMap)
+    { memcpy (vf->field, source->field, li->nField*sizeof(OneField)) ;
+      zoneUpdate (vf, t, oneLen(source)) ;
+    }
+  if (li->listEltSize && oneLen(source) > 0)
+    { li->accum.total += oneLen(source) ;
+      if (oneLen(source) > li->accum.max)
+	li->accum.max = oneLen(source) ;
+    }
+}
+
+bool oneFileCat (OneFile *vf, OneFile *source)
+{ int  i ;
+  I64  dataEnd = source->footOff - 1 ; // data ends with a blank line
+
+  checkCatSource (vf, source) ;
+
+  if (!isRawCopyable (vf, source))
+    { seekSource (source, source->dataStart, 0) ;
+      copyLines (vf, source, dataEnd) ;
+      return false ;
+    }
+
+  // lines of source before its first group join the current group of vf: count them into
+  //   it and close that group, so that the source groups are counted on their own.  If
+  //   source has no groups then all its lines join the current group, which stays open.
+
+  I64  preCount[128], preTotal[128], lastCount[128], lastTotal[128] ;
+  I64  nGroup = vf->groupType ? source->info[(int) vf->groupType]->given.count : 0 ;
+
+  memset (preCount, 0, sizeof(preCount)) ;
+  memset (preTotal, 0, sizeof(preTotal)) ;
+  if (nGroup)
+    { if (vf->inGroup)
+	{ seekSource (source, source->dataStart, 0) ;
+	  countLines (source, vf->groupType, preCount, preTotal) ;
+	  for (i = 'A' ; i <= 'Z' ; ++i)
+	    if (preCount[i])
+	      { vf->info[i]->accum.count += preCount[i] ;
+		vf->info[i]->accum.total += preTotal[i] ;
+	      }
+	}
+      updateGroupCount (vf, false) ;
+      memset (lastCount, 0, sizeof(lastCount)) ;   // and the size of the last group
+      memset (lastTotal, 0, sizeof(lastTotal)) ;
+      if (oneGotoGroup (source, nGroup-1)) // else the last group is empty
+	countLines (source, 0, lastCount, lastTotal) ;
+    }
+
+  startRawData (vf) ;
+
+  // append the indices, then the data, then merge the counts
+
+  { I64  nObj = source->info[(int) source->objectType]->given.count ;
+    I64  shift = vf->byte - source->dataStart ;
+    I64 *si = (I64 *) source->info['&']->buffer ;
+    I64 *vi = growIndex (vf->info['&'], vf->object + nObj) ;
+
+    for (i = 0 ; i < nObj ; ++i)
+      vi[vf->object + i] = si[i] + shift ;
+
+    if (nGroup)
+      { I64 *sg = (I64 *) source->info['*']->buffer ;
+	I64 *vg = growIndex (vf->info['*'], vf->group + nGroup + 1) ;
+	for (i = 0 ; i < nGroup ; ++i)
+	  vg[vf->group + i] = sg[i] + vf->object ;
+	vf->group += nGroup ;
+	vf->inGroup = true ;
+      }
+    for (i = 0 ; i < vf->nZoneMap ; ++i) // blocks unknown if source lacks the zone map
+      { OneZoneMap *z = &vf->zoneMap[i] ;
+	zoneMapShift (z, zoneMapFind (source, z->lineType, z->field), vf->object, nObj) ;
+      }
+    vf->object += nObj ;
+  }
+
+  { char *buf = new (1 << 20, char) ;
+    copyBytes (vf, source, source->dataStart, dataEnd, buf) ;
+    free (buf) ;
+  }
+
+  for (i = 0 ; i < 128 ; ++i)
+    { OneInfo *ls = source->info[i], *li = vf->info[i] ;
+      if (!ls || !isalpha(i) || !ls->given.count)
+	continue ;
+      li->accum.count += ls->given.count - preCount[i] ;
+      li->accum.total += ls->given.total - preTotal[i] ;
+      if (ls->given.max > li->accum.max) li->accum.max = ls->given.max ;
+      if (ls->given.groupCount > li->accum.groupCount) li->accum.groupCount = ls->given.groupCount ;
+      if (ls->given.groupTotal > li->accum.groupTotal) li->accum.groupTotal = ls->given.groupTotal ;
+      if (nGroup)  // the last group of source stays open
+	{ li->gCount = li->accum.count - lastCount[i] ;
+	  li->gTotal = li->accum.total - lastTotal[i] ;
+	}
+      vf->line += ls->given.count ;
+    }
+
+  return true ;
+}
+
+  // The start of object i for cutting is the first object or group line after object i-1,
+  //   so that lines following object i-1 stay with it and a group line goes with the
+  //   objects it introduces.
+
+static off_t objectStart (OneFile *source, I64 i)
+{ I64   nObj = source->info[(int) source->objectType]->given.count ;
+  off_t pos ;
+  char  t ;
+
+  if (i <= 0) return source->dataStart ;
+  if (i >= nObj) return source->footOff - 1 ;
+  seekSource (source, ((I64 *) source->info['&']->buffer)[i-1], i-1) ;
+  oneReadLine (source) ; // the object line of object i-1
+  while (true)
+    { pos = ftello (source->f) ;
+      t = oneReadLine (source) ;
+      if (!t || t == source->objectType || t == source->groupType)
+	return pos ;
+    }
+}
+
+bool oneFileCatRange (OneFile *vf, OneFile *source, I64 start, I64 end)
+{ off_t startPos, endPos, pos ;
+  I64   shift ;
+  char  t ;
+
+  checkCatSource (vf, source) ;
+
+  startPos = objectStart (source, start) ;
+  endPos   = objectStart (source, end) ;
+  if (endPos <= startPos)
+    return isRawCopyable (vf, source) ;
+
+  if (!isRawCopyable (vf, source))
+    { seekSource (source, startPos, start) ;
+      copyLines (vf, source, endPos) ;
+      return false ;
+    }
+
+  // the counts and indices of a range are not in the footer, so scan its lines, which
+  //   does not need compressed lists to be decoded, and then copy its bytes
+
+  startRawData (vf) ;
+  shift = vf->byte - startPos ;
+  seekSource (source, startPos, start) ;
+  while ((pos = ftello (source->f)) < endPos && (t = oneReadLine (source)))
+    countRawLine (vf, source, t, pos + shift) ;
+  { char *buf = new (1 << 20, char) ;
+    copyBytes (vf, source, startPos, endPos, buf) ;
+    free (buf) ;
+  }
+
+  return true ;
+}
+
+bool oneFileCatObjects (OneFile *vf, OneFile *source, I64 *objects, I64 n)
+{ I64   i, k, nObj ;
+  off_t start, pos ;
+  char  t, *buf ;
+  bool  isRaw ;
+
+  checkCatSource (vf, source) ;
+  isRaw = isRawCopyable (vf, source) ;
+  nObj  = source->info[(int) source->objectType]->given.count ;
+  if (isRaw)
+    startRawData (vf) ;
+  buf = new (1 << 20, char) ;
+
+  for (k = 0 ; k < n ; ++k)
+    { i = objects[k] ;
+      if (i < 0 || i >= nObj)
+	die ("ONE cat error: object %" PRId64 " out of range", i) ;
+      start = ((I64 *) source->info['&']->buffer)[i] ;
+      seekSource (source, start, i) ;
+      if (!isRaw)     // re-encode lines up to the next object or group line
+	{ t = oneReadLine (source) ;
+	  do copyLine (vf, source, t) ;
+	  while ((t = oneReadLine (source)) && t != source->objectType && t != source->groupType) ;
+	  continue ;
+	}
+      pos = start ;      // scan to find the end and count the lines, then copy
+      while ((t = oneReadLine (source)))
+	{ if (pos > start && (t == source->objectType || t == source->groupType))
+	    break ;
+	  countRawLine (vf, source, t, vf->byte + (pos - start)) ;
+	  pos = ftello (source->f) ;
+	}
+      copyBytes (vf, source, start, pos, buf) ;
+    }
+
+  free (buf) ;
+  return isRaw ;
+}
+
+/***********************************************************************************
+ *
+ *   ONE_FILE_OPEN_APPEND: add data to the end of an existing binary file
+ *
+ **********************************************************************************/
+
+  // The file is read to its footer, then opened for writing as by oneFileOpenWriteFrom(), with
+  //   the counts, indices, zone maps and codecs of the footer carried over as if its data had
+  //   just been written, and the last group still open.  It is then cut at the end of its
+  //   data, and oneFileClose() writes the merged footer.  The header is left as it is.
+
+OneFile *oneFileOpenAppend (const char *path, int nthreads)
+{ OneFile *vfIn, *vf ;
+  FILE    *f ;
+  I64      i, nObj, nGroup, dataEnd ;
+
+  if (!strcmp (path, "-") || !(vfIn = oneFileOpenRead (path, 0, 0, 1)))
+    return NULL ;
+  if (!vfIn->isBinary || !(f = fopen (path, "r+")))
+    { if (!vfIn->isBinary)
+	fprintf (stderr, "ONE file error %s: can only append to a binary file\n", path) ;
+      oneFileClose (vfIn) ;
+      return NULL ;
+    }
+
+  vf = oneFileOpenWriteFrom ("/dev/null", vfIn, true, nthreads) ; // f replaces /dev/null below
+  if (!vf)
+    { fclose (f) ;
+      oneFileClose (vfIn) ;
+      return NULL ;
+    }
+  oneInheritCodecs (vf, vfIn) ;
+  if (vfIn->sortType)
+    oneSetSorted (vf, vfIn->sortType, vfIn->sortField) ;
+
+  for (i = 'A' ; i <= 'z' ; ++i)
+    if (isalpha(i) && vf->info[i])
+      vf->info[i]->accum = vfIn->info[i]->given ;
+
+  nObj = vfIn->info[(int) vfIn->objectType]->given.count ;
+  if (nObj)
+    memcpy (growIndex (vf->info['&'], nObj), vfIn->info['&']->buffer, nObj*sizeof(I64)) ;
+  vf->object = nObj ;
+
+  for (i = 0 ; i < vf->nZoneMap ; ++i) // oneFileOpenWriteFrom() made them in the same order
+    zoneMapShift (&vf->zoneMap[i], &vfIn->zoneMap[i], 0, nObj) ;
+
+  nGroup = vf->groupType ? vfIn->info[(int) vf->groupType]->given.count : 0 ;
+  if (nGroup) // the last group stays open: find how many of each line type it holds already
+    { I64 lastCount[128], lastTotal[128] ;
+      memcpy (growIndex (vf->info['*'], nGroup+1), vfIn->info['*']->buffer, nGroup*sizeof(I64)) ;
+      vf->group   = nGroup ;
+      vf->inGroup = true ;
+      memset (lastCount, 0, sizeof(lastCount)) ;
+      memset (lastTotal, 0, sizeof(lastTotal)) ;
+      if (oneGotoGroup (vfIn, nGroup-1))
+	countLines (vfIn, 0, lastCount, lastTotal) ;
+      for (i = 'A' ; i <= 'Z' ; ++i)
+	if (vf->info[i])
+	  { vf->info[i]->gCount = vf->info[i]->accum.count - lastCount[i] ;
+	    vf->info[i]->gTotal = vf->info[i]->accum.total - lastTotal[i] ;
+	  }
+    }
+
+  if (vf->sortType && nObj && oneGotoObject (vfIn, nObj-1)) // objects added must follow the last
+    { char t ;
+      while ((t = oneReadLine (vfIn)) && t != vf->sortType) ;
+      if (t == vf->sortType)
+	{ vf->sortObject = nObj ;
+	  vf->sortLast   = vf->sortField < 0 ? oneLen(vfIn) : oneInt(vfIn, vf->sortField) ;
+	}
+    }
+
+  // now cut off the footer and the blank line that ends the data, and write from there
+
+  dataEnd = vfIn->footOff - 1 ;
+  if (ftruncate (fileno (f), dataEnd) != 0 || fseeko (f, dataEnd, SEEK_SET) != 0)
+    die ("ONE file error: can't cut the footer from %s to append to it", path) ;
+  fclose (vf->f) ;
+  vf->f                = f ;
+  vf->byte             = dataEnd ;
+  vf->isLastLineBinary = true ; // so no newline is added before the first line
+  vf->isHeaderOut      = true ;
+  vf->isAppend         = true ;
+  vf->nHeaderProv      = vfIn->nHeaderProv ;
+  vf->line             = vfIn->line ;
+
+  oneFileClose (vfIn) ;
+  return vf ;
+}
+
+/***********************************************************************************
+ *
+ *   ONE_FILE_PARTITION: contiguous slices of a binary file for separate processes
+ *
+ **********************************************************************************/
+
+  // Cuts are objects, or group starts if isKeepGroups, weighted by their object number or
+  //   the byte offset of their object line.  A partition's bytes start at the end of the
+  //   previous object, so take in any group line before its first object.
+
+static I64 groupsBefore (OneFile *vf, I64 i) // number of groups starting before object i
+{ I64 *groupIndex = (I64 *) vf->info['*']->buffer ;
+  I64  lo = 0, hi = vf->info[(int) vf->groupType]->given.count, mid ;
+
+  while (lo < hi)
+    { mid = (lo + hi) / 2 ;
+      if (groupIndex[mid] < i) lo = mid + 1 ; else hi = mid ;
+    }
+  return lo ;
+}
+
+static I64 partitionCut (OneFile *vf, I64 target, bool isBytes, bool isKeepGroups)
+{ I64 *objIndex = (I64 *) vf->info['&']->buffer ;
+  I64 *groupIndex = isKeepGroups ? (I64 *) vf->info['*']->buffer : 0 ;
+  I64  nObj = vf->info[(int) vf->objectType]->given.count ;
+  I64  nGroup = isKeepGroups ? vf->info[(int) vf->groupType]->given.count : 0 ;
+  I64  lo = 0, hi = isKeepGroups ? nGroup : nObj, mid, w ;
+
+  while (lo < hi) // first cut point of weight >= target
+    { mid = (lo + hi) / 2 ;
+      w = isKeepGroups ? groupIndex[mid] : mid ;
+      if (isBytes) w = (w < nObj) ? objIndex[w] : vf->footOff - 1 ;
+      if (w < target) lo = mid + 1 ; else hi = mid ;
+    }
+  if (!isKeepGroups) return lo ;
+  return (lo < nGroup) ? groupIndex[lo] : nObj ;
+}
+
+static bool partitionCodec (OneFile *vf, int t) // lines of type t are read with a codec
+{ OneInfo *li = vf->info[t] ;
+
+  return li && li->given.count && li->listCodec
+    && (li->listCodec == DNAcodec || li->isUseListCodec) ;
+}
+
+OnePartition *onePartitions (OneFile *vf, int nPart, OneBalance by, bool isKeepGroups)
+{ I64 nObj, nGroup, dataEnd, target, *cut ;
+  OnePartition *p ;
+  int i, n ;
+
+  if (!vf->isBinary || !vf->isIndexIn || !vf->objectType || vf->cat || nPart < 1)
+    return NULL ;
+  nObj    = vf->info[(int) vf->objectType]->given.count ;
+  nGroup  = vf->groupType ? vf->info[(int) vf->groupType]->given.count : 0 ;
+  dataEnd = vf->footOff - 1 ;
+  if (by == oneGROUPS) isKeepGroups = true ;
+  if (!nGroup)
+    { isKeepGroups = false ;
+      if (by == oneGROUPS) by = oneOBJECTS ;
+    }
+
+  cut = new (nPart+1, I64) ;
+  cut[0] = 0 ;
+  cut[nPart] = nObj ;
+  for (i = 1 ; i < nPart ; ++i)
+    { if (by == oneBYTES)
+	target = vf->dataStart + (I64) ((dataEnd - vf->dataStart) * (double) i / nPart) ;
+      else if (by == oneOBJECTS)
+	target = (I64) (nObj * (double) i / nPart) ;
+      else
+	target = ((I64 *) vf->info['*']->buffer)[(I64) (nGroup * (double) i / nPart)] ;
+      cut[i] = partitionCut (vf, target, by == oneBYTES, isKeepGroups) ;
+      if (cut[i] < cut[i-1]) cut[i] = cut[i-1] ;
+    }
+
+  p = new0 (nPart, OnePartition) ;
+  for (i = 0, n = 0 ; i < 128 ; ++i) // all parts read with the codecs of the file
+    if (isalpha(i) && partitionCodec (vf, i))
+      p[0].codecs[n++] = i ;
+  for (i = 0 ; i < nPart ; ++i)
+    { p[i].part        = i ;
+      p[i].nPart       = nPart ;
+      p[i].objectStart = cut[i] ;
+      p[i].objectEnd   = cut[i+1] ;
+      p[i].groupStart  = nGroup ? groupsBefore (vf, cut[i]) : 0 ;
+      p[i].groupEnd    = (i+1 < nPart && nGroup) ? groupsBefore (vf, cut[i+1]) : nGroup ;
+      p[i].byteStart   = (i > 0) ? p[i-1].byteEnd : objectStart (vf, 0) ;
+      p[i].byteEnd     = objectStart (vf, cut[i+1]) ;
+      p[i].footOff     = vf->footOff ;
+      strcpy (p[i].codecs, p[0].codecs) ;
+    }
+  free (cut) ;
+  return p ;
+}
+
+char *onePartitionString (OnePartition *p)
+{ char *s = new (160, char) ;
+
+  sprintf (s, "%d/%d:%" PRId64 "-%" PRId64 ":%" PRId64 "-%" PRId64 ":%" PRId64 "-%" PRId64
+	   ":%" PRId64 ":%s", p->part, p->nPart, p->objectStart, p->objectEnd,
+	   p->groupStart, p->groupEnd, p->byteStart, p->byteEnd, p->footOff,
+	   *p->codecs ? p->codecs : "-") ;
+  return s ;
+}
+
+bool onePartitionParse (char *s, OnePartition *p)
+{ int n = 0 ;
+
+  if (sscanf (s, "%d/%d:%" SCNd64 "-%" SCNd64 ":%" SCNd64 "-%" SCNd64 ":%" SCNd64 "-%" SCNd64
+	      ":%" SCNd64 ":%63[A-Za-z-]%n", &p->part, &p->nPart, &p->objectStart, &p->objectEnd,
+	      &p->groupStart, &p->groupEnd, &p->byteStart, &p->byteEnd, &p->footOff,
+	      p->codecs, &n) != 10
+      || s[n])
+    return false ;
+  if (!strcmp (p->codecs, "-"))
+    *p->codecs = 0 ;
+  else if (strchr (p->codecs, '-'))
+    return false ;
+  return (0 <= p->part && p->part < p->nPart && 0 <= p->objectStart
+	  && p->objectStart <= p->objectEnd && 0 <= p->groupStart
+	  && p->groupStart <= p->groupEnd && 0 < p->byteStart && p->byteStart <= p->byteEnd
+	  && p->byteEnd < p->footOff) ;
+}
+
+OneFile *oneFileOpenReadPartition (const char *path, OneSchema *vs, char *fileType,
+				   OnePartition *p, int nthreads)
+{ OneFile *vf ;
+  I64      nObj ;
+  int      i ;
+
+  if (!(vf = oneFileOpenRead (path, vs, fileType, nthreads)))
+    return NULL ;
+  nObj = vf->objectType ? vf->info[(int) vf->objectType]->given.count : 0 ;
+  if (!vf->isBinary || vf->footOff != p->footOff || p->objectEnd > nObj
+      || p->byteStart < vf->dataStart)
+    { fprintf (stderr, "ONE partition error: %s is not the binary file partitioned\n", path) ;
+      oneFileClose (vf) ;
+      return NULL ;
+    }
+  for (i = 0 ; p->codecs[i] ; ++i)
+    if (!partitionCodec (vf, p->codecs[i]))
+      { fprintf (stderr, "ONE partition error: %s has no codec for line type %c\n",
+		 path, p->codecs[i]) ;
+	oneFileClose (vf) ;
+	return NULL ;
+      }
+
+  if (vf->share < 1) nthreads = 1 ;
+  for (i = 0 ; i < nthreads ; ++i)
+    { seekSource (vf+i, p->byteStart, p->objectStart) ;
+      vf[i].partEnd = p->byteEnd ;
+    }
+  return vf ;
+}
+
+/***********************************************************************************
+ *
+ *   ONE_FILE_OPEN_READ_CAT: read binary files of the same type as one
+ *
+ **********************************************************************************/
+
+  // The file returned is the first file opened again, with the counts and group index of the
+  //   whole.  Its own codecs are dropped, and in their place each thread uses those of the
+  //   file being read, switching to the next at the end of its data, or to another on a
+  //   goto.  The files are each opened on one thread to read their headers and footers, and
+  //   their handles closed at once; each thread then opens the file it is reading as it
+  //   comes to it, and closes the one before, so there are never more handles open than
+  //   threads, however many files there are.  The numbers of objects before each file map
+  //   global object numbers to the object indices of the files.
+
+typedef struct OneCatStruct
+  { int       nFile ;
+    OneFile **file ;		// each opened on one thread, without a file handle
+    char    **path ;
+    I64      *objStart ;	// number of objects before each file, then the total
+    I64      *groupIndex ;	// the group index of the first file, restored on close
+    I64       groupBufSize ;
+  } OneCat ;
+
+static void catSwitch (OneFile *vf, int k) // vf is any thread of the concatenation
+{ OneFile *c = vf->cat->file[k] ;
+  int      i ;
+
+  if (k != vf->catFile)
+    { fclose (vf->f) ;
+      if (!(vf->f = fopen (vf->cat->path[k], "r")))
+	die ("ONE cat error: can't open %s: %s", vf->cat->path[k], strerror (errno)) ;
+    }
+  for (i = 0 ; i < 128 ; ++i)
+    if (vf->info[i] && isalpha(i))
+      vf->info[i]->listCodec = c->info[i] ? c->info[i]->listCodec : NULL ;
+  memcpy (vf->binaryTypeUnpack, c->binaryTypeUnpack, sizeof(vf->binaryTypeUnpack)) ;
+  vf->dataStart = c->dataStart ;
+  vf->footOff   = c->footOff ;
+  vf->catFile   = k ;
+}
+
+static bool catNextFile (OneFile *vf) // at the end of the data of a file, go on to the next
+{ if (vf->catFile+1 >= vf->cat->nFile)
+    return false ;
+  catSwitch (vf, vf->catFile+1) ;
+  if (fseeko (vf->f, vf->dataStart, SEEK_SET) != 0)
+    die ("ONE cat error: can't seek to the start of data of file %d", vf->catFile) ;
+  return true ;
+}
+
+static bool catSeek (OneFile *vf, I64 i) // to global object i
+{ OneCat *cat = vf->cat ;
+  int     lo = 0, hi = cat->nFile - 1, mid ;
+
+  while (lo < hi) // the last file starting at or before i, which is not empty
+    { mid = (lo + hi + 1) / 2 ;
+      if (cat->objStart[mid] <= i) lo = mid ; else hi = mid - 1 ;
+    }
+  if (vf->catFile != lo)
+    catSwitch (vf, lo) ;
+  return fseeko (vf->f, ((I64 *) cat->file[lo]->info['&']->buffer)[i - cat->objStart[lo]],
+		 SEEK_SET) == 0 ;
+}
+
+static void catFree (OneCat *cat)
+{ int k ;
+
+  for (k = 0 ; k < cat->nFile ; ++k)
+    { if (cat->file[k])
+	oneFileClose (cat->file[k]) ;
+      free (cat->path[k]) ;
+    }
+  free (cat->file) ;
+  free (cat->path) ;
+  free (cat->objStart) ;
+  free (cat) ;
+}
+
+static void catDestroy (OneFile *vf) // before vf is closed
+{ OneCat *cat = vf->cat ;
+  int     i, j, n = (vf->share > 0) ? vf->share : 1 ;
+
+  for (j = 0 ; j < n ; ++j)
+    { vf[j].cat = NULL ;
+      for (i = 0 ; i < 128 ; ++i)
+	if (vf[j].info[i] && isalpha(i))
+	  vf[j].info[i]->listCodec = NULL ;
+    }
+  if (cat->groupIndex)
+    { free (vf->info['*']->buffer) ;
+      vf->info['*']->buffer  = cat->groupIndex ;
+      vf->info['*']->bufSize = cat->groupBufSize ;
+    }
+  catFree (cat) ;
+}
+
+static bool catIsLike (OneFile *vf, OneFile *c) // c has no data lines that vf can't read
+{ int i ;
+
+  if (!c->isBinary || !c->isIndexIn || strcmp (c->fileType, vf->fileType)
+      || c->objectType != vf->objectType || c->groupType != vf->groupType)
+    return false ;
+  for (i = 0 ; i < 128 ; ++i)
+    { OneInfo *ls = c->info[i], *li = vf->info[i] ;
+      if (ls && isalpha(i) && ls->given.count)
+	if (!li || li->nField != ls->nField
+	    || memcmp (li->fieldType, ls->fieldType, li->nField*sizeof(OneType)))
+	  return false ;
+    }
+  return true ;
+}
+
+OneFile *oneFileOpenReadCat (int nFiles, char **paths, OneSchema *vs, char *fileType,
+			     int nthreads)
+{ OneFile *vf, *c ;
+  OneCat  *cat ;
+  I64      nObj = 0, nGroup = 0, size ;
+  int      i, j, k, n ;
+
+  if (nFiles < 1 || !(vf = oneFileOpenRead (paths[0], vs, fileType, nthreads)))
+    return NULL ;
+  n = (vf->share > 0) ? vf->share : 1 ;
+  cat = new0 (1, OneCat) ;
+  cat->nFile    = nFiles ;
+  cat->file     = new0 (nFiles, OneFile*) ;
+  cat->path     = new0 (nFiles, char*) ;
+  cat->objStart = new (nFiles+1, I64) ;
+
+  for (k = 0 ; k < nFiles ; ++k)
+    { c = cat->file[k] = oneFileOpenRead (paths[k], vs, fileType, 1) ;
+      if (!c || !catIsLike (vf, c))
+	{ fprintf (stderr, "ONE cat error: %s is not a binary %s file like %s\n",
+		   paths[k], vf->fileType, paths[0]) ;
+	  catFree (cat) ;
+	  oneFileClose (vf) ;
+	  return NULL ;
+	}
+      fclose (c->f) ; // reopened by each thread that comes to it
+      c->f = NULL ;
+      cat->path[k] = strdup (paths[k]) ;
+      cat->objStart[k] = nObj ;
+      nObj += c->info[(int) c->objectType]->given.count ;
+      if (c->groupType)
+	nGroup += c->info[(int) c->groupType]->given.count ;
+    }
+  cat->objStart[nFiles] = nObj ;
+
+  // the counts of the whole, and the buffers to read any line of any file
+
+  for (i = 0 ; i < 128 ; ++i)
+    if (vf->info[i] && isalpha(i))
+      { OneCounts w ;
+	memset (&w, 0, sizeof(w)) ;
+	for (k = 0 ; k < nFiles ; ++k)
+	  if ((c = cat->file[k])->info[i])
+	    { OneCounts *g = &c->info[i]->given ;
+	      w.count += g->count ;
+	      w.total += g->total ;
+	      if (g->max > w.max) w.max = g->max ;
+	      if (g->groupCount > w.groupCount) w.groupCount = g->groupCount ;
+	      if (g->groupTotal > w.groupTotal) w.groupTotal = g->groupTotal ;
+	    }
+	for (j = 0 ; j < n ; ++j)
+	  { OneInfo *li = vf[j].info[i] ;
+	    li->given = w ;
+	    if (li->listEltSize && !li->isUserBuf && !li->isStream && w.max+1 > li->bufSize)
+	      { if (li->buffer) free (li->buffer) ;
+		li->bufSize = w.max + 1 ;
+		li->buffer  = new (li->bufSize*li->listEltSize, void) ;
+	      }
+	  }
+      }
+  for (size = 0, k = 0 ; k < nFiles ; ++k)
+    if (cat->file[k]->codecBufSize > size)
+      size = cat->file[k]->codecBufSize ;
+  for (j = 0 ; j < n ; ++j)
+    if (size > vf[j].codecBufSize)
+      { free (vf[j].codecBuf) ;
+	vf[j].codecBufSize = size ;
+	vf[j].codecBuf     = new (size, char) ;
+      }
+
+  if (vf->groupType) // global group index, with the usual end marker
+    { I64 *gi = new (nGroup+1, I64), g = 0 ;
+      for (k = 0 ; k < nFiles ; ++k)
+	{ c = cat->file[k] ;
+	  I64 m = c->info[(int) c->groupType]->given.count, *gk = (I64 *) c->info['*']->buffer ;
+	  for (i = 0 ; i < m ; ++i)
+	    gi[g++] = gk[i] + cat->objStart[k] ;
+	}
+      gi[nGroup] = nObj ;
+      cat->groupIndex   = (I64 *) vf->info['*']->buffer ;
+      cat->groupBufSize = vf->info['*']->bufSize ;
+      vf->info['*']->buffer  = gi ;
+      vf->info['*']->bufSize = nGroup+1 ;
+    }
+
+  // drop the codecs of the first file as opened here, and read from the files, starting
+  //   with the handles of the first file already open
+
+  for (i = 0 ; i < 128 ; ++i)
+    if (vf->info[i] && isalpha(i) && vf->info[i]->listCodec)
+      { vcDestroy (vf->info[i]->listCodec) ; // the slaves share it
+	for (j = 0 ; j < n ; ++j)
+	  vf[j].info[i]->listCodec = NULL ;
+      }
+  for (j = 0 ; j < n ; ++j)
+    { OneFile *v = vf + j ;
+      v->cat      = cat ;
+      v->catFile  = 0 ;
+      v->sortType = 0 ;
+      for (i = 0 ; i < v->nZoneMap ; ++i)
+	{ free (v->zoneMap[i].min) ;
+	  free (v->zoneMap[i].max) ;
+	}
+      v->nZoneMap = 0 ;
+      catSwitch (v, 0) ;
+    }
+  return vf ;
+}
+
 /***********************************************************************************
  *
  *  Length limited Huffman Compressor/decompressor with special 2-bit compressor for DNA
@@ -2483,7 +4728,7 @@ void oneFileClose (OneFile *vf)
   //    to operate.  You can destroy/free it with vcDestroy.
 
 OneCodec *vcCreate();
-void      vcAddToTable(OneCodec *vc, int len, char *bytes);
+void      vcAddToTable(OneCodec *vc, I64 len, char *bytes);
 void      vcCreateCodec(OneCodec *vc, int partial);
 void      vcDestroy(OneCodec *vc);
 
@@ -2505,8 +4750,8 @@ void      vcPrint(OneCodec *vc, FILE *to);
   //    ilen is the number of bits in the compressed input, and the return value
   //    is the number of bytes in the uncompressed output.  The routines are endian safe.
 
-int       vcEncode(OneCodec *vc, int ilen, char *ibytes, char *obytes);
-int       vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes);
+I64       vcEncode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes);
+I64       vcDecode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes);
 
   //  Rather than directly reading or writing an encoding of a compressor, the routines
   //    below serialize or deserialize the compressor into/outof a user-supplied buffer.
@@ -2623,10 +4868,10 @@ void vcDestroy(OneCodec *vc)
   //  Add the frequencies of bytes in bytes[0..len) to vc's histogram
   //    State becomes FILLED
 
-void vcAddToTable(OneCodec *vc, int len, char *bytes)
+void vcAddToTable(OneCodec *vc, I64 len, char *bytes)
 { _OneCodec *v = (_OneCodec *) vc;
   uint8 *data = (uint8 *) bytes;
-  int i;
+  I64 i;
 
   for (i = 0; i < len; i++)
     v->hist[(int) data[i]] += 1;
@@ -3114,8 +5359,8 @@ static uint8 Number[128] =
 
   //  Compress DNA into 2-bits per base
 
-int Compress_DNA(int len, char *s, char *t)
-{ int    i, j;
+I64 Compress_DNA(I64 len, char *s, char *t)
+{ I64    i, j;
   uint8 *s0, *s1, *s2, *s3;
 
   s0 = (uint8 *) s;
@@ -3146,11 +5391,12 @@ int Compress_DNA(int len, char *s, char *t)
   //  Encode ibytes[0..ilen) according to compressor vc and place in obytes
   //  Return the # of bits used.
 
-int vcEncode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
+I64 vcEncode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes)
 { _OneCodec *v = (_OneCodec *) vc;
 
   uint64  c, ocode, *ob;
-  int     n, k, rem, tbits, ibits, esc, elen;
+  I64     k, tbits, ibits;
+  int     n, rem, esc, elen;
   uint8  *clens, x, *bcode, *bb;
   uint16 *cbits;
 
@@ -3250,8 +5496,9 @@ int vcEncode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
 
 static char Base[4] = { 'a', 'c', 'g', 't' };
 
-int Uncompress_DNA(char *s, int len, char *t)
-{ int   i, tlen, byte;
+I64 Uncompress_DNA(char *s, I64 len, char *t)
+{ I64   i, tlen;
+  int   byte;
   char *t0, *t1, *t2, *t3;
 
   t0 = t;
@@ -3294,15 +5541,15 @@ int Uncompress_DNA(char *s, int len, char *t)
   //  Decode ilen bits in ibytes, into obytes according to vc's codec
   //  Return the number of bytes decoded.
 
-int vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
+I64 vcDecode(OneCodec *vc, I64 ilen, char *ibytes, char *obytes)
 { _OneCodec *v = (_OneCodec *) vc;
 
   char   *look;
   uint8  *lens, *q;
   uint64  icode, ncode, *p;
-  int     rem, nem;
+  I64     rem, nem, k;
   uint8   c, *o;
-  int     n, k, elen, inbig, esc;
+  int     n, elen, inbig, esc;
 
   if (vc == DNAcodec)
     return (Uncompress_DNA(ibytes,ilen>>1,obytes));
@@ -3313,7 +5560,7 @@ int vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
     }
 
   if (*((uint8 *) ibytes) == 0xff)
-    { int olen = (ilen>>3)-1;
+    { I64 olen = (ilen>>3)-1;
       memcpy(obytes,ibytes+1,olen);
       return (olen);
     }
@@ -3345,7 +5592,7 @@ int vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
   icode <<= n;						\
   rem   -= n;						\
   while (rem < 16)					\
-    { int z = 64-rem;					\
+    { I64 z = 64-rem;					\
       icode |= (ncode >> rem);				\
       if (nem > z)					\
         { nem -= z;					\
@@ -3404,6 +5651,7 @@ int vcDecode(OneCodec *vc, int ilen, char *ibytes, char *obytes)
   return (o - (uint8 *) obytes);
 }
 
+
 //////////////////////////////////////////////////////////////////////////////////////
 //
 // integer compression for write/read of fields
@@ -3427,7 +5675,7 @@ static inline int intGet (unsigned char *u, I64 *pval)
     case 0:
       switch (u[0] & 0x07)
 	{
-	case 0: die ("int packing error") ;
+	case 0: die ("int packing error") ; break ;
 	case 1: *pval = *(I64*)(u+1) & 0x0000000000ffff ; return 3 ;
 	case 2: *pval = *(I64*)(u+1) & 0x00000000ffffff ; return 4 ;
 	case 3: *pval = *(I64*)(u+1) & 0x000000ffffffff ; return 5 ;
@@ -3436,10 +5684,11 @@ static inline int intGet (unsigned char *u, I64 *pval)
 	case 6: *pval = *(I64*)(u+1) & 0xffffffffffffff ; return 8 ;
 	case 7: *pval = *(I64*)(u+1) ; return 9 ;
 	}
+      break ;
     case 4:
       switch (u[0] & 0x07)
 	{
-	case 0: die ("int packing error") ;
+	case 0: die ("int packing error") ; break ;
 	case 1: *pval = *(I64*)(u+1) | 0xffffffffffff0000 ; return 3 ;
 	case 2: *pval = *(I64*)(u+1) | 0xffffffffff000000 ; return 4 ;
 	case 3: *pval = *(I64*)(u+1) | 0xffffffff00000000 ; return 5 ;
@@ -3481,9 +5730,10 @@ static inline int intPut (unsigned char *u, I64 val)
 static inline I64 ltfRead (FILE *f)
 {
   unsigned char u[16] ;
-  I64 val ;
+  I64 val = 0 ;
 
   u[0] = getc (f) ;
+  *(I64*)(u+1) = 0 ;		// intGet() reads 8 bytes after u[0], masking those not read here
   if (u[0] & 0x40)
     { intGet (u, &val) ;
       //      printf ("read %d n 1 u %02x\n", (int)val, u[0]) ;
@@ -3516,311 +5766,9 @@ static inline int ltfWrite (I64 x, FILE *f)
   return n ;
 }
 
-#if defined(TEST_LTF) || defined(TEST_INT)
-
-// these are the original routines from James Bonfield on which this is based
-// incorporated here for credit and for comparisons in the TEST functionality
-
-/***********************************************************************************
- *
- *    LTF encoding for integers
- *    adapted from htslib/cram/cram_io.h with copyright statement:
-
-Copyright (c) 2012-2019 Genome Research Ltd.
-Author: James Bonfield <jkb@sanger.ac.uk>
-
-Redistribution and use in source and binary forms, with or without
-modification, are permitted provided that the following conditions are met:
-
-   1. Redistributions of source code must retain the above copyright notice,
-this list of conditions and the following disclaimer.
-
-   2. Redistributions in binary form must reproduce the above copyright notice,
-this list of conditions and the following disclaimer in the documentation
-and/or other materials provided with the distribution.
-
-   3. Neither the names Genome Research Ltd and Wellcome Trust Sanger
-Institute nor the names of its contributors may be used to endorse or promote
-products derived from this software without specific prior written permission.
-
-THIS SOFTWARE IS PROVIDED BY GENOME RESEARCH LTD AND CONTRIBUTORS "AS IS" AND
-ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
-WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
-DISCLAIMED. IN NO EVENT SHALL GENOME RESEARCH LTD OR CONTRIBUTORS BE LIABLE
-FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
-DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
-SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
-CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
-OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
-OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-
- *
- **********************************************************************************/
-
-/* 64-bit itf8 variant */
-
-static inline int ltf8_put(char *cp, int64_t val) {
-    unsigned char *up = (unsigned char *)cp;
-    if        (!(val & ~((1LL<<7)-1))) {
-        *up = val;
-        return 1;
-    } else if (!(val & ~((1LL<<(6+8))-1))) {
-        *up++ = (val >> 8 ) | 0x80;
-        *up   = val & 0xff;
-        return 2;
-    } else if (!(val & ~((1LL<<(5+2*8))-1))) {
-        *up++ = (val >> 16) | 0xc0;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 3;
-    } else if (!(val & ~((1LL<<(4+3*8))-1))) {
-        *up++ = (val >> 24) | 0xe0;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 4;
-    } else if (!(val & ~((1LL<<(3+4*8))-1))) {
-        *up++ = (val >> 32) | 0xf0;
-        *up++ = (val >> 24) & 0xff;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 5;
-    } else if (!(val & ~((1LL<<(2+5*8))-1))) {
-        *up++ = (val >> 40) | 0xf8;
-        *up++ = (val >> 32) & 0xff;
-        *up++ = (val >> 24) & 0xff;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 6;
-    } else if (!(val & ~((1LL<<(1+6*8))-1))) {
-        *up++ = (val >> 48) | 0xfc;
-        *up++ = (val >> 40) & 0xff;
-        *up++ = (val >> 32) & 0xff;
-        *up++ = (val >> 24) & 0xff;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 7;
-    } else if (!(val & ~((1LL<<(7*8))-1))) {
-        *up++ = (val >> 56) | 0xfe;
-        *up++ = (val >> 48) & 0xff;
-        *up++ = (val >> 40) & 0xff;
-        *up++ = (val >> 32) & 0xff;
-        *up++ = (val >> 24) & 0xff;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 8;
-    } else {
-        *up++ = 0xff;
-        *up++ = (val >> 56) & 0xff;
-        *up++ = (val >> 48) & 0xff;
-        *up++ = (val >> 40) & 0xff;
-        *up++ = (val >> 32) & 0xff;
-        *up++ = (val >> 24) & 0xff;
-        *up++ = (val >> 16) & 0xff;
-        *up++ = (val >> 8 ) & 0xff;
-        *up   = val & 0xff;
-        return 9;
-    }
-}
-
-static inline int ltf8_get(char *cp, int64_t *val_p) {
-    unsigned char *up = (unsigned char *)cp;
-
-    if (up[0] < 0x80) {
-        *val_p =   up[0];
-        return 1;
-    } else if (up[0] < 0xc0) {
-        *val_p = (((uint64_t)up[0]<< 8) |
-                   (uint64_t)up[1]) & (((1LL<<(6+8)))-1);
-        return 2;
-    } else if (up[0] < 0xe0) {
-        *val_p = (((uint64_t)up[0]<<16) |
-                  ((uint64_t)up[1]<< 8) |
-                   (uint64_t)up[2]) & ((1LL<<(5+2*8))-1);
-        return 3;
-    } else if (up[0] < 0xf0) {
-        *val_p = (((uint64_t)up[0]<<24) |
-                  ((uint64_t)up[1]<<16) |
-                  ((uint64_t)up[2]<< 8) |
-                   (uint64_t)up[3]) & ((1LL<<(4+3*8))-1);
-        return 4;
-    } else if (up[0] < 0xf8) {
-        *val_p = (((uint64_t)up[0]<<32) |
-                  ((uint64_t)up[1]<<24) |
-                  ((uint64_t)up[2]<<16) |
-                  ((uint64_t)up[3]<< 8) |
-                   (uint64_t)up[4]) & ((1LL<<(3+4*8))-1);
-        return 5;
-    } else if (up[0] < 0xfc) {
-        *val_p = (((uint64_t)up[0]<<40) |
-                  ((uint64_t)up[1]<<32) |
-                  ((uint64_t)up[2]<<24) |
-                  ((uint64_t)up[3]<<16) |
-                  ((uint64_t)up[4]<< 8) |
-                   (uint64_t)up[5]) & ((1LL<<(2+5*8))-1);
-        return 6;
-    } else if (up[0] < 0xfe) {
-        *val_p = (((uint64_t)up[0]<<48) |
-                  ((uint64_t)up[1]<<40) |
-                  ((uint64_t)up[2]<<32) |
-                  ((uint64_t)up[3]<<24) |
-                  ((uint64_t)up[4]<<16) |
-                  ((uint64_t)up[5]<< 8) |
-                   (uint64_t)up[6]) & ((1LL<<(1+6*8))-1);
-        return 7;
-    } else if (up[0] < 0xff) {
-        *val_p = (((uint64_t)up[1]<<48) |
-                  ((uint64_t)up[2]<<40) |
-                  ((uint64_t)up[3]<<32) |
-                  ((uint64_t)up[4]<<24) |
-                  ((uint64_t)up[5]<<16) |
-                  ((uint64_t)up[6]<< 8) |
-                   (uint64_t)up[7]) & ((1LL<<(7*8))-1);
-        return 8;
-    } else {
-        *val_p = (((uint64_t)up[1]<<56) |
-                  ((uint64_t)up[2]<<48) |
-                  ((uint64_t)up[3]<<40) |
-                  ((uint64_t)up[4]<<32) |
-                  ((uint64_t)up[5]<<24) |
-                  ((uint64_t)up[6]<<16) |
-                  ((uint64_t)up[7]<< 8) |
-                   (uint64_t)up[8]);
-        return 9;
-    }
-}
-
-#include <sys/resource.h>
-#ifndef RUSAGE_SELF     /* to prevent "RUSAGE_SELF redefined" gcc warning, fixme if this is more intricate */
-#define RUSAGE_SELF 0
-#endif
-
-void timeUpdate (FILE *f)
-{
-  static bool isFirst = 1 ;
-  static struct rusage rOld, rFirst ;
-  struct rusage rNew ;
-  int secs, usecs ;
-
-  getrusage (RUSAGE_SELF, &rNew) ;
-  if (!isFirst)
-    { secs = rNew.ru_utime.tv_sec - rOld.ru_utime.tv_sec ;
-      usecs =  rNew.ru_utime.tv_usec - rOld.ru_utime.tv_usec ;
-      if (usecs < 0) { usecs += 1000000 ; secs -= 1 ; }
-      fprintf (f, "user\t%d.%06d", secs, usecs) ;
-      secs = rNew.ru_stime.tv_sec - rOld.ru_stime.tv_sec ;
-      usecs =  rNew.ru_stime.tv_usec - rOld.ru_stime.tv_usec ;
-      if (usecs < 0) { usecs += 1000000 ; secs -= 1 ; }
-      fprintf (f, "\tsystem\t%d.%06d", secs, usecs) ;
-      fprintf (f, "\tmax_RSS\t%ld", rNew.ru_maxrss - rOld.ru_maxrss) ;
-      fputc ('\n', f) ;
-    }
-  else
-    { rFirst = rNew ;
-      isFirst = false ;
-    }
-
-  rOld = rNew ;
-}
-
-int main (int argc, char *argv[])
-{
-  I64   i, j, x, n, tot, mod ;
-  FILE *f ;
-  static unsigned char buffer[9*(1<<20)] ;
-
-  if (argc < 3) die ("usage: ./test <start> <n> [mod]") ;
-  
-//  { int   t = 1;
-//    char *b = (char *) (&t);
-//    if (*b == 0) printf ("bigEndian\n") ; else printf ("smallEndian\n") ;
-//  }
+// the original ltf8 routines of James Bonfield, on which intPut() and intGet() are based,
+// are in ONEmicro.c for credit and for comparison in the microbenchmarks
 
-  timeUpdate (0) ;
-  
-  x = atoi(argv[1]) ;
-  n = atoi(argv[2]) ;
-  if (argc == 4) mod = atoi(argv[3]) ; else mod = 0 ;
-  tot = 0 ;
-#ifdef TEST_INT
-  f = fopen ("int.test", "w") ;
-#endif
-#ifdef TEST_LTF
-  f = fopen ("ltf.test", "w") ;
-#endif
-  if (argc > 4)
-    for (i = 0 ; i < n ; ++i) { tot += ltfWrite (x++, f) ; if (x == mod) x = 0 ; }
-  else
-    { while (n)
-	{ int m = (n > 1<<20) ? 1<<20 : n ;
-	  unsigned char *u = buffer ;
-	  for (i = 0 ; i < m ; ++i)
-	    {
-#ifdef TEST_INT
-	      u += intPut (u, x++) ;
-#endif
-#ifdef TEST_LTF
-	      u += ltf8_put ((char*)u, x++) ;
-#endif
-	      if (x == mod) x = 0 ;
-	    }
-	  tot += (u-buffer) ;
-	  fwrite (buffer, 1, (u-buffer), f) ;
-	  n -= m ;
-	}
-    }
-  fclose (f) ;
-  printf ("wrote %" PRId64 " bytes: ", tot) ;
-  timeUpdate (stdout) ;
-
-  x = atoi(argv[1]) ;
-  n = atoi(argv[2]) ;
-  tot = 0 ;
-#ifdef TEST_INT
-  f = fopen ("int.test", "r") ;
-#endif
-#ifdef TEST_LTF
-  f = fopen ("ltf.test", "r") ;
-#endif
-  if (argc > 4)
-    {  for (j = 0 ; j < n ; ++j)
-	if ((i = ltfRead (f)) != j)
-	  die ("ltf wrote %d read %d", (int)j, (int)i) ;
-    }
-  else
-    { unsigned char *u = buffer, *v = buffer ; // u is current pos, v is end of section read in
-      while (n)
-	{ int m = (n > 1<<20) ? 1<<20 : n ;
-//	  printf ("attempting to read %d chars: n %d (v-u) %d\n", (int)(9*m - (v-u)), m, (int)(v-u)) ;
-	  unsigned char *v0 = v, *u0 = u ;
-	  v += fread (v, 1, 9*m - (v-u), f) ;
-//	  printf ("  read %d chars\n", (int)(v-v0)) ;
-	  for (i = 0 ; i < m ; ++i)
-#ifdef TEST_INT
-	    u += intGet (u, &j) ;
-#endif
-#ifdef TEST_LTF
-	    u += ltf8_get ((char*)u, &j) ;
-#endif
-//	  printf ("  intGet m %d ints used %d chars\n", m, (int)(u-u0)) ;
-	  n -= m ;
-	  m = v - u ;
-//	  printf ("  memmove %d\n", m) ;
-	  memmove (buffer, u, m) ;
-	  tot += (u-buffer) ;
-	  v -= (u-buffer) ; u = buffer ;
-	}
-    }
-  fclose (f) ;
-
-  printf ("read  %" PRId64 " bytes: ", tot) ;
-  timeUpdate (stdout) ;
-}
-#endif // TEST_LTF
 
 /***********************************************************************************
  *
@@ -22,6 +22,10 @@
 #include <limits.h>   // for INT_MAX etc.
 #include <pthread.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /***********************************************************************************
  *
  *    DATA TYPES
@@ -80,6 +84,13 @@ typedef void OneCodec; // forward declaration of opaque type for compression cod
 
 extern  OneCodec *DNAcodec;
 
+  // The size of a codec as stored in the footer of a binary file, e.g. for ONEstat -f:
+  //   vcSerialize() writes vc into out, which must hold vcMaxSerialSize()+1 bytes, and
+  //   returns the number of bytes written.
+
+int vcMaxSerialSize (void) ;
+int vcSerialize (OneCodec *vc, void *out) ;
+
   // Record for a particular line type.  There is at most one list element.
 
 typedef struct
@@ -105,6 +116,7 @@ typedef struct
     char      binaryTypePack;   // binary code for line type, bit 8 set.
                                 //     bit 0: list compressed
     I64       listTack;         // accumulated training data for this threads codeCodec (master)
+    bool      isStream;         // lists are read in chunks by oneReadListChunk()
   } OneInfo;
 
   // the schema type - the first record is the header spec, then a linked list of primary classes
@@ -121,11 +133,32 @@ typedef struct OneSchema
     struct OneSchema *nxt ;
   } OneSchema ;
 
+typedef struct
+  { char  lineType ;        // zone map of the values of one INT field of lineType
+    int   field ;           //   or of its list length if field < 0
+    I64   blockSize ;       // number of objects in a block
+    I64   nBlock, bufSize ;
+    I64  *min, *max ;       // per block - min > max if the block has no such line
+  } OneZoneMap ;
+
 typedef struct OneHeaderText
   { char *text ;
     struct OneHeaderText *nxt ;
   } OneHeaderText ;
 
+  // a slice of contiguous objects of a binary file, for a separate process to read
+
+typedef enum { oneBYTES, oneOBJECTS, oneGROUPS } OneBalance ;
+
+typedef struct
+  { int   part, nPart ;            // part 'part', from 0, of nPart
+    I64   objectStart, objectEnd ; // objects objectStart..objectEnd-1
+    I64   groupStart, groupEnd ;   // groups starting within them
+    I64   byteStart, byteEnd ;     // their data, with any group line before the first object
+    I64   footOff ;                // of the file, to check that it is the one partitioned
+    char  codecs[64] ;             // line types whose lists are read with a codec of the file
+  } OnePartition ;
+
   // The main OneFile type - this is the primary handle used by the end user
 
 typedef struct
@@ -150,6 +183,8 @@ typedef struct
     OneReference  *deferred;           // if non-zero then count['>'] entries
     OneField      *field;              // used to hold the current line - accessed by macros
     OneInfo       *info[128];          // all the per-linetype information
+    char           sortType;           // if set, objects are sorted on field sortField of their
+    int            sortField;          //   first sortType line, or its list length if < 0
     I64            codecTrainingSize;  // amount of data to see before building codec
 
     // fields below here are private to the package
@@ -157,6 +192,8 @@ typedef struct
     FILE  *f;
     bool   isWrite;                // true if open for writing
     bool   isHeaderOut;            // true if header already written
+    bool   isAppend;               // binary write: opened by oneFileOpenAppend()
+    I64    nHeaderProv;            // binary: provenance lines in the header, the rest in the footer
     bool   isBinary;               // true if writing a binary file
     bool   inGroup;                // set once inside a group
     bool   isLastLineBinary;       // needed to deal with newlines on ascii files
@@ -170,7 +207,22 @@ typedef struct
     I64    nBits;                  // number of bits of list currently in codecBuf
     I64    intListBytes;           // number of bytes per integer in the compacted INT_LIST
     I64    linePos;                // current line position
+    I64    dataStart;              // binary: file offset of the start of the data section
+    I64    footOff;                // binary: file offset of the start of the footer
     OneHeaderText *headerText;     // arbitrary descriptive text that goes with the header
+    OneZoneMap *zoneMap;           // binary: per block min/max of selected fields
+    int    nZoneMap;
+    I64    sortObject, sortLast;   // binary write: last object checked for sort order, value
+    char   streamType;             // line type of a list being streamed, while it is
+    char   streamMode;             //   how its elements are held: see oneReadListChunk()
+    I64    streamLeft;             //   number of its elements still to read or write
+    I64    streamStart;            //   file offset of its first element, -1 if unknown
+    int    nStreamCarry;           //   bases short of a full byte in packed DNA output
+    char   streamCarry[4];
+    I64    countsOff;              // ascii write: -1 if counts are reserved, then their offset
+    I64    partEnd;                // binary read: end of the data of a partition, else 0
+    struct OneCatStruct *cat;      // binary read: files read as one by oneFileOpenReadCat()
+    int    catFile;                //   and the one being read
 
     char   binaryTypeUnpack[256];  // invert binary line code to ASCII line character.
     int    share;                  // index if slave of threaded write, +nthreads > 0 if master
@@ -236,6 +288,11 @@ OneFile *oneFileOpenRead (const char *path, OneSchema *schema, char *type, int n
   //   slave or master in a parallel group.  The master recieves provenance, counts, etc.
   //   The slaves only read data and have the virtue of sharing indices and codecs with
   //   the master if relevant.
+  // An ascii file compressed with gzip, bgzip or VGPzip is read transparently if ONElib.c
+  //   was compiled with -DWITH_LIBDEFLATE, as by make WITH_GZIP=1.  Then nthreads is the
+  //   number of threads that inflate BGZF blocks, or VGPzip blocks found from the .vzi
+  //   index, in parallel, and a single OneFile is returned.  Other gzip files are inflated
+  //   whole into memory, or as a stream if also compiled with -DWITH_ZLIB.
 
 bool oneFileCheckSchema (OneFile *vf, char *textSchema) ;
 
@@ -245,6 +302,47 @@ bool oneFileCheckSchema (OneFile *vf, char *textSchema) ;
   // This is provided to enable a program to ensure that its assumptions about data layout
   // are satisfied.
 
+OnePartition *onePartitions (OneFile *vf, int nPart, OneBalance by, bool isKeepGroups) ;
+
+  // Cut the objects of vf, a binary file open for reading, into nPart partitions of
+  //   contiguous objects with about equal numbers of bytes, objects or groups, cutting only
+  //   at the start of a group if isKeepGroups, which balancing by groups implies.  Returns
+  //   a new array of nPart, of which some may be empty if there are few objects or groups,
+  //   or NULL if vf has no object index.  Moves the read position of vf.
+
+char *onePartitionString (OnePartition *p) ;
+bool  onePartitionParse  (char *s, OnePartition *p) ;
+
+  // A partition as a short string part/nPart:objects:groups:bytes:footOff:codecs, e.g.
+  //   "1/4:120-240:3-6:88512-176307:262144:SWX", that can be passed to another process on
+  //   its command line, where codecs are the line types whose lists are compressed with a
+  //   codec from the footer, or "-" if none.  The string is new and the caller must free
+  //   it.  Parse returns false if s is not such a string.
+
+OneFile *oneFileOpenReadPartition (const char *path, OneSchema *schema, char *type,
+				   OnePartition *p, int nthreads) ;
+
+  // Open 'path' as oneFileOpenRead(), positioned at the start of partition p, so that
+  //   oneReadLine() reads its lines and then returns 0 at its end, as at the end of the
+  //   file.  The header, footer and codecs of the whole file are read, so its counts are
+  //   those of the whole file.  With nthreads > 1 every OneFile is set to read p.  Returns
+  //   NULL if the file is not binary, or its footer is not where p says or it lacks a codec
+  //   that p needs, e.g. because it has been written again since p was made.
+
+OneFile *oneFileOpenReadCat (int nFiles, char **paths, OneSchema *schema, char *type,
+			     int nthreads) ;
+
+  // Open binary files with the same type and line types, e.g. shards of a data set, as one
+  //   file, read in turn as if they had been joined by oneFileCat(), with objects and groups
+  //   numbered across all of them.  The given counts are those of the whole, the gotos take
+  //   the numbers of the whole, and with nthreads > 1 each slave can go anywhere in it.  Each
+  //   file keeps its own codecs.  The header lines, e.g. provenance, are those of the first
+  //   file.  The objects are not declared sorted and there are no zone maps, and the result
+  //   can not be the source of oneFileCat() etc. or be partitioned.  Each thread keeps only
+  //   the file it is reading open, so the number of files is not limited by file handles.
+  //   Returns NULL, with a message to stderr, if any file can not be opened, or is not
+  //   binary like the first.
+
 char oneReadLine (OneFile *vf) ;
 
   // Read the next ONE formatted line returning the line type of the line, or 0
@@ -277,11 +375,64 @@ void*   oneCompressedList (OneFile *vf) ;      // lazy codec compression if requ
   //           s = oneNextString(vf,s);
   //         }
 
+bool oneStreamList (OneFile *vf, char lineType) ;
+I64  oneReadListChunk (OneFile *vf, void *buf, I64 maxLen) ;
+
+  // For lists too long to hold in memory, such as the DNA of a chromosome.  After
+  //   oneStreamList(), which must be called before reading data, oneReadLine() reads the
+  //   fields and length of lines of lineType but not their lists, which are then read by
+  //   repeated calls to oneReadListChunk() into buf, a user buffer of maxLen elements.  It
+  //   returns the number read, and 0 once the list is done.  Strings are not 0 terminated.
+  //   Compressed DNA is read in multiples of 4 bases, so maxLen must be at least 4.  Any
+  //   part of a list not read is skipped by the next oneReadLine(), and oneList() is not
+  //   available for lineType.  Returns false unless the list of lineType is its last field
+  //   and a STRING, DNA or REAL_LIST.  Lines compressed with a trained codec (not DNA)
+  //   must still be decoded whole, so are held in the line buffer.
+
+bool oneReadDNARange (OneFile *vf, I64 start, I64 len, char *out) ;
+
+  // Read bases start..start+len-1 of the DNA or STRING list of the current line into out,
+  //   without 0 termination.  For a streamed line type this reads from the file only the
+  //   bytes that cover the range, so a window of a chromosome costs little more than its
+  //   own length, and can be called any number of times before the next oneReadLine()
+  //   without disturbing oneReadListChunk().  The file must be seekable.  Returns false if
+  //   the range is not within the list.
+
+bool oneReadDNA2bit (OneFile *vf, I64 start, I64 len, U8 *out) ;
+bool oneReadDNA4bit (OneFile *vf, I64 start, I64 len, U8 *out) ;
+
+  // As oneReadDNARange() but into out packed 4 bases per byte, with a,c,g,t as 0,1,2,3 and
+  //   the first base in the top 2 bits as in binary files, or 2 bases per byte with a,c,g,t
+  //   as 1,2,4,8, anything else as 15 for n, and the first base in the top 4 bits as nt16 in
+  //   htslib.  Base start is always at the top of out[0], and the output is padded with 0
+  //   bits to a multiple of 8 bytes, so out must have room for 8*((len+31)/32) bytes for 2
+  //   bits or 8*((len+15)/16) for 4, and can be read in whole 64 bit words.  Packed DNA
+  //   from a binary file is copied without unpacking, but has lost its n's, which are a's;
+  //   a 4 bit read only keeps n's from text, e.g. ascii files.
+
+void oneWriteDNA2bit (OneFile *vf, char lineType, I64 len, U8 *dna) ;
+void oneWriteDNA4bit (OneFile *vf, char lineType, I64 len, U8 *dna) ;
+
+  // Write a line with fields set as for oneWriteLine() and its DNA list given as len bases
+  //   packed as above.  Packed DNA goes straight to a binary file.
+
 char *oneReadComment (OneFile *vf);
 
   // Can be called after oneReadLine() to read any optional comment text after the fixed fields.
   // Returns NULL if there is no comment.
 
+I64  oneSaveLine (OneFile *vf, void *buf, I64 size) ;
+I64  oneRestoreLine (OneFile *vf, void *buf) ;
+
+  // oneSaveLine() copies the line most recently read, with its fields, list and comment, into
+  //   buf, for oneRestoreLine() to make it the current line again later, e.g. to read on to
+  //   the end of an object before deciding whether to write its lines.  A compressed list is
+  //   saved as read, so is only decoded if oneList() is called after restoring it.  Returns
+  //   the number of bytes needed, a multiple of 8 so saved lines can follow each other in
+  //   one buffer, and saves nothing if that is more than size.  oneRestoreLine() returns the
+  //   same number, to step to the next saved line.  Lines of a streamed type can not be
+  //   saved.  Restoring does not change the line, object or group counts.
+
 //  WRITING ONE FILES:
 
 OneFile *oneFileOpenWriteNew (const char *path, OneSchema *schema, char *type,
@@ -294,7 +445,7 @@ OneFile *oneFileOpenWriteFrom (const char *path, OneFile *vfIn,
   //   For the 'From' variant, specify binary or ASCII, schema and all other header 
   //   information is inherited from 'vfIn', where the count stats are from vfIn's 
   //   accumulation (assumes vfIn has been fully read or written) if 'useAccum is true, 
-  //   and from vfIn's header otherwise.
+  //   and from vfIn's header otherwise.  Binary output keeps the zone maps of vfIn.
   // If nthreads > 1 then nthreads OneFiles are generated as an array and the pointer
   //   to the first, called the master, is returned.  The other nthreads-1 files are
   //   called slaves.  The package routines are aware of when a OneFile argument is a
@@ -303,6 +454,19 @@ OneFile *oneFileOpenWriteFrom (const char *path, OneFile *vfIn,
   //   segment of the initial data lines.  Upon close the final result is effectively
   //   the concatenation of the master, followed by the output of each slave in sequence.
 
+OneFile *oneFileOpenAppend (const char *path, int nthreads) ;
+
+  // Open the binary file 'path' to write more data lines at its end, without rewriting it.
+  //   Its footer is read and then cut off, and on oneFileClose() a footer is written that
+  //   covers the old and new data.  The existing codecs are kept, the last group remains
+  //   open until a new group line is written, and if the objects are declared sorted then
+  //   new objects must follow on.  The header is not rewritten, so do not call
+  //   oneWriteHeader() or add references.  Provenance added with oneAddProvenance() etc.
+  //   is written in the new footer, after any from earlier appends, and reading the file
+  //   gives it after that of the header.  If the program stops before oneFileClose(), the
+  //   file is left without a footer.  nthreads is as above.  Returns NULL if 'path' can not
+  //   be opened or is not binary.
+
 bool oneInheritProvenance (OneFile *vf, OneFile *source);
 bool oneInheritReference  (OneFile *vf, OneFile *source);
 bool oneInheritDeferred   (OneFile *vf, OneFile *source);
@@ -310,6 +474,20 @@ bool oneInheritDeferred   (OneFile *vf, OneFile *source);
   // Add all provenance/reference/deferred entries in source to header of vf.  Must be
   //   called before call to oneWriteHeader.
 
+bool oneInheritNewProvenance (OneFile *vf, OneFile *source);
+
+  // As oneInheritProvenance(), but skipping entries of source that vf already has, as when
+  //   combining files that share some history.  Returns true if any entry was added.
+
+bool oneInheritCodecs (OneFile *vf, OneFile *source);
+
+  // Install in vf, open for binary writing, the list codecs of source, which may be a binary
+  //   file being read or a file being written once its codecs are trained.  Lists are then
+  //   compressed from the first line rather than after a training period.  Must be called
+  //   before writing any data lines.  Line types that already have a codec keep it, so
+  //   calling this for several sources installs for each type the codec of the first source
+  //   that has one.  Returns true if any codec was installed.
+
 bool oneAddProvenance (OneFile *vf, char *prog, char *version, char *command, char *dateTime);
 bool oneAddReference  (OneFile *vf, char *filename, I64 count);
 bool oneAddDeferred   (OneFile *vf, char *filename);
@@ -324,6 +502,14 @@ void oneWriteHeader (OneFile *vf);
   //   calling this. For binary output, the counts will be accumulated and output in a
   //   footer upon oneClose.
 
+bool oneReserveCounts (OneFile *vf) ;
+
+  // For ASCII output, call before oneWriteHeader() to have the header hold count lines for
+  //   every line type, with numbers zero padded to a fixed width, that oneFileClose() then
+  //   overwrites in place with the true counts, so that readers can preallocate without the
+  //   file being written twice.  Returns false if the output can not seek, e.g. a pipe.
+  //   Binary files always have true counts in their footer, so it does nothing for them.
+
 void oneWriteLine (OneFile *vf, char lineType, I64 listLen, void *listBuf);
 
   // Set up a line for output just as it would be returned by oneReadLine and then call
@@ -332,11 +518,84 @@ void oneWriteLine (OneFile *vf, char lineType, I64 listLen, void *listBuf);
   // For lists, give the length in the listLen argument, and either place the list data in your
   //   own buffer and give it as listBuf, or put in the line's buffer and set listBuf == NULL.
 
+void oneWriteListBegin (OneFile *vf, char lineType, I64 listLen);
+void oneWriteListChunk (OneFile *vf, I64 n, void *buf);
+void oneWriteListEnd   (OneFile *vf);
+
+  // Write a line with its list given in pieces rather than all at once, for lists of the
+  //   kinds that oneStreamList() allows.  Fill the fields as for oneWriteLine(), call
+  //   oneWriteListBegin() with the full length, give consecutive pieces of n elements to
+  //   oneWriteListChunk(), then call oneWriteListEnd().  DNA is compressed as usual, while
+  //   other lists are written uncompressed and are not used to train a codec.
+
 void oneWriteComment (OneFile *vf, char *comment);
 
   // Adds a comment to the current line. Need to use this not fprintf() so as to keep the
   // index correct in binary mode.
 
+bool oneFileCat (OneFile *vf, OneFile *source);
+
+  // Append all the data of source, a binary file open for reading, to vf, a single threaded
+  //   binary file open for writing whose header has been written.  The data section is copied
+  //   without decoding if line codes and list codecs agree, and the counts and the object and
+  //   group indices are merged from the source footer, else each line is decoded and
+  //   re-encoded.  Returns true if copied directly.  To concatenate many files, open the
+  //   output with oneFileOpenWriteFrom() on the first and call oneInheritCodecs() for each
+  //   source before writing the header, so that as many as possible can be copied.
+  //   Objects before the first group of source join the last group of vf, and group
+  //   counts are then maxima over the pieces.
+
+bool oneFileCatRange (OneFile *vf, OneFile *source, I64 start, I64 end);
+
+  // As oneFileCat() for objects start to end-1 of source.  A range starts at the first object
+  //   or group line after object start-1, so the group line before object start is included,
+  //   and it ends likewise before object end.  Its lines are scanned to count them, but
+  //   compressed lists are not decoded.
+
+bool oneFileCatObjects (OneFile *vf, OneFile *source, I64 *objects, I64 n);
+
+  // Append the n objects of source listed in objects, in that order, e.g. to write objects
+  //   in sorted order.  Each object is its object line and the lines after it up to the next
+  //   object or group line, so group lines are not copied.  Lines are scanned as above.
+
+// SORTED FILES
+
+bool oneSetSorted (OneFile *vf, char lineType, int field);
+
+  // Declare in the header of vf, open for writing, that its objects are sorted in ascending
+  //   order of INT field 'field' of their first lineType line, or of its list length if field
+  //   is -1, where objects without such a line come first.  Call before oneWriteHeader().
+  //   Binary writes check the order within each thread and die if it is broken.  Returns
+  //   false if the field is not an INT.  The declaration is not inherited by
+  //   oneFileOpenWriteFrom(), since e.g. concatenation does not keep it.
+
+I64  oneFindObject (OneFile *vf, char lineType, int field, I64 value);
+
+  // For a binary file declared sorted on lineType and field, find by binary search with
+  //   oneGotoObject() the first object whose value is >= value, go to it, and return its
+  //   number, so that the next oneReadLine() reads its object line.  The object matches if
+  //   its value equals 'value'.  Returns the number of objects if there is none, and -1 if
+  //   the file is not binary or not sorted on lineType and field.
+
+// ZONE MAPS
+
+bool oneAddZoneMap (OneFile *vf, char lineType, int field, I64 blockSize);
+
+  // Record in the footer of vf, a binary file open for writing, the minimum and maximum of
+  //   INT field 'field' of lines of type lineType, or of their list length if field is -1,
+  //   over each block of blockSize objects.  Lines before the first object are ignored.
+  //   Call before writing any data lines.  Returns false if the field is not an INT.
+  //   Data appended raw by oneFileCat() take the zone map of the source if it has the
+  //   same one, else their blocks are marked as possibly holding any value.
+
+I64  oneZoneRanges (OneFile *vf, char lineType, int field, I64 lo, I64 hi, I64 **ranges);
+
+  // For a binary file being read, find the objects that may have a lineType line whose
+  //   field (or list length if field is -1) lies in lo..hi inclusive.  Returns the number
+  //   n of object ranges, and sets *ranges to a new array of 2n values start,end for
+  //   objects start to end-1, which the caller must free.  Returns -1 if there is no zone
+  //   map for lineType and field.
+
 // CLOSING FILES (FOR BOTH READ & WRITE)
 
 void oneFileClose (OneFile *vf);
@@ -395,6 +654,10 @@ I64  oneGotoGroup  (OneFile *vf, I64 i);
  //   where the low 56 bits encode length, and the high 8 bits encode the # of high-order
  //   0-bytes in every list element if an INT_LIST (0 otherwise).
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // ONE_DEFINED
 
 /******************* end of file **************/
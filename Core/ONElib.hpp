@@ -0,0 +1,421 @@
+/******************************************************************************************
+ *
+ *  File: ONElib.hpp
+ *    Header only C++ interface to ONElib: files that close themselves, range for loops over
+ *    lines and objects, spans of list data, and typed accessors for line types
+ *
+ *  Copyright (C) vgp-tools contributors, 2026
+ *
+ *  Link with libONE.a as for C.  Needs C++17, and uses std::span with C++20.  Failures to
+ *  open or create raise one::Error, which holds the message; other misuse dies in ONElib
+ *  as it does from C.  Example, for the alignments of an aln file:
+ *
+ *    using A = one::LineDef<'A', one::Int, one::Int> ;              // a and b sequences
+ *    using X = one::LineDef<'X', one::IntList> ;                    // trace differences
+ *    static_assert (A::is ("O A 2 3 INT 3 INT")) ;                 // as in the schema
+ *
+ *    one::File f = one::File::read ("x.1aln") ;
+ *    A::check (f) ; X::check (f) ;                                  // else throw one::Error
+ *    for (one::Object o : f.objects ())
+ *      for (one::Line l : o.lines ())
+ *        if (l.type () == 'A')
+ *          { auto [a, b] = A::get (l) ; ... }
+ *        else if (l.type () == 'X')
+ *          for (I64 d : X::field<0> (l)) ...
+ *
+ * HISTORY:
+ * Created: Oct 18 2026
+ *
+ *****************************************************************************************/
+
+#ifndef ONE_HPP_DEFINED
+#define ONE_HPP_DEFINED
+
+#include "ONElib.h"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <tuple>
+#include <array>
+#include <vector>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace one {
+
+struct Error : std::runtime_error
+{ using std::runtime_error::runtime_error ; } ;
+
+#if __cplusplus >= 202002L
+template <class T> using span = std::span<T> ;
+#else
+template <class T> class span	// the part of std::span used here
+{ T     *p ;
+  size_t n ;
+public:
+  constexpr span () : p (nullptr), n (0) {}
+  constexpr span (T *p, size_t n) : p (p), n (n) {}
+  constexpr T     *data () const { return p ; }
+  constexpr size_t size () const { return n ; }
+  constexpr bool   empty () const { return n == 0 ; }
+  constexpr T     &operator[] (size_t i) const { return p[i] ; }
+  constexpr T     *begin () const { return p ; }
+  constexpr T     *end () const { return p + n ; }
+} ;
+#endif
+
+  // the strings of a STRING_LIST, each 0 terminated, one after another
+
+class Strings
+{ const char *s ;
+  I64         n ;
+public:
+  Strings (const char *s, I64 n) : s (s), n (n) {}
+  I64 size () const { return n ; }
+  const char *data () const { return s ; }	// as oneWriteLine() takes them
+
+  class iterator
+  { const char *s ;
+    I64         i ;
+  public:
+    iterator (const char *s, I64 i) : s (s), i (i) {}
+    std::string_view operator* () const { return std::string_view (s) ; }
+    iterator &operator++ () { s += strlen (s) + 1 ; ++i ; return *this ; }
+    bool operator!= (const iterator &x) const { return i != x.i ; }
+  } ;
+  iterator begin () const { return iterator (s, 0) ; }
+  iterator end () const { return iterator (s, n) ; }
+} ;
+
+  // The current line of a file, valid until the next is read.  The list of a line is
+  //   decoded on first access, as by oneList().
+
+class Line
+{ OneFile *vf ;
+public:
+  explicit Line (OneFile *vf) : vf (vf) {}
+  OneFile *get () const { return vf ; }
+  char   type () const { return vf->lineType ; }
+
+  I64    i (int k) const { return oneInt (vf, k) ; }
+  double r (int k) const { return oneReal (vf, k) ; }
+  char   c (int k) const { return oneChar (vf, k) ; }
+
+  I64 len () const { return oneLen (vf) ; }
+  span<const I64>    intList () const  { return { oneIntList (vf), (size_t) len () } ; }
+  span<const double> realList () const { return { oneRealList (vf), (size_t) len () } ; }
+  std::string_view   string () const   { return { oneString (vf), (size_t) len () } ; }
+  std::string_view   dna () const      { return { oneDNAchar (vf), (size_t) len () } ; }
+  Strings            strings () const  { return { oneString (vf), len () } ; }
+  const char        *comment () const  { return oneReadComment (vf) ; }
+} ;
+
+  // Lines are read as a range for loop goes, so a range can only be used once.  The lines of
+  //   an object are its object line and those up to the next object or group line.
+
+class LineRange
+{ OneFile *vf ;
+  char    *t ;			// the type of the current line, shared with an ObjectRange
+  bool     isObject ;
+public:
+  LineRange (OneFile *vf, char *t, bool isObject) : vf (vf), t (t), isObject (isObject) {}
+
+  class iterator
+  { OneFile *vf ;
+    char    *t ;
+    bool     isObject, isEnd ;
+  public:
+    iterator (OneFile *vf, char *t, bool isObject, bool isEnd)
+      : vf (vf), t (t), isObject (isObject), isEnd (isEnd || !*t) {}
+    Line operator* () const { return Line (vf) ; }
+    iterator &operator++ ()
+    { *t = oneReadLine (vf) ;
+      isEnd = !*t || (isObject && (*t == vf->objectType || *t == vf->groupType)) ;
+      return *this ;
+    }
+    bool operator!= (const iterator &x) const { return isEnd != x.isEnd ; }
+  } ;
+
+  iterator begin ()
+  { if (!isObject) *t = oneReadLine (vf) ;
+    return iterator (vf, t, isObject, false) ;
+  }
+  iterator end () { return iterator (vf, t, isObject, true) ; }
+} ;
+
+class Object
+{ OneFile *vf ;
+  char    *t ;
+public:
+  Object (OneFile *vf, char *t) : vf (vf), t (t) {}
+  I64       index () const { return vf->object - 1 ; }
+  LineRange lines () const { return LineRange (vf, t, true) ; }
+} ;
+
+class ObjectRange
+{ OneFile *vf ;
+  char     t ;
+  I64      object ;		// vf->object when at the object line, to tell if it was passed
+public:
+  explicit ObjectRange (OneFile *vf) : vf (vf), t (0), object (-1) {}
+
+  class iterator
+  { ObjectRange *r ;
+  public:
+    explicit iterator (ObjectRange *r) : r (r) {}
+    Object operator* () const { return Object (r->vf, &r->t) ; }
+    iterator &operator++ () { r->next () ; return *this ; }
+    bool operator!= (const iterator &x) const { return (r && r->t) != (x.r && x.r->t) ; }
+  } ;
+
+  void next ()		// to the next object line, unless the lines of this one reached it
+  { while (t && (t != vf->objectType || vf->object == object))
+      t = oneReadLine (vf) ;
+    object = vf->object ;
+  }
+  iterator begin ()
+  { t = oneReadLine (vf) ;
+    next () ;
+    return iterator (this) ;
+  }
+  iterator end () { return iterator (nullptr) ; }
+} ;
+
+  // A OneFile that is closed when it goes out of scope.  A View does not own its OneFile,
+  //   e.g. thread i of a file opened with nthreads > 1, which is f.thread(i).
+
+class View
+{ protected:
+  OneFile *vf ;
+public:
+  explicit View (OneFile *vf = nullptr) : vf (vf) {}
+  OneFile *get () const { return vf ; }
+  OneFile *operator-> () const { return vf ; }
+
+  char        readLine () { return oneReadLine (vf) ; }
+  Line        line () const { return Line (vf) ; }
+  LineRange   lines () { return LineRange (vf, &vf->lineType, false) ; }
+  ObjectRange objects () { return ObjectRange (vf) ; }
+  bool        gotoObject (I64 i) { return oneGotoObject (vf, i) ; }
+  I64         gotoGroup (I64 i) { return oneGotoGroup (vf, i) ; }
+
+  bool addProvenance (const char *prog, const char *version, const char *command)
+  { return oneAddProvenance (vf, const_cast<char*> (prog), const_cast<char*> (version),
+			     const_cast<char*> (command), nullptr) ; }
+  bool inheritProvenance (const View &x) { return oneInheritProvenance (vf, x.vf) ; }
+  bool inheritReference (const View &x) { return oneInheritReference (vf, x.vf) ; }
+  void writeHeader () { oneWriteHeader (vf) ; }
+
+  I64 &i (int k) { return oneInt (vf, k) ; }	// fields to set before writeLine()
+  double &r (int k) { return oneReal (vf, k) ; }
+  char &c (int k) { return oneChar (vf, k) ; }
+  void writeLine (char t, I64 len = 0, const void *list = nullptr)
+  { oneWriteLine (vf, t, len, const_cast<void*> (list)) ; }
+  void writeLine (char t, std::string_view s) { writeLine (t, s.size (), s.data ()) ; }
+  void writeComment (const std::string &s) { oneWriteComment (vf, const_cast<char*> (s.c_str ())) ; }
+} ;
+
+class Schema
+{ OneSchema *s ;
+  explicit Schema (OneSchema *s) : s (s) {}
+public:
+  static Schema fromText (std::string text)
+  { OneSchema *s = oneSchemaCreateFromText (text.data ()) ;
+    if (!s) throw Error ("failed to make a ONE schema from text") ;
+    return Schema (s) ;
+  }
+  static Schema fromFile (std::string path)
+  { OneSchema *s = oneSchemaCreateFromFile (path.data ()) ;
+    if (!s) throw Error ("failed to read ONE schema file " + path) ;
+    return Schema (s) ;
+  }
+  Schema (Schema &&x) : s (x.s) { x.s = nullptr ; }
+  Schema &operator= (Schema &&x) { std::swap (s, x.s) ; return *this ; }
+  ~Schema () { if (s) oneSchemaDestroy (s) ; }
+  OneSchema *get () const { return s ; }
+} ;
+
+class File : public View
+{ explicit File (OneFile *vf) : View (vf) {}
+  static char *cstr (const char *s) { return const_cast<char*> (s) ; }
+public:
+  static File read (const std::string &path, const Schema *schema = nullptr,
+		    const char *type = nullptr, int nthreads = 1)
+  { OneFile *vf = oneFileOpenRead (path.c_str (), schema ? schema->get () : nullptr,
+				   cstr (type), nthreads) ;
+    if (!vf) throw Error ("failed to open ONE file " + path) ;
+    return File (vf) ;
+  }
+  static File writeNew (const std::string &path, const Schema &schema, const char *type,
+			bool isBinary, int nthreads = 1)
+  { OneFile *vf = oneFileOpenWriteNew (path.c_str (), schema.get (), cstr (type),
+				       isBinary, nthreads) ;
+    if (!vf) throw Error ("failed to open ONE file " + path + " to write") ;
+    return File (vf) ;
+  }
+  static File writeFrom (const std::string &path, const View &in, bool isBinary,
+			 int nthreads = 1)
+  { OneFile *vf = oneFileOpenWriteFrom (path.c_str (), in.get (), isBinary, nthreads) ;
+    if (!vf) throw Error ("failed to open ONE file " + path + " to write") ;
+    return File (vf) ;
+  }
+
+  File (File &&x) : View (x.vf) { x.vf = nullptr ; }
+  File &operator= (File &&x) { std::swap (vf, x.vf) ; return *this ; }
+  File (const File &) = delete ;
+  File &operator= (const File &) = delete ;
+  ~File () { close () ; }
+
+  void close () { if (vf) { oneFileClose (vf) ; vf = nullptr ; } }
+  View thread (int i) const { return View (vf + i) ; }
+} ;
+
+  // Field types, for LineDef.  get() reads field k of the current line, put() sets it for
+  //   writing, or for the list field gives its length and buffer.
+
+struct Int
+{ static constexpr OneType type = oneINT ;
+  using value_type = I64 ;
+  static I64 get (OneFile *vf, int k) { return oneInt (vf, k) ; }
+  static void put (OneFile *vf, int k, I64 x, I64 &, const void *&) { oneInt (vf, k) = x ; }
+} ;
+
+struct Real
+{ static constexpr OneType type = oneREAL ;
+  using value_type = double ;
+  static double get (OneFile *vf, int k) { return oneReal (vf, k) ; }
+  static void put (OneFile *vf, int k, double x, I64 &, const void *&) { oneReal (vf, k) = x ; }
+} ;
+
+struct Char
+{ static constexpr OneType type = oneCHAR ;
+  using value_type = char ;
+  static char get (OneFile *vf, int k) { return oneChar (vf, k) ; }
+  static void put (OneFile *vf, int k, char x, I64 &, const void *&) { oneChar (vf, k) = x ; }
+} ;
+
+struct String
+{ static constexpr OneType type = oneSTRING ;
+  using value_type = std::string_view ;
+  static value_type get (OneFile *vf, int) { return { oneString (vf), (size_t) oneLen (vf) } ; }
+  static void put (OneFile *, int, value_type x, I64 &len, const void *&buf)
+  { len = x.size () ; buf = x.data () ; }
+} ;
+
+struct Dna
+{ static constexpr OneType type = oneDNA ;
+  using value_type = std::string_view ;
+  static value_type get (OneFile *vf, int) { return { oneDNAchar (vf), (size_t) oneLen (vf) } ; }
+  static void put (OneFile *, int, value_type x, I64 &len, const void *&buf)
+  { len = x.size () ; buf = x.data () ; }
+} ;
+
+struct IntList
+{ static constexpr OneType type = oneINT_LIST ;
+  using value_type = span<const I64> ;
+  static value_type get (OneFile *vf, int) { return { oneIntList (vf), (size_t) oneLen (vf) } ; }
+  static void put (OneFile *vf, int, value_type x, I64 &len, const void *&buf)
+  { static thread_local std::vector<I64> copy ;	// a binary write packs the list in place
+    len = x.size () ;
+    buf = x.data () ;
+    if (vf->isBinary)
+      { copy.assign (x.begin (), x.end ()) ; buf = copy.data () ; }
+  }
+} ;
+
+struct RealList
+{ static constexpr OneType type = oneREAL_LIST ;
+  using value_type = span<const double> ;
+  static value_type get (OneFile *vf, int) { return { oneRealList (vf), (size_t) oneLen (vf) } ; }
+  static void put (OneFile *, int, value_type x, I64 &len, const void *&buf)
+  { len = x.size () ; buf = x.data () ; }
+} ;
+
+struct StringList
+{ static constexpr OneType type = oneSTRING_LIST ;
+  using value_type = Strings ;
+  static value_type get (OneFile *vf, int) { return { oneString (vf), oneLen (vf) } ; }
+  static void put (OneFile *, int, value_type x, I64 &len, const void *&buf)
+  { len = x.size () ; buf = x.data () ; }
+} ;
+
+  // A line type with fields of the types F..., e.g. LineDef<'W', Int, Int, Int, Real> for
+  //   "D W 4 3 INT 3 INT 3 INT 4 REAL".  get() returns a tuple of the fields of the current
+  //   line, and field<k>() field k, each read directly as its type with no switch on the
+  //   types at run time.  write() sets the fields in order and writes the line.  check()
+  //   throws unless the schema of the file has the line type with these fields, so that
+  //   these are safe, and is() tells at compile time if a schema line has them.
+
+template <char T, class... F>
+struct LineDef
+{ static constexpr char lineType = T ;
+  static constexpr int  nField = sizeof... (F) ;
+  static constexpr std::array<OneType, sizeof... (F)> fieldType = { F::type... } ;
+  using tuple = std::tuple<typename F::value_type...> ;
+  template <int K> using FieldOf = std::tuple_element_t<K, std::tuple<F...>> ;
+
+  static bool matches (OneFile *vf)
+  { OneInfo *li = vf->info[(int) T] ;
+    if (!li || li->nField != nField) return false ;
+    for (int k = 0 ; k < nField ; ++k)
+      if (li->fieldType[k] != fieldType[k]) return false ;
+    return true ;
+  }
+  static void check (const View &f)
+  { if (!matches (f.get ()))
+      throw Error (std::string ("line type ") + T + " of the file does not have the fields expected") ;
+  }
+
+  static constexpr bool is (const char *s)	// a schema line, e.g. "D W 4 3 INT 3 INT 3 INT 4 REAL"
+  { const char *name[] = { "", "INT", "REAL", "CHAR", "STRING", "INT_LIST", "REAL_LIST",
+			   "STRING_LIST", "DNA" } ;
+    I64 n = 0 ;
+    while (*s && *s != ' ') ++s ;		// O, D, G etc.
+    if (*s++ != ' ' || *s++ != T || *s++ != ' ') return false ;
+    if (!readInt (s, n) || n != nField) return false ;
+    for (int k = 0 ; k < nField ; ++k)
+      { I64 len = 0 ;
+	const char *t = name[fieldType[k]] ;
+	if (*s++ != ' ' || !readInt (s, len) || *s++ != ' ') return false ;
+	for (I64 j = 0 ; j < len ; ++j)
+	  if (*s++ != *t++) return false ;
+	if (*t) return false ;
+      }
+    return !*s || *s == ' ' ;
+  }
+
+  static tuple get (const Line &l) { return get (l.get (), std::index_sequence_for<F...> ()) ; }
+  template <int K> static typename FieldOf<K>::value_type field (const Line &l)
+  { return FieldOf<K>::get (l.get (), K) ; }
+
+  static void write (View f, typename F::value_type... x)
+  { write (f.get (), std::index_sequence_for<F...> (), x...) ; }
+
+private:
+  template <size_t... K> static tuple get (OneFile *vf, std::index_sequence<K...>)
+  { return tuple (F::get (vf, K)...) ; }
+
+  template <size_t... K>
+  static void write (OneFile *vf, std::index_sequence<K...>, typename F::value_type... x)
+  { I64 len = 0 ;
+    const void *buf = nullptr ;
+    (F::put (vf, K, x, len, buf), ...) ;
+    oneWriteLine (vf, T, len, const_cast<void*> (buf)) ;
+  }
+
+  static constexpr bool readInt (const char *&s, I64 &n)
+  { if (*s < '0' || *s > '9') return false ;
+    while (*s >= '0' && *s <= '9') n = 10*n + (*s++ - '0') ;
+    return true ;
+  }
+} ;
+
+} // namespace one
+
+#endif // ONE_HPP_DEFINED
+
+/******************* end of file **************/
@@ -0,0 +1,252 @@
+/*  File: ONEmerge.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: merge binary ONE files that are each sorted on a key into one sorted file
+ *   the inputs are streamed through a loser tree and the objects copied directly
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+#include "ONEexpr.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+
+  // Each input is read sequentially through one handle to find the keys of its objects, and
+  //   the objects are copied through a second handle with oneFileCatObjects().
+
+typedef struct {
+  char    *name ;
+  OneFile *vfKey, *vfCopy ;
+  OneKey  *key ;
+  char     lastType ;		// line type read ahead of the current object
+  I64      object ;		// current object, -1 when finished
+  unsigned char *bytes, *prev ;	// key of the current and previous objects
+} Input ;
+
+static Input *in ;
+static int    nIn, keySize ;
+
+static void advance (Input *x)
+{ OneFile *vf = x->vfKey ;
+  char     t ;
+
+  if (x->lastType != vf->objectType)
+    { x->object = -1 ; return ; }
+  x->object = vf->object - 1 ;
+  oneKeyClear (x->key) ;
+  oneKeyRecord (x->key, vf) ; // the object line, already read
+  while ((t = oneReadLine (vf)) && t != vf->objectType)
+    oneKeyRecord (x->key, vf) ;
+  x->lastType = t ;
+
+  unsigned char *swap = x->prev ; x->prev = x->bytes ; x->bytes = swap ;
+  oneKeyBytes (x->key, x->bytes) ;
+  if (x->object > 0 && memcmp (x->bytes, x->prev, keySize) < 0)
+    die ("%s is not sorted on the key at object %" PRId64 "", x->name, x->object) ;
+}
+
+  // The loser tree has the inputs as leaves nIn..2*nIn-1 and holds at each internal node
+  //   the loser of the match there, so that the overall winner needs log(nIn) comparisons
+  //   with the path from its leaf to be replaced.  Ties go to the earlier input.
+
+static int *loser ;
+
+static inline bool isBefore (int a, int b)
+{ int c ;
+  if (in[a].object < 0) return false ;
+  if (in[b].object < 0) return true ;
+  c = memcmp (in[a].bytes, in[b].bytes, keySize) ;
+  return c < 0 || (c == 0 && a < b) ;
+}
+
+static int buildTree (int n)
+{ int a, b ;
+  if (n >= nIn) return n - nIn ;
+  a = buildTree (2*n) ;
+  b = buildTree (2*n+1) ;
+  if (isBefore (a, b)) { loser[n] = b ; return a ; }
+  else                 { loser[n] = a ; return b ; }
+}
+
+static int replay (int winner) // winner has advanced, find the new winner
+{ int n, t ;
+  for (n = (winner + nIn) / 2 ; n >= 1 ; n /= 2)
+    if (isBefore (loser[n], winner))
+      { t = loser[n] ; loser[n] = winner ; winner = t ; }
+  return winner ;
+}
+
+  // consecutive objects from the same input are copied together
+
+#define BATCH 4096
+
+static I64 batch[BATCH] ;
+static int nBatch = 0, batchInput = -1 ;
+
+static void flushObjects (OneFile *vfOut)
+{ if (nBatch)
+    oneFileCatObjects (vfOut, in[batchInput].vfCopy, batch, nBatch) ;
+  nBatch = 0 ;
+}
+
+static void writeGroup (OneFile *vfOut) // fields are zero or empty: sizes come from the index
+{ OneInfo *li = vfOut->info[(int) vfOut->groupType] ;
+  memset (vfOut->field, 0, li->nField*sizeof(OneField)) ;
+  oneWriteLine (vfOut, vfOut->groupType, 0, li->listEltSize ? "" : NULL) ;
+}
+
+int main (int argc, char **argv)
+{
+  int   i ;
+  char *outFileName = 0, *keyText = 0 ;
+  int   nGroupTerms = 0 ;
+  bool  isVerbose = false ;
+
+  timeUpdate (0) ;
+
+  char *command = commandLine (argc, argv) ;
+  --argc ; ++argv ;		/* drop the program name */
+
+  if (!argc)
+    { fprintf (stderr, "ONEmerge [options] -k <key> -o <output> onefile1 onefile2 ...\n") ;
+      fprintf (stderr, "  -k --key <key>            sort key of the inputs, as for ONEsort, e.g. 'A.0,I.0'\n") ;
+      fprintf (stderr, "  -o --output <filename>    output file name - required\n") ;
+      fprintf (stderr, "  -g --group <n>            start a new group whenever the first n key terms change\n") ;
+      fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
+      fprintf (stderr, "inputs must be binary ONE files of the same type, each sorted on the key\n") ;
+      fprintf (stderr, "group lines of the inputs are dropped; the output has groups only with -g\n") ;
+      exit (0) ;
+    }
+
+  while (argc && **argv == '-')
+    if (argc > 1 && (!strcmp (*argv, "-k") || !strcmp (*argv, "--key")))
+      { keyText = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-o") || !strcmp (*argv, "--output")))
+      { outFileName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-g") || !strcmp (*argv, "--group")))
+      { nGroupTerms = atoi (argv[1]) ;
+	if (nGroupTerms < 1) die ("number of key terms to group on %s must be positive", argv[1]) ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
+      { isVerbose = true ; --argc ; ++argv ; }
+    else die ("unknown option %s - run without arguments to see options", *argv) ;
+
+  if (!keyText)
+    die ("need to give the sort key with -k") ;
+  if (!outFileName || !strcmp (outFileName, "-"))
+    die ("need to give a named output file with -o") ;
+  if (argc < 1)
+    die ("need to give at least one input file") ;
+
+  nIn = argc ;
+  in = new0 (nIn, Input) ;
+  for (i = 0 ; i < nIn ; ++i)
+    { Input *x = &in[i] ;
+      x->name = argv[i] ;
+      x->vfKey = oneFileOpenRead (argv[i], 0, 0, 1) ;
+      if (!x->vfKey) die ("failed to open ONE file %s", argv[i]) ;
+      if (!x->vfKey->isBinary) die ("%s is not a binary ONE file - convert with ONEview -b", argv[i]) ;
+      if (strcmp (x->vfKey->fileType, in[0].vfKey->fileType))
+	die ("file type %s of %s differs from %s of %s",
+	     x->vfKey->fileType, argv[i], in[0].vfKey->fileType, argv[0]) ;
+      x->vfCopy = oneFileOpenRead (argv[i], 0, 0, 1) ;
+      if (!(x->key = oneKeyCreate (x->vfKey, keyText)))
+	die ("failed to parse sort key for %s", argv[i]) ;
+      keySize = oneKeySize (x->key) ;
+      x->bytes = new (keySize, unsigned char) ;
+      x->prev  = new (keySize, unsigned char) ;
+    }
+  if (nGroupTerms*8 > keySize)
+    die ("can't group on %d terms of a key with %d", nGroupTerms, keySize/8) ;
+
+  OneFile *vfOut = oneFileOpenWriteFrom (outFileName, in[0].vfKey, true, 1) ;
+  if (!vfOut) die ("failed to open output file %s", outFileName) ;
+  if (nGroupTerms && !vfOut->groupType)
+    die ("files of type %s have no groups", vfOut->fileType) ;
+  for (i = 1 ; i < nIn ; ++i)
+    oneInheritNewProvenance (vfOut, in[i].vfKey) ;
+  oneAddProvenance (vfOut, "ONEmerge", "0.0", command, 0) ;
+  { char t ; int field ;     // declare the order if the first term allows binary search
+    if (oneKeyFirstTerm (in[0].key, &t, &field)) oneSetSorted (vfOut, t, field) ;
+  }
+  for (i = 0 ; i < nIn ; ++i)
+    oneInheritCodecs (vfOut, in[i].vfKey) ;
+  oneWriteHeader (vfOut) ;
+
+  // read up to the first object of each input, copying lines before it in the first input
+
+  for (i = 0 ; i < nIn ; ++i)
+    { OneFile *vf = in[i].vfKey ;
+      char     t ;
+      while ((t = oneReadLine (vf)) && t != vf->objectType)
+	if (i == 0 && t != vf->groupType)
+	  { OneInfo *li = vf->info[(int)t] ;
+	    memcpy (vfOut->field, vf->field, li->nField*sizeof(OneField)) ;
+	    oneWriteLine (vfOut, t, oneLen(vf), li->listEltSize ? oneList(vf) : NULL) ;
+	  }
+      in[i].lastType = t ;
+      advance (&in[i]) ;
+    }
+
+  // merge
+
+  I64            nObj = 0, nGroup = 0 ;
+  unsigned char *groupKey = new (keySize, unsigned char) ;
+  int            w ;
+
+  loser = new (nIn, int) ;
+  w = buildTree (1) ;
+  while (in[w].object >= 0)
+    { if (nGroupTerms && (!nObj || memcmp (in[w].bytes, groupKey, 8*nGroupTerms)))
+	{ flushObjects (vfOut) ;
+	  writeGroup (vfOut) ;
+	  memcpy (groupKey, in[w].bytes, keySize) ;
+	  ++nGroup ;
+	}
+      if (w != batchInput || nBatch == BATCH)
+	{ flushObjects (vfOut) ;
+	  batchInput = w ;
+	}
+      batch[nBatch++] = in[w].object ;
+      ++nObj ;
+      advance (&in[w]) ;
+      w = replay (w) ;
+    }
+  flushObjects (vfOut) ;
+
+  if (isVerbose)
+    { fprintf (stderr, "merged %" PRId64 " objects from %d files", nObj, nIn) ;
+      if (nGroupTerms) fprintf (stderr, " into %" PRId64 " groups", nGroup) ;
+      fprintf (stderr, "\n") ;
+    }
+
+  oneFileClose (vfOut) ;
+  for (i = 0 ; i < nIn ; ++i)
+    { oneFileClose (in[i].vfKey) ;
+      oneFileClose (in[i].vfCopy) ;
+      oneKeyDestroy (in[i].key) ;
+      free (in[i].bytes) ;
+      free (in[i].prev) ;
+    }
+  free (in) ;
+  free (loser) ;
+  free (groupKey) ;
+  free (command) ;
+
+  if (isVerbose)
+    timeTotal (stderr) ;
+
+  exit (0) ;
+}
+
+/******************* end of file **************/
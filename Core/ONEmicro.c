@@ -0,0 +1,546 @@
+/*  File: ONEmicro.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: microbenchmarks for the integer, list and codec kernels of ONElib
+ *   Includes ONElib.c so that its static inline kernels can be timed directly.  Each kernel
+ *   runs in isolation on its own corpus, with warmup runs followed by timed repetitions,
+ *   and is reported as one tab separated line with timing statistics, GB/s and cycles/byte.
+ *   Throughput is always measured in bytes of uncompressed data.
+ *   Replaces the TEST_INT/TEST_LTF harness formerly at the end of ONElib.c.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "ONElib.c"
+
+#include <math.h>
+
+typedef unsigned long long U64 ;
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES() __rdtsc()	// reference cycles, at the nominal clock rate
+#else
+#define CYCLES() 0		// so cycles/byte is reported as 0
+#endif
+
+/***********************************************************************************
+ *
+ *    LTF encoding for integers
+ *    adapted from htslib/cram/cram_io.h with copyright statement:
+
+Copyright (c) 2012-2019 Genome Research Ltd.
+Author: James Bonfield <jkb@sanger.ac.uk>
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+   3. Neither the names Genome Research Ltd and Wellcome Trust Sanger
+Institute nor the names of its contributors may be used to endorse or promote
+products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY GENOME RESEARCH LTD AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL GENOME RESEARCH LTD OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ **********************************************************************************/
+
+/* 64-bit itf8 variant */
+
+static inline int ltf8_put(char *cp, int64_t val) {
+    unsigned char *up = (unsigned char *)cp;
+    if        (!(val & ~((1LL<<7)-1))) {
+        *up = val;
+        return 1;
+    } else if (!(val & ~((1LL<<(6+8))-1))) {
+        *up++ = (val >> 8 ) | 0x80;
+        *up   = val & 0xff;
+        return 2;
+    } else if (!(val & ~((1LL<<(5+2*8))-1))) {
+        *up++ = (val >> 16) | 0xc0;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 3;
+    } else if (!(val & ~((1LL<<(4+3*8))-1))) {
+        *up++ = (val >> 24) | 0xe0;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 4;
+    } else if (!(val & ~((1LL<<(3+4*8))-1))) {
+        *up++ = (val >> 32) | 0xf0;
+        *up++ = (val >> 24) & 0xff;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 5;
+    } else if (!(val & ~((1LL<<(2+5*8))-1))) {
+        *up++ = (val >> 40) | 0xf8;
+        *up++ = (val >> 32) & 0xff;
+        *up++ = (val >> 24) & 0xff;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 6;
+    } else if (!(val & ~((1LL<<(1+6*8))-1))) {
+        *up++ = (val >> 48) | 0xfc;
+        *up++ = (val >> 40) & 0xff;
+        *up++ = (val >> 32) & 0xff;
+        *up++ = (val >> 24) & 0xff;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 7;
+    } else if (!(val & ~((1LL<<(7*8))-1))) {
+        *up++ = (val >> 56) | 0xfe;
+        *up++ = (val >> 48) & 0xff;
+        *up++ = (val >> 40) & 0xff;
+        *up++ = (val >> 32) & 0xff;
+        *up++ = (val >> 24) & 0xff;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 8;
+    } else {
+        *up++ = 0xff;
+        *up++ = (val >> 56) & 0xff;
+        *up++ = (val >> 48) & 0xff;
+        *up++ = (val >> 40) & 0xff;
+        *up++ = (val >> 32) & 0xff;
+        *up++ = (val >> 24) & 0xff;
+        *up++ = (val >> 16) & 0xff;
+        *up++ = (val >> 8 ) & 0xff;
+        *up   = val & 0xff;
+        return 9;
+    }
+}
+
+static inline int ltf8_get(char *cp, int64_t *val_p) {
+    unsigned char *up = (unsigned char *)cp;
+
+    if (up[0] < 0x80) {
+        *val_p =   up[0];
+        return 1;
+    } else if (up[0] < 0xc0) {
+        *val_p = (((uint64_t)up[0]<< 8) |
+                   (uint64_t)up[1]) & (((1LL<<(6+8)))-1);
+        return 2;
+    } else if (up[0] < 0xe0) {
+        *val_p = (((uint64_t)up[0]<<16) |
+                  ((uint64_t)up[1]<< 8) |
+                   (uint64_t)up[2]) & ((1LL<<(5+2*8))-1);
+        return 3;
+    } else if (up[0] < 0xf0) {
+        *val_p = (((uint64_t)up[0]<<24) |
+                  ((uint64_t)up[1]<<16) |
+                  ((uint64_t)up[2]<< 8) |
+                   (uint64_t)up[3]) & ((1LL<<(4+3*8))-1);
+        return 4;
+    } else if (up[0] < 0xf8) {
+        *val_p = (((uint64_t)up[0]<<32) |
+                  ((uint64_t)up[1]<<24) |
+                  ((uint64_t)up[2]<<16) |
+                  ((uint64_t)up[3]<< 8) |
+                   (uint64_t)up[4]) & ((1LL<<(3+4*8))-1);
+        return 5;
+    } else if (up[0] < 0xfc) {
+        *val_p = (((uint64_t)up[0]<<40) |
+                  ((uint64_t)up[1]<<32) |
+                  ((uint64_t)up[2]<<24) |
+                  ((uint64_t)up[3]<<16) |
+                  ((uint64_t)up[4]<< 8) |
+                   (uint64_t)up[5]) & ((1LL<<(2+5*8))-1);
+        return 6;
+    } else if (up[0] < 0xfe) {
+        *val_p = (((uint64_t)up[0]<<48) |
+                  ((uint64_t)up[1]<<40) |
+                  ((uint64_t)up[2]<<32) |
+                  ((uint64_t)up[3]<<24) |
+                  ((uint64_t)up[4]<<16) |
+                  ((uint64_t)up[5]<< 8) |
+                   (uint64_t)up[6]) & ((1LL<<(1+6*8))-1);
+        return 7;
+    } else if (up[0] < 0xff) {
+        *val_p = (((uint64_t)up[1]<<48) |
+                  ((uint64_t)up[2]<<40) |
+                  ((uint64_t)up[3]<<32) |
+                  ((uint64_t)up[4]<<24) |
+                  ((uint64_t)up[5]<<16) |
+                  ((uint64_t)up[6]<< 8) |
+                   (uint64_t)up[7]) & ((1LL<<(7*8))-1);
+        return 8;
+    } else {
+        *val_p = (((uint64_t)up[1]<<56) |
+                  ((uint64_t)up[2]<<48) |
+                  ((uint64_t)up[3]<<40) |
+                  ((uint64_t)up[4]<<32) |
+                  ((uint64_t)up[5]<<24) |
+                  ((uint64_t)up[6]<<16) |
+                  ((uint64_t)up[7]<< 8) |
+                   (uint64_t)up[8]);
+        return 9;
+    }
+}
+
+
+/****************** corpora ******************/
+
+static I64   nInt ;		// number of integers in integer corpora
+static I64  *ints ;		// integer corpus for the current kernel
+static U8   *code ;		// encoded integers
+static I64   codeLen ;
+static I64  *decoded ;
+
+static I64   nChar ;		// size of character corpora
+static char *text ;		// character corpus for the current kernel
+static char *coded ;		// its encoding, chunk by chunk
+static char *codedSave ;	// copy of coded, since vcDecode() byte swaps its input in place
+static int  *chunkBits ;	// bits used by each encoded chunk
+static int   chunkLen ;		// length of chunks, as for the lists of a line
+static char *plain ;		// decoded text
+static OneCodec *codec ;
+
+#define LIST_LEN 100		// length of int lists for compactIntList()
+static I64  *lists, *work, *compacted ;
+static I64   nList ;
+static int  *usedBytes ;
+static OneFile *vfDummy ;
+static OneInfo *liDummy ;
+
+static inline U64 rnd (U64 *s)	// splitmix64
+{ U64 z = (*s += 0x9e3779b97f4a7c15ULL) ;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL ;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL ;
+  return z ^ (z >> 31) ;
+}
+
+static void makeInts (char *corpus)
+{ U64 s = 1 ;
+  I64 i ;
+  for (i = 0 ; i < nInt ; ++i)
+    { U64 r = rnd (&s) ;
+      switch (*corpus)
+	{
+	case 's': ints[i] = r & 0x3f ; break ;			// small: one byte
+	case 'm': ints[i] = (I64)(r % 16384) - 8192 ; break ;	// medium: +-8192
+	case 'l': ints[i] = (I64)(r & 0xffffffff) ; break ;	// large: 32 bit
+	case 'x': ints[i] = (I64)((r >> 8) & ((1LL << (r % 41)) - 1)) ; // mixed: log uniform
+	  if (r & 0x80) ints[i] = -ints[i] ;
+	  break ;
+	}
+    }
+}
+
+static void makeText (char *corpus)
+{ U64 s = 2 ;
+  I64 i ;
+  int q = 30 ;
+  for (i = 0 ; i < nChar ; ++i)
+    { U64 r = rnd (&s) ;
+      switch (*corpus)
+	{
+	case 'd': text[i] = "acgt"[r & 3] ; break ;		// dna
+	case 'q':						// qv: random walk
+	  q += (int)(r % 5) - 2 ; if (q < 0) q = 0 ; else if (q > 40) q = 40 ;
+	  text[i] = '!' + q ; break ;
+	case 'a':						// arrow pulse widths 1-4
+	  r %= 100 ; text[i] = r < 50 ? '1' : r < 80 ? '2' : r < 95 ? '3' : '4' ; break ;
+	case 'n':						// read names
+	  i += sprintf (text+i, "m54%03d_%06d/%lld/ccs", (int)(r % 1000), (int)((r >> 10) % 1000000),
+			(long long) (r >> 40) % 4000000) - 1 ;
+	  break ;
+	}
+    }
+}
+
+/****************** kernels ******************/
+
+static void prepNone (void) { }
+
+static void runIntPut (void)
+{ U8 *u = code ; I64 i ;
+  for (i = 0 ; i < nInt ; ++i) u += intPut (u, ints[i]) ;
+  codeLen = u - code ;
+}
+
+static void runIntGet (void)
+{ U8 *u = code ; I64 i ;
+  for (i = 0 ; i < nInt ; ++i) u += intGet (u, &decoded[i]) ;
+}
+
+static void runLtf8Put (void)
+{ U8 *u = code ; I64 i ;
+  for (i = 0 ; i < nInt ; ++i) u += ltf8_put ((char*)u, ints[i]) ;
+  codeLen = u - code ;
+}
+
+static void runLtf8Get (void)
+{ U8 *u = code ; I64 i ;
+  for (i = 0 ; i < nInt ; ++i) u += ltf8_get ((char*)u, &decoded[i]) ;
+}
+
+static FILE *memFile ;
+
+static void prepLtfFile (void) { rewind (memFile) ; }
+
+static void runLtfWrite (void)
+{ I64 i ;
+  for (i = 0 ; i < nInt ; ++i) ltfWrite (ints[i], memFile) ;
+  fflush (memFile) ;
+}
+
+static void runLtfRead (void)
+{ I64 i ;
+  for (i = 0 ; i < nInt ; ++i) decoded[i] = ltfRead (memFile) ;
+}
+
+static void runEncode (void)
+{ I64 i, j ;
+  for (i = j = 0 ; i < nChar ; i += chunkLen, ++j)
+    chunkBits[j] = vcEncode (codec, chunkLen, text + i, coded + 2*i) ;
+}
+
+static void prepDecode (void) { memcpy (coded, codedSave, 2*nChar) ; }
+
+static void runDecode (void)
+{ I64 i, j ;
+  for (i = j = 0 ; i < nChar ; i += chunkLen, ++j)
+    vcDecode (codec, chunkBits[j], coded + 2*i, plain + i) ;
+}
+
+static void runCompressDNA (void)
+{ I64 i, j ;
+  for (i = j = 0 ; i < nChar ; i += chunkLen, ++j)
+    chunkBits[j] = Compress_DNA (chunkLen, text + i, coded + i) ;
+}
+
+static void runUncompressDNA (void)
+{ I64 i ;
+  for (i = 0 ; i < nChar ; i += chunkLen)
+    Uncompress_DNA (coded + i, chunkLen, plain + i) ;
+}
+
+static void prepCompact (void)	// compactIntList() overwrites its input
+{ memcpy (work, lists, nList * LIST_LEN * sizeof(I64)) ; }
+
+static void runCompact (void)	// compacted lists are copied back as oneWriteLine() would write them
+{ I64 j ;
+  for (j = 0 ; j < nList ; ++j)
+    { char *b = compactIntList (vfDummy, liDummy, LIST_LEN, (char*)(work + j*LIST_LEN), &usedBytes[j]) ;
+      memcpy (work + j*LIST_LEN + 1, b, (LIST_LEN-1) * usedBytes[j]) ;
+    }
+}
+
+static void prepDecompact (void) // decompactIntList() works in place
+{ memcpy (work, compacted, nList * LIST_LEN * sizeof(I64)) ; }
+
+static void runDecompact (void)
+{ I64 j ;
+  for (j = 0 ; j < nList ; ++j)
+    decompactIntList (vfDummy, LIST_LEN, (char*)(work + j*LIST_LEN), usedBytes[j]) ;
+}
+
+/****************** set up and checks for each kernel ******************/
+
+typedef struct {
+  char  *name ;
+  char  *corpora ;		// comma separated list
+  void (*prep) (void) ;		// untimed, before each run
+  void (*run) (void) ;		// timed
+} Kernel ;
+
+static Kernel kernels[] = {
+  { "intPut",          "small,medium,large,mixed", prepNone, runIntPut },
+  { "intGet",          "small,medium,large,mixed", prepNone, runIntGet },
+  { "ltf8_put",        "small,medium,large,mixed", prepNone, runLtf8Put },
+  { "ltf8_get",        "small,medium,large,mixed", prepNone, runLtf8Get },
+  { "ltfWrite",        "small,medium,large,mixed", prepLtfFile, runLtfWrite },
+  { "ltfRead",         "small,medium,large,mixed", prepLtfFile, runLtfRead },
+  { "vcEncode",        "qv,arrow,names",           prepNone, runEncode },
+  { "vcDecode",        "qv,arrow,names",           prepDecode, runDecode },
+  { "Compress_DNA",    "dna",                      prepNone, runCompressDNA },
+  { "Uncompress_DNA",  "dna",                      prepNone, runUncompressDNA },
+  { "compactIntList",  "trace,sites",              prepCompact, runCompact },
+  { "decompactIntList","trace,sites",              prepDecompact, runDecompact },
+  { 0, 0, 0, 0 }
+} ;
+
+static I64 setUp (Kernel *k, char *corpus)	// returns the bytes of raw data per run
+{ I64 i, j ;
+
+  if (!strncmp (k->name, "int", 3) || !strncmp (k->name, "ltf", 3))
+    { makeInts (corpus) ;
+      if (!strcmp (k->name, "ltfWrite") || !strcmp (k->name, "ltfRead"))
+	{ if (memFile) fclose (memFile) ;
+	  if (!(memFile = fmemopen (code, 9*nInt+16, "w+"))) die ("fmemopen failed") ;
+	  if (!strcmp (k->name, "ltfRead")) { runLtfWrite () ; rewind (memFile) ; }
+	}
+      else if (!strcmp (k->name, "intGet")) runIntPut () ;
+      else if (!strcmp (k->name, "ltf8_get")) runLtf8Put () ;
+      return nInt * sizeof(I64) ;
+    }
+  else if (!strncmp (k->name, "vc", 2))
+    { makeText (corpus) ;
+      chunkLen = (*corpus == 'n') ? 32 : 10000 ;
+      if (codec) vcDestroy (codec) ;
+      codec = vcCreate () ;
+      for (i = 0 ; i < nChar ; i += chunkLen) vcAddToTable (codec, chunkLen, text + i) ;
+      vcCreateCodec (codec, 1) ;
+      runEncode () ;
+      memcpy (codedSave, coded, 2*nChar) ;
+      return nChar ;
+    }
+  else if (strstr (k->name, "DNA"))
+    { makeText ("dna") ;
+      chunkLen = 10000 ;
+      runCompressDNA () ;
+      return nChar ;
+    }
+  else			// compactIntList and decompactIntList
+    { U64 s = 3 ;
+      for (j = 0 ; j < nList ; ++j)
+	for (i = 0 ; i < LIST_LEN ; ++i)
+	  { I64 *x = lists + j*LIST_LEN + i ;
+	    if (*corpus == 't') *x = 95 + rnd(&s) % 11 ;		// trace point spacings
+	    else *x = (i ? x[-1] : 0) + 1 + rnd(&s) % 10000 ;	// increasing site positions
+	  }
+      if (!strcmp (k->name, "decompactIntList"))
+	{ prepCompact () ; runCompact () ;
+	  memcpy (compacted, work, nList * LIST_LEN * sizeof(I64)) ;
+	}
+      return nList * LIST_LEN * sizeof(I64) ;
+    }
+}
+
+static void check (Kernel *k)	// after the timed runs, check decoders against their input
+{ I64 i ;
+  if (!strcmp (k->name, "intGet") || !strcmp (k->name, "ltfRead") || !strcmp (k->name, "ltf8_get"))
+    { for (i = 0 ; i < nInt ; ++i)
+	if (decoded[i] != ints[i]) die ("%s mismatch at %lld", k->name, (long long) i) ;
+    }
+  else if (!strcmp (k->name, "vcDecode") || !strcmp (k->name, "Uncompress_DNA"))
+    { if (memcmp (plain, text, nChar - nChar % chunkLen)) die ("%s mismatch", k->name) ; }
+  else if (!strcmp (k->name, "decompactIntList"))
+    { if (memcmp (work, lists, nList * LIST_LEN * sizeof(I64))) die ("%s mismatch", k->name) ; }
+}
+
+/****************** timing ******************/
+
+static int compareDouble (const void *a, const void *b)
+{ double x = *(double*)a, y = *(double*)b ;
+  return (x < y) ? -1 : (x > y) ? 1 : 0 ;
+}
+
+static int compareCycles (const void *a, const void *b)
+{ U64 x = *(U64*)a, y = *(U64*)b ;
+  return (x < y) ? -1 : (x > y) ? 1 : 0 ;
+}
+
+static void bench (Kernel *k, char *corpus, int nWarm, int nRep)
+{ double *secs = new (nRep, double) ;
+  U64    *cycles = new (nRep, U64) ;
+  I64     bytes = setUp (k, corpus) ;
+  double  mean = 0, sd = 0, median ;
+  int     i ;
+
+  for (i = 0 ; i < nWarm ; ++i) { k->prep () ; k->run () ; }
+  for (i = 0 ; i < nRep ; ++i)
+    { struct timespec t0, t1 ;
+      U64 c0 ;
+      k->prep () ;
+      clock_gettime (CLOCK_MONOTONIC, &t0) ;
+      c0 = CYCLES() ;
+      k->run () ;
+      cycles[i] = CYCLES() - c0 ;
+      clock_gettime (CLOCK_MONOTONIC, &t1) ;
+      secs[i] = (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec) ;
+    }
+  check (k) ;
+
+  for (i = 0 ; i < nRep ; ++i) mean += secs[i] ;
+  mean /= nRep ;
+  for (i = 0 ; i < nRep ; ++i) sd += (secs[i] - mean) * (secs[i] - mean) ;
+  sd = nRep > 1 ? sqrt (sd / (nRep - 1)) : 0 ;
+  qsort (cycles, nRep, sizeof(U64), compareCycles) ;
+  qsort (secs, nRep, sizeof(double), compareDouble) ;
+  median = secs[nRep/2] ;
+
+  printf ("%s\t%s\t%lld\t%d\t%.6f\t%.6f\t%.6f\t%.6f\t%.3f\t%.3f\t%.3f\n",
+	  k->name, corpus, (long long) bytes, nRep, secs[0], median, mean, sd,
+	  bytes / (1e9 * secs[0]), bytes / (1e9 * median), (double) cycles[nRep/2] / bytes) ;
+  fflush (stdout) ;
+  free (secs) ; free (cycles) ;
+}
+
+/****************** main ******************/
+
+int main (int argc, char **argv)
+{
+  I64     megabytes = 16 ;
+  int     nWarm = 2, nRep = 11 ;
+  Kernel *k ;
+
+  --argc ; ++argv ;		/* drop the program name */
+  while (argc && **argv == '-')
+    if (!strcmp (*argv, "-s") && argc > 1)
+      { megabytes = atoll (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-w") && argc > 1)
+      { nWarm = atoi (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-r") && argc > 1)
+      { nRep = atoi (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else
+      { fprintf (stderr, "ONEmicro [options] [kernel[:corpus]]*\n") ;
+	fprintf (stderr, "  -s <MB>     raw data per run [16]\n") ;
+	fprintf (stderr, "  -w <n>      warmup runs [2]\n") ;
+	fprintf (stderr, "  -r <n>      timed repetitions [11]\n") ;
+	fprintf (stderr, "kernels with their corpora, default all:\n") ;
+	for (k = kernels ; k->name ; ++k) fprintf (stderr, "  %-18s %s\n", k->name, k->corpora) ;
+	exit (1) ;
+      }
+  if (megabytes < 1 || nWarm < 0 || nRep < 1) die ("bad size, warmup or repetition count") ;
+
+  nInt = (megabytes * 1000000) / sizeof(I64) ;
+  ints = new (nInt, I64) ; decoded = new (nInt, I64) ; code = new (9*nInt+16, U8) ;
+  nChar = megabytes * 1000000 ;
+  text = new (nChar+64, char) ; plain = new (nChar+64, char) ; coded = new (2*nChar+64, char) ;
+  codedSave = new (2*nChar+64, char) ;
+  chunkBits = new (nChar/32 + 1, int) ;
+  nList = nInt / LIST_LEN ;
+  lists = new (nList*LIST_LEN, I64) ; work = new (nList*LIST_LEN, I64) ;
+  compacted = new (nList*LIST_LEN, I64) ;
+  usedBytes = new (nList, int) ;
+  vfDummy = new0 (1, OneFile) ; liDummy = new0 (1, OneInfo) ;
+  { int t = 1 ; vfDummy->isBig = (*(char*)&t == 0) ; }
+
+  printf ("#kernel\tcorpus\tbytes\treps\tmin_s\tmedian_s\tmean_s\tsd_s\tGB/s_best\tGB/s_median\tcycles/byte\n") ;
+  for (k = kernels ; k->name ; ++k)
+    { char corpora[64], *corpus ;
+      int  i ;
+      for (i = 0 ; i < argc ; ++i) if (!strncmp (argv[i], k->name, strlen(k->name))) break ;
+      if (argc && i == argc) continue ;
+      strcpy (corpora, (argc && argv[i][strlen(k->name)] == ':') ? argv[i]+strlen(k->name)+1 : k->corpora) ;
+      for (corpus = strtok (corpora, ",") ; corpus ; corpus = strtok (0, ","))
+	bench (k, corpus, nWarm, nRep) ;
+    }
+
+  exit (0) ;
+}
+
+/********************* end of file ***********************/
@@ -0,0 +1,346 @@
+/*  File: ONEresolve.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: fetch the objects of the files referred to by the '<' lines of a ONE file
+ *   the cache is a hash table of objects on a doubly linked list in order of last use
+ * Exported functions: see ONEresolve.h
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEresolve.h"
+
+#include <string.h>
+#include <pthread.h>
+
+#define DEFAULT_BYTES ((I64) 1 << 28)
+
+typedef struct EntryStruct
+  { OneResolved  ro ;		// must be first, as it is what the user holds
+    I64          bytes ;
+    int          held ;		// number of oneResolve() calls not yet released
+    bool         isCached ;	// false once dropped, so freed on its last release
+    struct EntryStruct *prev, *next ; // in order of last use, most recent first
+    struct EntryStruct *hashNext ;
+  } Entry ;
+
+typedef struct
+  { char     *name ;
+    OneFile  *vf ;		// opened on first use
+    bool      isTried ;
+    pthread_mutex_t lock ;	// held while reading vf
+  } Ref ;
+
+struct OneResolverStruct
+  { int      nRef ;
+    Ref     *ref ;
+    char    *dir ;		// of the referring file, with trailing '/', or 0
+    I64      maxBytes, bytes ;
+    I64      nEntry ;
+    int      hashBits ;
+    Entry  **bucket ;
+    Entry   *first, *last ;
+    I64      nHit, nMiss, nDrop ;
+    pthread_mutex_t lock ;	// held while using the cache
+  } ;
+
+/************************** cache ***************************/
+
+static inline I64 hashBucket (OneResolver *rv, int ref, I64 i)
+{ U64 key = (U64) i * rv->nRef + ref ;
+  return (I64) ((key * 0x9e3779b97f4a7c15ull) >> (64 - rv->hashBits)) ;
+}
+
+static Entry *hashFind (OneResolver *rv, int ref, I64 i)
+{ Entry *e ;
+
+  for (e = rv->bucket[hashBucket (rv, ref, i)] ; e ; e = e->hashNext)
+    if (e->ro.index == i && e->ro.ref == ref)
+      return e ;
+  return 0 ;
+}
+
+static void hashAdd (OneResolver *rv, Entry *e)
+{ I64 b = hashBucket (rv, e->ro.ref, e->ro.index) ;
+
+  e->hashNext = rv->bucket[b] ;
+  rv->bucket[b] = e ;
+}
+
+static void hashRemove (OneResolver *rv, Entry *e)
+{ Entry **pe = &rv->bucket[hashBucket (rv, e->ro.ref, e->ro.index)] ;
+
+  while (*pe != e)
+    pe = &(*pe)->hashNext ;
+  *pe = e->hashNext ;
+}
+
+static void hashGrow (OneResolver *rv)
+{ Entry **old = rv->bucket, *e, *eNext ;
+  I64     b, nOld = (I64) 1 << rv->hashBits ;
+
+  ++rv->hashBits ;
+  rv->bucket = new0 ((I64) 1 << rv->hashBits, Entry*) ;
+  for (b = 0 ; b < nOld ; ++b)
+    for (e = old[b] ; e ; e = eNext)
+      { eNext = e->hashNext ;
+	hashAdd (rv, e) ;
+      }
+  free (old) ;
+}
+
+static void useUnlink (OneResolver *rv, Entry *e)
+{ if (e->prev) e->prev->next = e->next ; else rv->first = e->next ;
+  if (e->next) e->next->prev = e->prev ; else rv->last = e->prev ;
+}
+
+static void useFirst (OneResolver *rv, Entry *e)
+{ e->prev = 0 ;
+  e->next = rv->first ;
+  if (rv->first) rv->first->prev = e ; else rv->last = e ;
+  rv->first = e ;
+}
+
+static void entryFree (Entry *e)
+{ int j ;
+
+  for (j = 0 ; j < e->ro.nLine ; ++j)
+    free (e->ro.line[j].field) ; // the list shares its allocation
+  free (e->ro.line) ;
+  free (e) ;
+}
+
+static void entryDrop (OneResolver *rv, Entry *e)
+{ hashRemove (rv, e) ;
+  useUnlink (rv, e) ;
+  rv->bytes -= e->bytes ;
+  --rv->nEntry ;
+  ++rv->nDrop ;
+  e->isCached = false ;
+  if (!e->held)
+    entryFree (e) ;
+}
+
+/********************** referenced files ********************/
+
+static bool refOpen (OneResolver *rv, Ref *r)
+{ r->isTried = true ;
+
+  FILE *f = fopen (r->name, "r") ;
+  if (!f && rv->dir && *r->name != '/')
+    { char *s = new (strlen(rv->dir) + strlen(r->name) + 1, char) ;
+      strcpy (s, rv->dir) ;
+      strcat (s, r->name) ;
+      if ((f = fopen (s, "r")))
+	{ free (r->name) ;
+	  r->name = s ;
+	}
+      else
+	free (s) ;
+    }
+  if (!f)
+    { fprintf (stderr, "can't find referenced file %s\n", r->name) ;
+      return false ;
+    }
+  fclose (f) ;
+
+  if (!(r->vf = oneFileOpenRead (r->name, 0, 0, 1)))
+    fprintf (stderr, "can't open referenced file %s as a ONE file\n", r->name) ;
+  else if (!r->vf->isBinary || !r->vf->isIndexIn || !r->vf->objectType)
+    { fprintf (stderr, "referenced file %s is not binary with an object index\n", r->name) ;
+      oneFileClose (r->vf) ;
+      r->vf = 0 ;
+    }
+  return r->vf != 0 ;
+}
+
+  // Read object i of the file of r into a new entry.  The object ends at the start of the
+  //   next object, so lines are read while the file position is before that, stopping at a
+  //   group line, which comes between objects.
+
+static Entry *entryRead (Ref *r, int ref, I64 i)
+{ OneFile *vf = r->vf ;
+  I64      nObj = vf->info[(int) vf->objectType]->given.count ;
+  I64      end = (i+1 < nObj) ? ((I64 *) vf->info['&']->buffer)[i+1] : vf->footOff - 1 ;
+  int      nMax = 4 ;
+  char     t ;
+
+  if (!oneGotoObject (vf, i) || oneReadLine (vf) != vf->objectType)
+    return 0 ;
+
+  Entry *e = new0 (1, Entry) ;
+  e->ro.ref   = ref ;
+  e->ro.index = i ;
+  e->ro.line  = new (nMax, OneResolvedLine) ;
+  e->bytes    = sizeof(Entry) ;
+  e->isCached = true ;
+  t = vf->lineType ;
+  do
+    { OneInfo         *li = vf->info[(int) t] ;
+      OneResolvedLine *rl ;
+      I64              size = 0 ;
+      char            *list = 0 ;
+
+      if (e->ro.nLine == nMax)
+	{ resize (e->ro.line, nMax, 2*nMax, OneResolvedLine) ;
+	  nMax *= 2 ;
+	}
+      rl = &e->ro.line[e->ro.nLine++] ;
+      rl->lineType = t ;
+      rl->listLen  = 0 ;
+      if (li->listEltSize)
+	{ OneType type = li->fieldType[li->listField] ;
+	  rl->listLen = oneLen (vf) ;
+	  list = (char *) oneList (vf) ;
+	  if (type == oneSTRING_LIST) // a series of 0 terminated strings
+	    { char *s = list ;
+	      I64   k ;
+	      for (k = 0 ; k < rl->listLen ; ++k)
+		s += strlen (s) + 1 ;
+	      size = s - list ;
+	    }
+	  else // STRING and DNA are not always 0 terminated when read, so terminate them below
+	    size = rl->listLen * li->listEltSize ;
+	}
+      rl->field = (OneField *) new (li->nField*sizeof(OneField) + size + 1, char) ;
+      memcpy (rl->field, vf->field, li->nField*sizeof(OneField)) ;
+      if (li->listEltSize)
+	{ rl->list = (char *) (rl->field + li->nField) ;
+	  memcpy (rl->list, list, size) ;
+	  ((char *) rl->list)[size] = 0 ;
+	}
+      else
+	rl->list = 0 ;
+      e->bytes += sizeof(OneResolvedLine) + li->nField*sizeof(OneField) + size + 1 ;
+    }
+  while (ftello (vf->f) < end && (t = oneReadLine (vf))
+	 && t != vf->objectType && t != vf->groupType) ;
+
+  return e ;
+}
+
+/************************* interface ************************/
+
+OneResolver *oneResolverCreate (OneFile *vf, char *path, I64 maxBytes)
+{ OneResolver *rv = new0 (1, OneResolver) ;
+  int          k ;
+
+  rv->nRef = vf->info['<']->accum.count ;
+  rv->ref  = new0 (rv->nRef ? rv->nRef : 1, Ref) ;
+  for (k = 0 ; k < rv->nRef ; ++k)
+    { rv->ref[k].name = new (strlen(vf->reference[k].filename) + 1, char) ;
+      strcpy (rv->ref[k].name, vf->reference[k].filename) ;
+      pthread_mutex_init (&rv->ref[k].lock, NULL) ;
+    }
+  if (path && strrchr (path, '/'))
+    { int len = strrchr (path, '/') - path + 1 ;
+      rv->dir = new0 (len+1, char) ;
+      strncpy (rv->dir, path, len) ;
+    }
+  rv->maxBytes = maxBytes > 0 ? maxBytes : DEFAULT_BYTES ;
+  rv->hashBits = 10 ;
+  rv->bucket   = new0 ((I64) 1 << rv->hashBits, Entry*) ;
+  pthread_mutex_init (&rv->lock, NULL) ;
+  return rv ;
+}
+
+void oneResolverDestroy (OneResolver *rv)
+{ int k ;
+
+  while (rv->first)
+    { if (rv->first->held)
+	die ("resolver destroyed while object %" PRId64 " of reference %d is held",
+	     rv->first->ro.index, rv->first->ro.ref) ;
+      entryDrop (rv, rv->first) ;
+    }
+  for (k = 0 ; k < rv->nRef ; ++k)
+    { if (rv->ref[k].vf)
+	oneFileClose (rv->ref[k].vf) ;
+      free (rv->ref[k].name) ;
+      pthread_mutex_destroy (&rv->ref[k].lock) ;
+    }
+  pthread_mutex_destroy (&rv->lock) ;
+  free (rv->ref) ;
+  free (rv->dir) ;
+  free (rv->bucket) ;
+  free (rv) ;
+}
+
+OneResolved *oneResolve (OneResolver *rv, int ref, I64 i)
+{ Entry *e, *old ;
+  Ref   *r ;
+
+  if (ref < 0 || ref >= rv->nRef || i < 0)
+    return NULL ;
+
+  pthread_mutex_lock (&rv->lock) ;
+  if ((e = hashFind (rv, ref, i)))
+    { ++e->held ;
+      ++rv->nHit ;
+      useUnlink (rv, e) ;
+      useFirst (rv, e) ;
+      pthread_mutex_unlock (&rv->lock) ;
+      return &e->ro ;
+    }
+  ++rv->nMiss ;
+  pthread_mutex_unlock (&rv->lock) ;
+
+  r = &rv->ref[ref] ;  // read without the cache lock, so other threads can use the cache
+  pthread_mutex_lock (&r->lock) ;
+  if (!r->isTried)
+    refOpen (rv, r) ;
+  e = r->vf ? entryRead (r, ref, i) : 0 ;
+  pthread_mutex_unlock (&r->lock) ;
+  if (!e)
+    return NULL ;
+
+  pthread_mutex_lock (&rv->lock) ;
+  if ((old = hashFind (rv, ref, i))) // another thread read it meanwhile
+    { entryFree (e) ;
+      e = old ;
+      useUnlink (rv, e) ;
+    }
+  else
+    { hashAdd (rv, e) ;
+      rv->bytes += e->bytes ;
+      if (++rv->nEntry > (I64) 1 << rv->hashBits)
+	hashGrow (rv) ;
+    }
+  useFirst (rv, e) ;
+  ++e->held ;
+  while (rv->bytes > rv->maxBytes && rv->last != e)
+    entryDrop (rv, rv->last) ;
+  pthread_mutex_unlock (&rv->lock) ;
+
+  return &e->ro ;
+}
+
+void oneResolvedRelease (OneResolver *rv, OneResolved *ro)
+{ Entry *e = (Entry *) ro ;
+
+  pthread_mutex_lock (&rv->lock) ;
+  if (!--e->held && !e->isCached)
+    entryFree (e) ;
+  pthread_mutex_unlock (&rv->lock) ;
+}
+
+OneResolvedLine *oneResolvedLine (OneResolved *ro, char lineType)
+{ int j ;
+
+  for (j = 0 ; j < ro->nLine ; ++j)
+    if (ro->line[j].lineType == lineType)
+      return &ro->line[j] ;
+  return NULL ;
+}
+
+void oneResolverReport (OneResolver *rv, FILE *f)
+{ pthread_mutex_lock (&rv->lock) ;
+  fprintf (f, "resolver: %" PRId64 " hits, %" PRId64 " misses, %" PRId64 " dropped, %"
+	   PRId64 " objects in %" PRId64 " bytes cached\n",
+	   rv->nHit, rv->nMiss, rv->nDrop, rv->nEntry, rv->bytes) ;
+  pthread_mutex_unlock (&rv->lock) ;
+}
+
+/******************* end of file **************/
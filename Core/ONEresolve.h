@@ -0,0 +1,77 @@
+/*  File: ONEresolve.h
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: fetch the objects of the files referred to by the '<' lines of a ONE file
+ *
+ * The '<' reference lines of a header name files whose objects the data refer to by number,
+ * e.g. the a and b sequences of the alignments of an aln file, the contigs of a jns or brk
+ * file, or the alignments of a lis file.  A resolver opens each referenced file when it is
+ * first needed, which must be binary so that object k can be found with oneGotoObject(), and
+ * keeps the objects it has read, decoded, in a cache of bounded size that is shared by all
+ * threads, dropping the least recently used objects when it is full.  So a program that
+ * fetches the same reads many times, such as one walking the alignments of an sxs file, reads
+ * and decodes each of them only once while it stays in the cache.
+ *
+ * A reference name that can not be opened as given, and is not an absolute path, is also
+ * looked for relative to the directory of the referring file.
+ *
+ * Exported functions: see below
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#ifndef ONE_RESOLVE_DEFINED
+#define ONE_RESOLVE_DEFINED
+
+#include "ONElib.h"
+
+typedef struct
+  { char      lineType ;
+    I64       listLen ;		// as oneLen(), 0 if the line type has no list
+    OneField *field ;		// the fields, as vf->field, accessed by field[k].i etc.
+    void     *list ;		// the list, as oneList(), strings and DNA 0 terminated, or 0
+  } OneResolvedLine ;
+
+typedef struct
+  { int              ref ;	// reference number, i.e. index into vf->reference
+    I64              index ;	// object number in the referenced file
+    int              nLine ;
+    OneResolvedLine *line ;	// line[0] is the object line, then the lines of the object
+  } OneResolved ;
+
+typedef struct OneResolverStruct OneResolver ;
+
+OneResolver *oneResolverCreate (OneFile *vf, char *path, I64 maxBytes) ;
+
+  // Create a resolver for the references of vf, which was opened from path, with a cache of
+  //   at most maxBytes of decoded objects (0 for a default of 256MB).  path is only used to
+  //   find references named relative to it, and can be NULL.  vf itself is not read, so it
+  //   can be read at the same time, and closed before the resolver is destroyed.
+
+void oneResolverDestroy (OneResolver *rv) ;
+
+  // Close the referenced files and free the cache.  No object may still be held.
+
+OneResolved *oneResolve (OneResolver *rv, int ref, I64 i) ;
+void         oneResolvedRelease (OneResolver *rv, OneResolved *ro) ;
+
+  // Return object i of reference ref, from the cache or else read from its file, and hold it
+  //   until oneResolvedRelease(), which must be called for each object returned.  A held
+  //   object is not freed, but is dropped from the cache as usual, so the cache can go over
+  //   maxBytes by the size of the objects held.  Any number of threads can call these at once:
+  //   the cache is locked only to look up and insert objects, and each referenced file only
+  //   while reading from it.  Returns NULL if i is out of range, or if the reference can not
+  //   be opened as a binary ONE file with an object index, when a message goes to stderr.
+
+OneResolvedLine *oneResolvedLine (OneResolved *ro, char lineType) ;
+
+  // Return the first line of lineType in the object, or NULL if there is none.
+
+void oneResolverReport (OneResolver *rv, FILE *f) ;
+
+  // Write the number of cache hits, misses and objects dropped, and the bytes cached, to f.
+
+#endif // ONE_RESOLVE_DEFINED
+
+/******************* end of file **************/
@@ -0,0 +1,288 @@
+/*  File: ONEsort.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: sort the objects of a binary ONE file on a key of field values
+ *   keys and object numbers are radix sorted in memory with VGP/msd.sort.c, in runs spilled
+ *   to disk if they exceed the memory budget, then merged and the objects copied directly
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+#include "ONEexpr.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+#include <unistd.h>		/* for getpid(), unlink() */
+
+typedef unsigned char      uint8 ;	/* as in VGP/gene_core.h for msd.sort.h */
+typedef signed long long   int64 ;
+#include "msd.sort.h"
+
+  // A record is the key bytes followed by the object number, most significant byte first, so
+  //   that the whole record is the sort key and objects with equal keys keep their order.
+
+static int    rSize ;		// record size
+static int    nThreads = 1 ;
+
+static uint8 *sortRecords (uint8 *in, uint8 *out, I64 n) // returns out, sorted
+{ I64 count[256], off[256], part[256], i, x ;
+
+  memset (count, 0, sizeof(count)) ;
+  for (i = 0 ; i < n ; ++i)        // MSD_Sort needs the records bucketed on their first byte
+    count[in[i*rSize]] += 1 ;
+  for (x = 0, i = 0 ; x < 256 ; ++x)
+    { off[x] = i ; i += count[x] ;
+      part[x] = count[x]*rSize ;
+    }
+  for (i = 0 ; i < n ; ++i)
+    memcpy (out + (off[in[i*rSize]]++)*rSize, in + i*rSize, rSize) ;
+  MSD_Sort (out, n, rSize, rSize, rSize, (int64 *) part, nThreads) ;
+  return out ;
+}
+
+static I64 recordObject (uint8 *r)
+{ I64 i = 0 ;
+  int j ;
+  for (j = rSize-8 ; j < rSize ; ++j) i = (i << 8) | r[j] ;
+  return i ;
+}
+
+  // the runs spilled to disk, merged through a heap of their current records
+
+typedef struct {
+  FILE  *f ;
+  uint8 *buf ;
+  I64    n, i ;		// records in buf, and current record
+} Run ;
+
+static I64 runBufRecords ;
+
+static bool runNext (Run *r) // advance to the next record, false at the end
+{ if (++r->i < r->n) return true ;
+  r->n = fread (r->buf, rSize, runBufRecords, r->f) ;
+  r->i = 0 ;
+  return r->n > 0 ;
+}
+
+static inline bool runLess (Run *a, Run *b)
+{ return memcmp (a->buf + a->i*rSize, b->buf + b->i*rSize, rSize) < 0 ; }
+
+static void heapDown (Run **heap, int n, int k)
+{ Run *x = heap[k] ;
+  int  c ;
+  while ((c = 2*k+1) < n)
+    { if (c+1 < n && runLess (heap[c+1], heap[c])) ++c ;
+      if (!runLess (heap[c], x)) break ;
+      heap[k] = heap[c] ;
+      k = c ;
+    }
+  heap[k] = x ;
+}
+
+  // objects are written in batches to amortize the checks in oneFileCatObjects()
+
+#define BATCH 4096
+
+static I64 batch[BATCH] ;
+static int nBatch = 0 ;
+
+static void writeObject (OneFile *vfOut, OneFile *vfIn, I64 i)
+{ batch[nBatch++] = i ;
+  if (nBatch == BATCH)
+    { oneFileCatObjects (vfOut, vfIn, batch, nBatch) ;
+      nBatch = 0 ;
+    }
+}
+
+static void flushObjects (OneFile *vfOut, OneFile *vfIn)
+{ if (nBatch) oneFileCatObjects (vfOut, vfIn, batch, nBatch) ;
+  nBatch = 0 ;
+}
+
+int main (int argc, char **argv)
+{
+  I64   i ;
+  char *outFileName = 0, *keyText = 0 ;
+  I64   memMB = 1024 ;
+  bool  isVerbose = false ;
+
+  timeUpdate (0) ;
+
+  char *command = commandLine (argc, argv) ;
+  --argc ; ++argv ;		/* drop the program name */
+
+  if (!argc)
+    { fprintf (stderr, "ONEsort [options] -k <key> -o <output> onefile\n") ;
+      fprintf (stderr, "  -k --key <key>            sort key, e.g. 'A.0,I.0' for aln, '-S.len' for seq\n") ;
+      fprintf (stderr, "  -o --output <filename>    output file name - required\n") ;
+      fprintf (stderr, "  -M --memory <MB>          memory for keys before spilling runs to disk (default 1024)\n") ;
+      fprintf (stderr, "  -T --threads <n>          number of threads for sorting (default 1)\n") ;
+      fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
+      fprintf (stderr, "key terms are X.k for field k of the first X line of the object, or X.len for its list length,\n") ;
+      fprintf (stderr, "separated by commas, with a leading '-' for descending order\n") ;
+      fprintf (stderr, "input and output are binary; the output has no group lines\n") ;
+      exit (0) ;
+    }
+
+  while (argc && **argv == '-')
+    if (argc > 1 && (!strcmp (*argv, "-k") || !strcmp (*argv, "--key")))
+      { keyText = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-o") || !strcmp (*argv, "--output")))
+      { outFileName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-M") || !strcmp (*argv, "--memory")))
+      { memMB = atoll (argv[1]) ;
+	if (memMB < 1) die ("memory %s MB must be positive", argv[1]) ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-T") || !strcmp (*argv, "--threads")))
+      { nThreads = atoi (argv[1]) ;
+	if (nThreads < 1) die ("number of threads %s must be positive", argv[1]) ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
+      { isVerbose = true ; --argc ; ++argv ; }
+    else die ("unknown option %s - run without arguments to see options", *argv) ;
+
+  if (argc != 1)
+    die ("need to give a single binary ONE file as argument") ;
+  if (!keyText)
+    die ("need to give a sort key with -k") ;
+  if (!outFileName || !strcmp (outFileName, "-"))
+    die ("need to give a named output file with -o") ;
+
+  OneFile *vfIn = oneFileOpenRead (argv[0], 0, 0, 1) ;
+  if (!vfIn) die ("failed to open ONE file %s", argv[0]) ;
+  if (!vfIn->isBinary) die ("%s is not a binary ONE file - convert with ONEview -b", argv[0]) ;
+  OneKey *key = oneKeyCreate (vfIn, keyText) ;
+  if (!key) die ("failed to parse sort key") ;
+  rSize = oneKeySize (key) + 8 ;
+
+  OneFile *vfOut = oneFileOpenWriteFrom (outFileName, vfIn, true, 1) ;
+  if (!vfOut) die ("failed to open output file %s", outFileName) ;
+  oneAddProvenance (vfOut, "ONEsort", "0.0", command, 0) ;
+  { char t ; int field ;     // declare the order if the first term allows binary search
+    if (oneKeyFirstTerm (key, &t, &field)) oneSetSorted (vfOut, t, field) ;
+  }
+  oneInheritCodecs (vfOut, vfIn) ;
+  oneWriteHeader (vfOut) ;
+
+  // read the keys, copying any lines before the first object, sorting and spilling runs
+
+  I64    nMax = (memMB << 20) / (2*rSize) ;   // two buffers for bucketing
+  if (nMax < 1024) nMax = 1024 ;
+  if (nMax > vfIn->info[(int) vfIn->objectType]->given.count) // from the footer
+    nMax = vfIn->info[(int) vfIn->objectType]->given.count + 1 ;
+  uint8 *bufA = new (nMax*rSize, uint8) ;
+  uint8 *bufB = new (nMax*rSize, uint8) ;
+  uint8 *sorted = 0 ;
+  I64    nRec = 0, nRun = 0, obj = -1 ;
+  char  *runName = new (strlen(outFileName) + 64, char) ;
+  char   t ;
+
+  while (true)
+    { t = oneReadLine (vfIn) ;
+      if ((!t || t == vfIn->objectType) && obj >= 0) // finish the record of the previous object
+	{ uint8 *r = bufA + nRec*rSize ;
+	  I64    o = obj ;
+	  int    j ;
+	  oneKeyBytes (key, r) ;
+	  for (j = rSize-1 ; j >= rSize-8 ; --j, o >>= 8)
+	    r[j] = o & 0xff ;
+	  if (++nRec == nMax || !t)
+	    { sorted = sortRecords (bufA, bufB, nRec) ;
+	      if (nRun || t)              // spill to disk unless all are in memory
+		{ sprintf (runName, "%s.run.%d.%" PRId64 "", outFileName, getpid(), nRun) ;
+		  FILE *f = fopen (runName, "w") ;
+		  if (!f || fwrite (sorted, rSize, nRec, f) != (size_t) nRec)
+		    die ("failed to write sort run %s", runName) ;
+		  fclose (f) ;
+		  ++nRun ;
+		  nRec = 0 ;
+		}
+	    }
+	}
+      if (!t)
+	break ;
+      if (t == vfIn->objectType)
+	{ obj = vfIn->object - 1 ;
+	  oneKeyClear (key) ;
+	}
+      else if (obj < 0 && t != vfIn->groupType) // global lines before the first object
+	{ OneInfo *li = vfIn->info[(int)t] ;
+	  memcpy (vfOut->field, vfIn->field, li->nField*sizeof(OneField)) ;
+	  oneWriteLine (vfOut, t, oneLen(vfIn), li->listEltSize ? oneList(vfIn) : NULL) ;
+	}
+      oneKeyRecord (key, vfIn) ;
+    }
+  if (isVerbose)
+    { fprintf (stderr, "read keys of %" PRId64 " objects in %" PRId64 " runs\n",
+	       vfIn->object, nRun ? nRun : 1) ;
+      timeUpdate (stderr) ;
+    }
+
+  // write the objects in order
+
+  if (!nRun)
+    for (i = 0 ; i < nRec ; ++i)
+      writeObject (vfOut, vfIn, recordObject (sorted + i*rSize)) ;
+  else
+    { Run  *run = new (nRun, Run) ;
+      Run **heap = new (nRun, Run*) ;
+      int   nHeap = 0 ;
+
+      free (bufB) ; bufB = 0 ;  // share the memory of bufA between the run buffers
+      runBufRecords = nMax / nRun ;
+      if (runBufRecords < 64) runBufRecords = 64 ;
+      for (i = 0 ; i < nRun ; ++i)
+	{ sprintf (runName, "%s.run.%d.%" PRId64 "", outFileName, getpid(), i) ;
+	  if (!(run[i].f = fopen (runName, "r")))
+	    die ("failed to open sort run %s", runName) ;
+	  run[i].buf = (runBufRecords * nRun <= nMax) ? bufA + i*runBufRecords*rSize
+	                                              : new (runBufRecords*rSize, uint8) ;
+	  run[i].n = run[i].i = 0 ;
+	  if (runNext (&run[i]))
+	    heap[nHeap++] = &run[i] ;
+	}
+      for (i = nHeap/2 - 1 ; i >= 0 ; --i)
+	heapDown (heap, nHeap, i) ;
+      while (nHeap)
+	{ Run *r = heap[0] ;
+	  writeObject (vfOut, vfIn, recordObject (r->buf + r->i*rSize)) ;
+	  if (!runNext (r))
+	    heap[0] = heap[--nHeap] ;
+	  heapDown (heap, nHeap, 0) ;
+	}
+      for (i = 0 ; i < nRun ; ++i)
+	{ fclose (run[i].f) ;
+	  if (runBufRecords * nRun > nMax) free (run[i].buf) ;
+	  sprintf (runName, "%s.run.%d.%" PRId64 "", outFileName, getpid(), i) ;
+	  unlink (runName) ;
+	}
+      free (run) ;
+      free (heap) ;
+    }
+  flushObjects (vfOut, vfIn) ;
+
+  oneFileClose (vfOut) ;
+  oneFileClose (vfIn) ;
+  oneKeyDestroy (key) ;
+  free (bufA) ;
+  if (bufB) free (bufB) ;
+  free (runName) ;
+  free (command) ;
+
+  if (isVerbose)
+    timeTotal (stderr) ;
+
+  exit (0) ;
+}
+
+/******************* end of file **************/
@@ -0,0 +1,153 @@
+/*  File: ONEsplit.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: split a binary ONE file into shards of contiguous objects
+ *   shards are cut by onePartitions() using the object and group indices, and their data
+ *   copied directly, or just the partition descriptors are written for other processes
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+
+int main (int argc, char **argv)
+{
+  int        i, nShard = 2 ;
+  char      *prefix = 0, *manifestName = 0 ;
+  OneBalance by = oneBYTES ;
+  bool       isKeepGroups = false, isPartitions = false, isVerbose = false ;
+
+  timeUpdate (0) ;
+
+  char *command = commandLine (argc, argv) ;
+  --argc ; ++argv ;		/* drop the program name */
+
+  if (!argc)
+    { fprintf (stderr, "ONEsplit [options] onefile\n") ;
+      fprintf (stderr, "  -n --shards <n>           number of shards (default 2)\n") ;
+      fprintf (stderr, "  -b --by bytes|objects|groups  balance shards by (default bytes)\n") ;
+      fprintf (stderr, "  -G --keepGroups           only cut at the start of a group - implied by '-b groups'\n") ;
+      fprintf (stderr, "  -o --output <prefix>      shard k is <prefix>.<k>.<suffix> (default input name without suffix)\n") ;
+      fprintf (stderr, "  -m --manifest <filename>  manifest file (default <prefix>.manifest, '-' for stdout)\n") ;
+      fprintf (stderr, "  -p --partitions           write partition descriptors for ONEview -P to stdout, not shards\n") ;
+      fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
+      fprintf (stderr, "input and shards are binary; shard data are copied directly, without decoding\n") ;
+      exit (0) ;
+    }
+
+  while (argc && **argv == '-')
+    if (argc > 1 && (!strcmp (*argv, "-n") || !strcmp (*argv, "--shards")))
+      { nShard = atoi (argv[1]) ;
+	if (nShard < 1) die ("number of shards %s must be positive", argv[1]) ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-b") || !strcmp (*argv, "--by")))
+      { if (!strcmp (argv[1], "bytes")) by = oneBYTES ;
+	else if (!strcmp (argv[1], "objects")) by = oneOBJECTS ;
+	else if (!strcmp (argv[1], "groups")) by = oneGROUPS ;
+	else die ("can only balance by bytes, objects or groups, not %s", argv[1]) ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-G") || !strcmp (*argv, "--keepGroups"))
+      { isKeepGroups = true ; --argc ; ++argv ; }
+    else if (argc > 1 && (!strcmp (*argv, "-o") || !strcmp (*argv, "--output")))
+      { prefix = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (argc > 1 && (!strcmp (*argv, "-m") || !strcmp (*argv, "--manifest")))
+      { manifestName = argv[1] ;
+	argc -= 2 ; argv += 2 ;
+      }
+    else if (!strcmp (*argv, "-p") || !strcmp (*argv, "--partitions"))
+      { isPartitions = true ; --argc ; ++argv ; }
+    else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
+      { isVerbose = true ; --argc ; ++argv ; }
+    else die ("unknown option %s - run without arguments to see options", *argv) ;
+
+  if (argc != 1)
+    die ("need to give a single binary ONE file as argument") ;
+
+  OneFile *vfIn = oneFileOpenRead (argv[0], 0, 0, 1) ;
+  if (!vfIn) die ("failed to open ONE file %s", argv[0]) ;
+  if (!vfIn->isBinary) die ("%s is not a binary ONE file - convert with ONEview -b", argv[0]) ;
+  if (!vfIn->isIndexIn) die ("%s has no object index", argv[0]) ;
+
+  if (by == oneGROUPS && !(vfIn->groupType && vfIn->info[(int)vfIn->groupType]->given.count))
+    die ("%s has no groups to balance by", argv[0]) ;
+  OnePartition *part = onePartitions (vfIn, nShard, by, isKeepGroups) ;
+
+  if (isPartitions)
+    { for (i = 0 ; i < nShard ; ++i)
+	{ char *s = onePartitionString (&part[i]) ;
+	  printf ("%s\n", s) ;
+	  free (s) ;
+	}
+      if (isVerbose)
+	timeTotal (stderr) ;
+      exit (0) ;
+    }
+
+  // names: strip the suffix of the input for the default prefix, and use it for the shards
+
+  char *suffix = strrchr (argv[0], '.') ;
+  if (suffix && strchr (suffix, '/')) suffix = 0 ;
+  if (!prefix)
+    { int len = suffix ? suffix - argv[0] : (int) strlen (argv[0]) ;
+      prefix = new0 (len+1, char) ;
+      strncpy (prefix, argv[0], len) ;
+    }
+  if (!suffix) suffix = "" ;
+  char *name = new (strlen(prefix) + strlen(suffix) + 32, char) ;
+
+  FILE *manifest ;
+  if (manifestName && !strcmp (manifestName, "-"))
+    manifest = stdout ;
+  else
+    { if (!manifestName)
+	{ manifestName = new (strlen(prefix) + 10, char) ;
+	  sprintf (manifestName, "%s.manifest", prefix) ;
+	}
+      if (!(manifest = fopen (manifestName, "w")))
+	die ("failed to open manifest file %s", manifestName) ;
+    }
+  fprintf (manifest, "#shard\tfile\tfirstObject\tobjects\tfirstGroup\tgroups\tbytes\n") ;
+
+  for (i = 0 ; i < nShard ; ++i)
+    { OnePartition *p = &part[i] ;
+      sprintf (name, "%s.%d%s", prefix, i, suffix) ;
+      OneFile *vfOut = oneFileOpenWriteFrom (name, vfIn, true, 1) ;
+      if (!vfOut) die ("failed to open shard file %s", name) ;
+      oneAddProvenance (vfOut, "ONEsplit", "0.0", command, 0) ;
+      if (vfIn->sortType) oneSetSorted (vfOut, vfIn->sortType, vfIn->sortField) ;
+      oneInheritCodecs (vfOut, vfIn) ;
+      oneWriteHeader (vfOut) ;
+      if (!oneFileCatRange (vfOut, vfIn, p->objectStart, p->objectEnd))
+	fprintf (stderr, "warning: shard %s had to be re-encoded\n", name) ;
+      oneFileClose (vfOut) ;
+
+      fprintf (manifest, "%d\t%s\t%" PRId64 "\t%" PRId64 "\t%" PRId64 "\t%" PRId64 "\t%" PRId64 "\n",
+	       i, name, p->objectStart, p->objectEnd - p->objectStart,
+	       p->groupStart, p->groupEnd - p->groupStart, p->byteEnd - p->byteStart) ;
+      if (isVerbose)
+	fprintf (stderr, "shard %d: %" PRId64 " objects in %s\n", i, p->objectEnd - p->objectStart, name) ;
+    }
+
+  if (manifest != stdout) fclose (manifest) ;
+  oneFileClose (vfIn) ;
+  free (part) ;
+  free (name) ;
+  free (command) ;
+
+  if (isVerbose)
+    timeTotal (stderr) ;
+
+  exit (0) ;
+}
+
+/******************* end of file **************/
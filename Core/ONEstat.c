@@ -22,11 +22,118 @@
 
 extern void oneFinalizeCounts (OneFile *vf) ; // secret connection into ONElib.c for checking
 
+#define USAGE_SAMPLE 1000 // objects read by --fast --usage to estimate the bytes of line types
+
+static void fastUsage (OneFile *vf, FILE *f, I64 nObj, I64 *index, I64 dataEnd)
+{ // bytes of each line type: those before the first object, then those of a sample of
+  //   objects spread through the index, read line by line and scaled up to all objects
+  I64  usage[128], sample[128], i, k, u, uLast, end, sampleBytes = 0 ;
+  I64  nSample = (nObj < USAGE_SAMPLE) ? nObj : USAGE_SAMPLE ;
+  I64  objStart = nObj ? index[0] : dataEnd ;
+
+  memset (usage, 0, 128*sizeof(I64)) ;
+  memset (sample, 0, 128*sizeof(I64)) ;
+  if (fseeko (vf->f, vf->dataStart, SEEK_SET))
+    die ("failed to seek to the data of the file") ;
+  for (uLast = vf->dataStart ; uLast < objStart && oneReadLine (vf) ; uLast = u)
+    usage[(int)vf->lineType] += (u = ftello (vf->f)) - uLast ;
+
+  for (i = 0 ; i < nSample ; ++i)
+    { k = (nSample == nObj) ? i : i * nObj / nSample ;
+      end = (k+1 < nObj) ? index[k+1] : dataEnd ;
+      if (!oneGotoObject (vf, k))
+	die ("failed to go to object %" PRId64, k) ;
+      for (uLast = index[k] ; uLast < end && oneReadLine (vf) ; uLast = u)
+	sample[(int)vf->lineType] += (u = ftello (vf->f)) - uLast ;
+      sampleBytes += end - index[k] ;
+    }
+  for (i = 0 ; i < 128 ; ++i)
+    if (sample[i])
+      usage[i] += (nSample == nObj) ? sample[i]
+	: (I64) (sample[i] * (dataEnd - objStart) / (double) sampleBytes + 0.5) ;
+
+  for (i = 'A' ; i < 128 ; ++i)
+    if (usage[i]) fprintf (f, "usage line type %c bytes %" PRId64 "\n", (char)i, usage[i]) ;
+  if (nSample < nObj)
+    fprintf (f, "usage line types estimated from %" PRId64 " of %" PRId64 " objects\n",
+	     nSample, nObj) ;
+}
+
+static void fastReport (OneFile *vf, FILE *f, bool isUsage)
+{ // report everything that can be known from the header, footer and indices without a data scan
+  I64  i ;
+  I64  nObj = vf->info[(int)vf->objectType]->given.count ;
+  I64  nGroup = vf->groupType ? vf->info[(int)vf->groupType]->given.count : 0 ;
+  I64 *index = (I64*) vf->info['&']->buffer ;
+  I64  dataEnd = vf->footOff - 1 ;  // the data section is terminated by a blank line
+
+  if (isUsage)
+    { fprintf (f, "usage header bytes %" PRId64 "\n", vf->dataStart) ;
+      fprintf (f, "usage data bytes %" PRId64 "\n", dataEnd - vf->dataStart) ;
+      fseeko (vf->f, 0, SEEK_END) ;
+      fprintf (f, "usage footer bytes %" PRId64 "\n", (I64) ftello (vf->f) - vf->footOff) ;
+      if (vf->isIndexIn)
+	fastUsage (vf, f, nObj, index, dataEnd) ;
+    }
+  else
+    { fprintf (f, "file type %s", vf->fileType) ;
+      if (*vf->subType) fprintf (f, " subtype %s", vf->subType) ;
+      fprintf (f, " objects %" PRId64, nObj) ;
+      if (vf->groupType) fprintf (f, " groups %" PRId64, nGroup) ;
+      fputc ('\n', f) ;
+
+      char *codecBuf = new (vcMaxSerialSize()+1, char) ;
+      for (i = 0 ; i < 128 ; ++i)
+	if (((i >= 'A' && i <= 'Z') || i == vf->groupType) && vf->info[i]
+	    && vf->info[i]->given.count)
+	  { OneInfo *li = vf->info[i] ;
+	    fprintf (f, "line type %c count %" PRId64, (char)i, li->given.count) ;
+	    if (li->listEltSize)
+	      fprintf (f, " max %" PRId64 " total %" PRId64, li->given.max, li->given.total) ;
+	    if (vf->groupType && i != vf->groupType && nGroup)
+	      { fprintf (f, " group count %" PRId64, li->given.groupCount) ;
+		if (li->listEltSize) fprintf (f, " group total %" PRId64, li->given.groupTotal) ;
+	      }
+	    if (li->listCodec == DNAcodec)
+	      fprintf (f, " codec DNA") ;
+	    else if (li->listCodec && li->isUseListCodec)
+	      fprintf (f, " codec %d bytes", vcSerialize (li->listCodec, codecBuf)) ;
+	    fputc ('\n', f) ;
+	  }
+      free (codecBuf) ;
+    }
+
+  // object sizes come from differences between successive offsets in the object index
+
+  if (nObj && vf->isIndexIn)
+    { I64 min = dataEnd, max = 0, size ;
+      for (i = 0 ; i < nObj ; ++i)
+	{ size = ((i+1 < nObj) ? index[i+1] : dataEnd) - index[i] ;
+	  if (size < min) min = size ;
+	  if (size > max) max = size ;
+	}
+      fprintf (f, "%s object %c bytes %" PRId64 " min %" PRId64 " mean %.1f max %" PRId64 "\n",
+	       isUsage ? "usage" : "size", vf->objectType, dataEnd - index[0], min,
+	       (dataEnd - index[0]) / (double) nObj, max) ;
+    }
+  if (nGroup)
+    { I64 *gIndex = (I64*) vf->info['*']->buffer ;
+      I64 min = nObj, max = 0, size ;
+      for (i = 0 ; i < nGroup ; ++i)
+	{ size = gIndex[i+1] - gIndex[i] ;
+	  if (size < min) min = size ;
+	  if (size > max) max = size ;
+	}
+      fprintf (f, "%s group %c objects min %" PRId64 " mean %.1f max %" PRId64 "\n",
+	       isUsage ? "usage" : "size", vf->groupType, min, nObj / (double) nGroup, max) ;
+    }
+}
+
 int main (int argc, char **argv)
 { int        i ;
   char      *fileType = 0 ;
   char      *outFileName = "-" ;
-  bool       isHeader = false, isUsage = false, isVerbose = false ;
+  bool       isHeader = false, isUsage = false, isVerbose = false, isFast = false ;
   char      *schemaFileName = 0 ;
   char      *checkText = 0 ;
   
@@ -43,6 +150,7 @@ int main (int argc, char **argv)
       fprintf (stderr, "  -H --header              output header accumulated from data\n") ;
       fprintf (stderr, "  -o --output <filename>   output to filename\n") ;
       fprintf (stderr, "  -u --usage               byte usage per line type; no other output\n") ;
+      fprintf (stderr, "  -f --fast                binary only: report from footer and index, no data scan\n") ;
       fprintf (stderr, "  -v --verbose             else only errors and requested output\n") ;
       fprintf (stderr, "ONEstat aborts on a syntactic parse error with a message.\n") ;
       fprintf (stderr, "Otherwise information is written to stderr about any inconsistencies\n") ;
@@ -58,6 +166,8 @@ int main (int argc, char **argv)
       { isUsage = true ; --argc ; ++argv ; }
     else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
       { isVerbose = true ; --argc ; ++argv ; }
+    else if (!strcmp (*argv, "-f") || !strcmp (*argv, "--fast"))
+      { isFast = true ; --argc ; ++argv ; }
     else if (argc > 1 && (!strcmp (*argv, "-t") || !strcmp (*argv, "--type")))
       { fileType = argv[1] ;
 	argc -= 2 ; argv += 2 ;
@@ -99,11 +209,35 @@ int main (int argc, char **argv)
   if (checkText)
     oneFileCheckSchema (vf, checkText) ;
 
+  if (isFast && !vf->isBinary)
+    { if (isVerbose) fprintf (stderr, "--fast needs a binary file: scanning the data instead\n") ;
+      isFast = false ;
+    }
+
   vf->isCheckString = true ;
 
+  // in fast mode report from the footer and indices, which the open has already read
+
+  if (isFast)
+    { if (isHeader)
+	{ OneFile *vfOut = oneFileOpenWriteFrom (outFileName, vf, false, 1) ;
+	  if (vfOut == NULL)
+	    die ("failed to open output file %s", outFileName) ;
+	  oneWriteHeader (vfOut) ; // given counts from the footer are inherited
+	  oneFileClose (vfOut) ;
+	}
+      else
+	{ FILE *f = stdout ;
+	  if (strcmp (outFileName, "-") && !(f = fopen (outFileName, "w")))
+	    die ("failed to open output file %s", outFileName) ;
+	  fastReport (vf, f, isUsage) ;
+	  if (f != stdout) fclose (f) ;
+	}
+    }
+
   // if requesting usage, then 
 
-  if (isUsage)
+  else if (isUsage)
     { I64 usage[128] ; memset (usage, 0, 128*sizeof(I64)) ; 
       off_t u, uLast = ftello (vf->f) ;
 
@@ -0,0 +1,117 @@
+/*  File: ONEtestArrow.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: check the Arrow export of ONEarrow.h, run by make TEST
+ *   Exports every line type of a ONE file in batches, as an Arrow consumer would take them,
+ *   and checks the rows of each type against the counts in the header of the file, the
+ *   list lengths against its totals and maxima, except for STRING_LIST, and the object
+ *   column against the objects.
+ *   Exits with an error message at the first difference.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEarrow.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+
+int main (int argc, char **argv)
+{
+  I64  maxObjects = 50 ;
+
+  timeUpdate (0) ;
+
+  if (argc != 2 && argc != 3)
+    { fprintf (stderr, "ONEtestArrow <ONE file> [objects per batch, default 50]\n") ;
+      exit (0) ;
+    }
+  if (argc == 3 && (maxObjects = atoll (argv[2])) < 1)
+    die ("objects per batch %s must be positive", argv[2]) ;
+
+  OneFile *vf = oneFileOpenRead (argv[1], 0, 0, 1) ;
+  if (!vf) die ("failed to open ONE file %s", argv[1]) ;
+
+  OneArrowReader *ar = oneArrowReaderCreate (vf, 0) ;
+  if (!ar) die ("failed to create an Arrow reader for %s", argv[1]) ;
+  const char *types = oneArrowLineTypes (ar) ;
+  int   i, k, n = strlen (types) ;
+  I64  *rows = new0 (n, I64), *listTotal = new0 (n, I64), *listMax = new0 (n, I64) ;
+  I64   nBatch = 0, nObject = 0, lastObject = -1 ; // -1 before the first object
+
+  struct ArrowSchema *schemas = new (n, struct ArrowSchema) ;
+  struct ArrowArray  *arrays = new (n, struct ArrowArray) ;
+  while (oneArrowReadBatch (ar, maxObjects, schemas, arrays))
+    { ++nBatch ;
+      for (i = 0 ; i < n ; ++i)
+	{ struct ArrowSchema *s = &schemas[i] ;
+	  struct ArrowArray  *a = &arrays[i] ;
+	  if (strcmp (s->format, "+s") || a->n_children != s->n_children || a->null_count)
+	    die ("line type %c: batch %" PRId64 " is not a struct array without nulls",
+		 types[i], nBatch) ;
+	  if (s->n_children < 1 || strcmp (s->children[0]->name, "object"))
+	    die ("line type %c: the first column is not \"object\"", types[i]) ;
+	  const I64 *obj = (const I64 *) a->children[0]->buffers[1] ;
+	  I64 j, *len = new0 (a->length, I64) ;
+	  for (j = 0 ; j < a->length ; ++j)
+	    { if (obj[j] < lastObject)
+		die ("line type %c: object %" PRId64 " comes after object %" PRId64,
+		     types[i], obj[j], lastObject) ;
+	      if (types[i] == vf->objectType && obj[j] != nObject + j)
+		die ("object line %" PRId64 " has object %" PRId64, nObject + j, obj[j]) ;
+	    }
+	  for (k = 1 ; k < s->n_children ; ++k)	// sum list lengths over the fields of each line
+	    { struct ArrowArray *c = a->children[k] ;
+	      if (c->length != a->length)
+		die ("line type %c: column %s has %" PRId64 " rows, not %" PRId64,
+		     types[i], s->children[k]->name, c->length, a->length) ;
+	      if (!strcmp (s->children[k]->format, "U") || !strcmp (s->children[k]->format, "+L"))
+		{ const I64 *off = (const I64 *) c->buffers[1] ;
+		  for (j = 0 ; j < a->length ; ++j) len[j] += off[j+1] - off[j] ;
+		}
+	    }
+	  for (j = 0 ; j < a->length ; ++j)
+	    { listTotal[i] += len[j] ;
+	      if (len[j] > listMax[i]) listMax[i] = len[j] ;
+	    }
+	  free (len) ;
+	  rows[i] += a->length ;
+	  if (types[i] == vf->objectType) nObject += a->length ;
+	}
+      lastObject = nObject ;	// lines of later batches are in later objects
+      for (i = 0 ; i < n ; ++i)	// release the arrays before the schemas, as a consumer might
+	arrays[i].release (&arrays[i]) ;
+      for (i = 0 ; i < n ; ++i)
+	schemas[i].release (&schemas[i]) ;
+    }
+
+  for (i = 0 ; i < n ; ++i)
+    { OneInfo *li = vf->info[(int) types[i]] ;
+      if (rows[i] != li->given.count)
+	die ("line type %c: %" PRId64 " rows but the header counts %" PRId64 " lines",
+	     types[i], rows[i], li->given.count) ;
+      bool isList = li->listEltSize && li->fieldType[li->listField] != oneSTRING_LIST ;
+      if (isList && (listTotal[i] != li->given.total || listMax[i] != li->given.max))
+	die ("line type %c: list total %" PRId64 " max %" PRId64
+	     " but the header has total %" PRId64 " max %" PRId64,
+	     types[i], listTotal[i], listMax[i], li->given.total, li->given.max) ;
+      fprintf (stderr, "%c %" PRId64 " rows", types[i], rows[i]) ;
+      if (isList) fprintf (stderr, ", list total %" PRId64, listTotal[i]) ;
+      fputc ('\n', stderr) ;
+    }
+  fprintf (stderr, "%" PRId64 " objects in %" PRId64 " batches match the header of %s\n",
+	   nObject, nBatch, argv[1]) ;
+
+  oneArrowReaderDestroy (ar) ;
+  oneFileClose (vf) ;
+  free (schemas) ; free (arrays) ;
+  free (rows) ; free (listTotal) ; free (listMax) ;
+
+  timeTotal (stderr) ;
+  exit (0) ;
+}
+
+/******************* end of file **************/
@@ -0,0 +1,140 @@
+/*  File: ONEtestCpp.cpp
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: check the C++ interface of ONElib.hpp, run by make TEST
+ *   Reads an aln file by objects with the typed accessors, checking the numbers of lines
+ *   against its header, then copies it line by line with them to a binary file and reads
+ *   both back in step, checking that every line is the same.  Also checks that opening a
+ *   missing file, and checking a line type with the wrong fields, raise one::Error.  Exits
+ *   with an error message at the first difference.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "ONElib.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cinttypes>
+#include <algorithm>
+
+using A = one::LineDef<'A', one::Int, one::Int> ;
+using D = one::LineDef<'D', one::Int> ;
+using I = one::LineDef<'I', one::Int, one::Int, one::Int, one::Int, one::Int, one::Int> ;
+using T = one::LineDef<'T', one::Int> ;
+using W = one::LineDef<'W', one::IntList> ;
+using X = one::LineDef<'X', one::IntList> ;
+using G = one::LineDef<'g', one::Int, one::String> ;
+
+static_assert (A::is ("O A 2 3 INT 3 INT")) ;
+static_assert (W::is ("D W 1 8 INT_LIST")) ;
+static_assert (G::is ("G g 2 3 INT 6 STRING")) ;
+static_assert (!D::is ("D D 1 4 REAL")) ;
+static_assert (!A::is ("O A 1 3 INT")) ;
+
+static void checkDefs (const one::View &f)
+{ A::check (f) ; D::check (f) ; I::check (f) ; T::check (f) ;
+  W::check (f) ; X::check (f) ; G::check (f) ;
+}
+
+static void checkCount (const one::View &f, char t, I64 n)
+{ if (n != f->info[(int) t]->given.count)
+    throw one::Error (std::string ("line type ") + t + ": " + std::to_string (n)
+		      + " lines but the header counts " + std::to_string (f->info[(int) t]->given.count)) ;
+}
+
+static bool isSameList (one::span<const I64> x, one::span<const I64> y)
+{ return x.size () == y.size () && std::equal (x.begin (), x.end (), y.begin ()) ; }
+
+int main (int argc, char **argv)
+{
+  if (argc != 3)
+    { std::fprintf (stderr, "ONEtestCpp <aln file> <binary copy to write>\n") ;
+      std::exit (0) ;
+    }
+
+  try
+    { I64 nA = 0, nD = 0, nW = 0, nLine = 0 ;
+
+      { one::File f = one::File::read (argv[1]) ;
+	checkDefs (f) ;
+	for (one::Object o : f.objects ())
+	  for (one::Line l : o.lines ())
+	    switch (l.type ())
+	      {
+	      case 'A': { auto [a, b] = A::get (l) ; if (a < 0 || b < 0) throw one::Error ("negative index") ; }
+		++nA ; break ;
+	      case 'D': ++nD ; break ;
+	      case 'W': if (W::field<0> (l).size () != (size_t) l.len ()) throw one::Error ("bad W list") ;
+		++nW ; break ;
+	      }
+	checkCount (f, 'A', nA) ; checkCount (f, 'D', nD) ; checkCount (f, 'W', nW) ;
+      }
+
+      { one::File in = one::File::read (argv[1]) ;	// copy through the typed accessors
+	one::File out = one::File::writeFrom (argv[2], in, true) ;
+	out.addProvenance ("ONEtestCpp", "0.0", "ONEtestCpp") ;
+	out.writeHeader () ;
+	for (one::Line l : in.lines ())
+	  switch (l.type ())
+	    {
+	    case 'A': std::apply ([&] (auto... x) { A::write (out, x...) ; }, A::get (l)) ; break ;
+	    case 'D': D::write (out, D::field<0> (l)) ; break ;
+	    case 'I': std::apply ([&] (auto... x) { I::write (out, x...) ; }, I::get (l)) ; break ;
+	    case 'T': T::write (out, T::field<0> (l)) ; break ;
+	    case 'W': W::write (out, W::field<0> (l)) ; break ;
+	    case 'X': X::write (out, X::field<0> (l)) ; break ;
+	    case 'g': std::apply ([&] (auto... x) { G::write (out, x...) ; }, G::get (l)) ; break ;
+	    default: throw one::Error (std::string ("unexpected line type ") + l.type ()) ;
+	    }
+      }
+
+      one::File a = one::File::read (argv[1]), b = one::File::read (argv[2]) ;
+      checkDefs (b) ;
+      for ( ; a.readLine () ; ++nLine)
+	{ char t = a->lineType ;
+	  one::Line la = a.line (), lb = b.line () ;
+	  bool isSame = b.readLine () == t ;
+	  if (isSame)
+	    switch (t)
+	      {
+	      case 'A': isSame = A::get (la) == A::get (lb) ; break ;
+	      case 'D': isSame = D::get (la) == D::get (lb) ; break ;
+	      case 'I': isSame = I::get (la) == I::get (lb) ; break ;
+	      case 'T': isSame = T::get (la) == T::get (lb) ; break ;
+	      case 'W': isSame = isSameList (W::field<0> (la), W::field<0> (lb)) ; break ;
+	      case 'X': isSame = isSameList (X::field<0> (la), X::field<0> (lb)) ; break ;
+	      case 'g': isSame = G::get (la) == G::get (lb) ; break ;
+	      }
+	  if (!isSame)
+	    throw one::Error ("line " + std::to_string (nLine) + " of type " + t + " differs in the copy") ;
+	}
+      if (b.readLine ())
+	throw one::Error ("the copy has more than " + std::to_string (nLine) + " lines") ;
+
+      std::fprintf (stderr, "%" PRId64 " objects and %" PRId64 " lines read and copied correctly\n",
+		    nA, nLine) ;
+    }
+  catch (const one::Error &e)
+    { std::fprintf (stderr, "FATAL ERROR: %s\n", e.what ()) ;
+      std::exit (1) ;
+    }
+
+  bool isThrown = false ;
+  try { one::File::read ("ZZ.missing.1aln") ; }
+  catch (const one::Error &) { isThrown = true ; }
+  if (!isThrown)
+    { std::fprintf (stderr, "FATAL ERROR: opened a missing file\n") ; std::exit (1) ; }
+
+  isThrown = false ;
+  try { one::LineDef<'D', one::Real>::check (one::File::read (argv[1])) ; }
+  catch (const one::Error &) { isThrown = true ; }
+  if (!isThrown)
+    { std::fprintf (stderr, "FATAL ERROR: D checked as a REAL field\n") ; std::exit (1) ; }
+
+  std::exit (0) ;
+}
+
+/******************* end of file **************/
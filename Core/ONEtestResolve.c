@@ -0,0 +1,134 @@
+/*  File: ONEtestResolve.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: check the resolver of ONEresolve.h, run by make TEST
+ *   Writes a binary seq file of sequences of every length mod 4, and an aln file referring
+ *   to it, then resolves objects of the seq file from several threads through a cache small
+ *   enough that objects are dropped, checking each sequence and name against what was
+ *   written.  Exits with an error message at the first difference.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONEresolve.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+#include <pthread.h>
+
+static char *schemaText =
+  "P 3 seq\n"
+  "O S 1 3 DNA\n"
+  "D I 1 6 STRING\n"
+  "P 3 aln\n"
+  "O A 2 3 INT 3 INT\n" ;
+
+#define N_SEQ     2000
+#define N_THREAD  4
+#define N_LOOKUP  20000
+
+static I64 seqLen (I64 i) { return (i * 37) % 301 + ((i % 50) ? 0 : 5000) ; }
+
+static void makeSeq (I64 i, char *s) // s must hold seqLen(i)+1 chars
+{ I64 j, n = seqLen (i) ;
+  for (j = 0 ; j < n ; ++j) s[j] = "acgt"[(i*7 + j*13 + j/5) & 3] ;
+  s[n] = 0 ;
+}
+
+typedef struct {
+  OneResolver *rv ;
+  int          seed ;
+} Job ;
+
+static void *lookups (void *arg)
+{ Job  *job = (Job *) arg ;
+  char *s = new (6000, char), name[32] ;
+  U64   x = job->seed * 2654435761u + 1 ;
+  int   k ;
+
+  for (k = 0 ; k < N_LOOKUP ; ++k)
+    { I64 i ;
+      x = x * 6364136223846793005ull + 1442695040888963407ull ;
+      i = (k & 1) ? (I64) ((x >> 33) % 64) : (I64) ((x >> 33) % N_SEQ) ; // some repeats
+      OneResolved *ro = oneResolve (job->rv, 0, i) ;
+      if (!ro) die ("failed to resolve object %" PRId64, i) ;
+      OneResolvedLine *rs = oneResolvedLine (ro, 'S'), *ri = oneResolvedLine (ro, 'I') ;
+      if (ro->index != i || !rs || !ri || rs != ro->line)
+	die ("object %" PRId64 " resolved with the wrong index or lines", i) ;
+      makeSeq (i, s) ;
+      if (rs->listLen != seqLen (i) || (I64) strlen (rs->list) != rs->listLen)
+	die ("object %" PRId64 ": sequence length %" PRId64 ", strlen %" PRId64 ", expected %" PRId64, i,
+	     rs->listLen, (I64) strlen (rs->list), seqLen (i)) ;
+      if (strcmp (rs->list, s))
+	die ("object %" PRId64 ": sequence differs from the one written", i) ;
+      sprintf (name, "seq%" PRId64, i) ;
+      if (strcmp (ri->list, name))
+	die ("object %" PRId64 ": name %s, expected %s", i, (char *) ri->list, name) ;
+      oneResolvedRelease (job->rv, ro) ;
+    }
+  free (s) ;
+  return 0 ;
+}
+
+int main (int argc, char **argv)
+{
+  OneSchema *vs = oneSchemaCreateFromText (schemaText) ;
+  OneFile   *vf ;
+  char      *s = new (6000, char), name[32] ;
+  I64        i ;
+  int        t ;
+
+  (void) argc ; (void) argv ;
+  timeUpdate (0) ;
+
+  if (!(vf = oneFileOpenWriteNew ("ZZ.resolve.1seq", vs, "seq", true, 1)))
+    die ("failed to open ZZ.resolve.1seq") ;
+  oneWriteHeader (vf) ;
+  for (i = 0 ; i < N_SEQ ; ++i)
+    { makeSeq (i, s) ;
+      oneWriteLine (vf, 'S', seqLen (i), s) ;
+      sprintf (name, "seq%" PRId64, i) ;
+      oneWriteLine (vf, 'I', strlen (name), name) ;
+    }
+  oneFileClose (vf) ;
+
+  if (!(vf = oneFileOpenWriteNew ("ZZ.resolve.1aln", vs, "aln", true, 1)))
+    die ("failed to open ZZ.resolve.1aln") ;
+  oneAddReference (vf, "ZZ.resolve.1seq", N_SEQ) ;
+  oneWriteHeader (vf) ;
+  for (i = 0 ; i < 10 ; ++i)
+    { oneInt(vf,0) = i ; oneInt(vf,1) = N_SEQ-1-i ;
+      oneWriteLine (vf, 'A', 0, 0) ;
+    }
+  oneFileClose (vf) ;
+
+  if (!(vf = oneFileOpenRead ("ZZ.resolve.1aln", 0, 0, 1)))
+    die ("failed to reopen ZZ.resolve.1aln") ;
+  OneResolver *rv = oneResolverCreate (vf, "ZZ.resolve.1aln", 1 << 16) ;
+  if (oneResolve (rv, 0, N_SEQ) || oneResolve (rv, 0, -1))
+    die ("resolved an object out of range") ;
+
+  pthread_t threads[N_THREAD] ;
+  Job       jobs[N_THREAD] ;
+  for (t = 0 ; t < N_THREAD ; ++t)
+    { jobs[t].rv = rv ; jobs[t].seed = t ;
+      pthread_create (&threads[t], 0, lookups, &jobs[t]) ;
+    }
+  for (t = 0 ; t < N_THREAD ; ++t)
+    pthread_join (threads[t], 0) ;
+
+  oneResolverReport (rv, stderr) ;
+  oneResolverDestroy (rv) ;
+  oneFileClose (vf) ;
+  oneSchemaDestroy (vs) ;
+  free (s) ;
+
+  fprintf (stderr, "resolved %d objects correctly\n", N_THREAD * N_LOOKUP) ;
+  timeTotal (stderr) ;
+  exit (0) ;
+}
+
+/******************* end of file **************/
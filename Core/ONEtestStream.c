@@ -0,0 +1,121 @@
+/*  File: ONEtestStream.c
+ *  Copyright (C) vgp-tools contributors, 2026
+ *-------------------------------------------------------------------
+ * Description: check the streamed lists of oneStreamList(), run by make TEST
+ *   Writes a seq file of DNA sequences, most of lengths that are not a multiple of 4, in
+ *   chunks of odd sizes with oneWriteListBegin/Chunk/End(), once binary and once ascii.
+ *   Reads each back in chunks with oneReadListChunk(), checking every base against what was
+ *   written, except that every third sequence is only partly read, leaving oneReadLine() to
+ *   skip the rest.  Exits with an error message at the first difference.
+ * Exported functions:
+ * HISTORY:
+ * Created: Oct 18 2026
+ *-------------------------------------------------------------------
+ */
+
+#include "utils.h"
+#include "ONElib.h"
+
+#include <string.h>		/* strcmp etc. */
+#include <stdlib.h>		/* for exit() */
+
+static char *schemaText =
+  "P 3 seq\n"
+  "O S 1 3 DNA\n"
+  "D I 1 6 STRING\n" ;
+
+static I64 seqLen[] = { 0, 1, 2, 3, 5, 6, 7, 13, 4099, 65537, 262147, 1000001, 9 } ;
+#define N_SEQ (int) (sizeof(seqLen) / sizeof(I64))
+
+static I64 writeChunk[] = { 1, 3, 7, 2, 13, 101, 5, 4097, 33 } ;   // mostly odd sizes
+static I64 readChunk[]  = { 5, 7, 4, 1001, 9, 65539, 6 } ;         // at least 4
+#define N_CHUNK(x) (int) (sizeof(x) / sizeof(I64))
+
+static char base (I64 i, I64 j) { return "acgt"[(i*7 + j*13 + j/5) & 3] ; }
+
+static void writeFile (char *path, OneSchema *vs, bool isBinary)
+{ OneFile *vf ;
+  char    *s = new (1 << 20, char), name[32] ;
+  I64      i, j, m, n ;
+  int      k = 0 ;
+
+  if (!(vf = oneFileOpenWriteNew (path, vs, "seq", isBinary, 1)))
+    die ("failed to open %s", path) ;
+  oneWriteHeader (vf) ;
+  for (i = 0 ; i < N_SEQ ; ++i)
+    { oneWriteListBegin (vf, 'S', seqLen[i]) ;
+      for (j = 0 ; j < seqLen[i] ; j += n)
+	{ n = writeChunk[k++ % N_CHUNK(writeChunk)] ;
+	  if (n > seqLen[i] - j) n = seqLen[i] - j ;
+	  for (m = 0 ; m < n ; ++m) s[m] = base (i, j+m) ;
+	  oneWriteListChunk (vf, n, s) ;
+	}
+      oneWriteListEnd (vf) ;
+      sprintf (name, "seq%" PRId64, i) ;
+      oneWriteLine (vf, 'I', strlen (name), name) ;
+    }
+  oneFileClose (vf) ;
+  free (s) ;
+}
+
+static void readFile (char *path)
+{ OneFile *vf ;
+  char    *s = new (1 << 20, char), name[32] ;
+  I64      i = -1, j, m, n ;
+  int      k = 0 ;
+
+  if (!(vf = oneFileOpenRead (path, 0, "seq", 1)))
+    die ("failed to reopen %s", path) ;
+  if (!oneStreamList (vf, 'S'))
+    die ("%s: can not stream the S-lines", path) ;
+  while (oneReadLine (vf))
+    switch (vf->lineType)
+      {
+      case 'S':
+	++i ;
+	if (i >= N_SEQ || oneLen(vf) != seqLen[i])
+	  die ("%s: sequence %" PRId64 " has length %" PRId64, path, i, oneLen(vf)) ;
+	for (j = 0 ; (n = oneReadListChunk (vf, s, readChunk[k++ % N_CHUNK(readChunk)])) ; j += n)
+	  { for (m = 0 ; m < n ; ++m)
+	      if (s[m] != base (i, j+m))
+		die ("%s: sequence %" PRId64 " differs at base %" PRId64, path, i, j+m) ;
+	    if (i % 3 == 1)  // leave the rest of the line to oneReadLine()
+	      { j += n ; break ; }
+	  }
+	if (j != seqLen[i] && i % 3 != 1)
+	  die ("%s: read %" PRId64 " of the %" PRId64 " bases of sequence %" PRId64,
+	       path, j, seqLen[i], i) ;
+	break ;
+      case 'I':
+	sprintf (name, "seq%" PRId64, i) ;
+	if (oneLen(vf) != (I64) strlen (name) || strncmp (oneString(vf), name, oneLen(vf)))
+	  die ("%s: name of sequence %" PRId64 " is not %s", path, i, name) ;
+	break ;
+      default:
+	die ("%s: unexpected line type %c", path, vf->lineType) ;
+      }
+  if (i != N_SEQ-1)
+    die ("%s: read %" PRId64 " sequences, not %d", path, i+1, N_SEQ) ;
+  oneFileClose (vf) ;
+  free (s) ;
+}
+
+int main (int argc, char **argv)
+{
+  OneSchema *vs = oneSchemaCreateFromText (schemaText) ;
+
+  (void) argc ; (void) argv ;
+  timeUpdate (0) ;
+
+  writeFile ("ZZ.stream.1seq", vs, true) ;
+  readFile ("ZZ.stream.1seq") ;
+  writeFile ("ZZ.stream.seq", vs, false) ;
+  readFile ("ZZ.stream.seq") ;
+  oneSchemaDestroy (vs) ;
+
+  fprintf (stderr, "%d streamed sequences read back correctly, binary and ascii\n", N_SEQ) ;
+  timeTotal (stderr) ;
+  exit (0) ;
+}
+
+/******************* end of file **************/
@@ -12,21 +12,14 @@
 
 #include "utils.h"
 #include "ONElib.h"
+#include "ONEexpr.h"
 
 #include <assert.h>
 
 #include <string.h>		/* strcmp etc. */
 #include <stdlib.h>		/* for exit() */
-
-static char *commandLine (int argc, char **argv)
-{
-  int i, totLen = 0 ;
-  for (i = 0 ; i < argc ; ++i) totLen += 1 + strlen(argv[i]) ;
-  char *buf = new (totLen, char) ;
-  strcpy (buf, argv[0]) ;
-  for (i = 1 ; i < argc ; ++i) { strcat (buf, " ") ; strcat (buf, argv[i]) ; }
-  return buf ;
-}
+#include <pthread.h>
+#include <ctype.h>
 
 typedef struct IndexListStruct {
   I64 i0, iN ;
@@ -50,20 +43,359 @@ static IndexList *parseIndexList (char *s)
   return ol0 ; 
 }
 
+static bool isDrop[128] ;	/* line types projected out of the output */
+
+/* zone map terms are X.k for INT field k of line type X, or X.len for its list length */
+
+static char *parseZoneTerm (char *s, char *t, int *field)
+{ if (!isalpha(*s) || s[1] != '.') die ("bad zone map term %s - need X.k or X.len", s) ;
+  *t = *s ; s += 2 ;
+  if (!strncmp (s, "len", 3)) { *field = -1 ; return s + 3 ; }
+  if (!isdigit(*s)) die ("bad zone map term %c.%s - need X.k or X.len", *t, s) ;
+  for (*field = 0 ; isdigit(*s) ; ++s) *field = *field*10 + (*s - '0') ;
+  return s ;
+}
+
+static IndexList *zoneIndexList (OneFile *vf, char *s) /* X.k:lo:hi, lo or hi may be empty */
+{ char  t, *e ;
+  int   field ;
+  I64   lo = INT64_MIN, hi = INT64_MAX, n, i, *ranges ;
+  IndexList *ol0 = 0, *ol = 0 ;
+
+  s = parseZoneTerm (s, &t, &field) ;
+  if (*s++ != ':') die ("zone range needs X.k:lo:hi") ;
+  if (*s != ':') { lo = strtoll (s, &e, 10) ; s = e ; }
+  if (*s++ != ':') die ("zone range needs X.k:lo:hi") ;
+  if (*s) { hi = strtoll (s, &e, 10) ; if (*e) die ("bad upper limit %s in zone range", s) ; }
+  if (vf->sortType == t && vf->sortField == field) /* sorted on it: binary search */
+    { ranges = new (2, I64) ;
+      ranges[0] = (lo == INT64_MIN) ? 0 : oneFindObject (vf, t, field, lo) ;
+      ranges[1] = (hi == INT64_MAX) ? vf->info[(int)vf->objectType]->given.count
+	                             : oneFindObject (vf, t, field, hi+1) ;
+      n = (ranges[1] > ranges[0]) ? 1 : 0 ;
+    }
+  else if ((n = oneZoneRanges (vf, t, field, lo, hi, &ranges)) < 0)
+    { if (field < 0) die ("no zone map for %c.len - write one with ONEview -b -z", t) ;
+      else die ("no zone map for %c.%d - write one with ONEview -b -z", t, field) ;
+    }
+  for (i = 0 ; i < n ; ++i)
+    { IndexList *x = new0 (1, IndexList) ;
+      x->i0 = ranges[2*i] ; x->iN = ranges[2*i+1] ;
+      if (ol) ol->next = x ; else ol0 = x ;
+      ol = x ;
+    }
+  free (ranges) ;
+  return ol0 ;
+}
+
+#define LONG_LIST (1 << 26)	/* longer lists, e.g. chromosomes, are copied in chunks */
+
+static void streamLongLists (OneFile *vf)
+{ int i ;
+  for (i = 'A' ; i <= 'Z' ; ++i)
+    if (vf->info[i] && vf->info[i]->given.max > LONG_LIST)
+      oneStreamList (vf, i) ;	/* does nothing unless the list can be streamed */
+}
+
 static void transferLine (OneFile *vfIn, OneFile *vfOut, size_t *fieldSize)
-{ memcpy (vfOut->field, vfIn->field, fieldSize[(int)vfIn->lineType]) ;
-  oneWriteLine (vfOut, vfIn->lineType, oneLen(vfIn), oneString(vfIn)) ;
+{ char t = vfIn->lineType ;
+  if (isDrop[(int)t]) return ;
+  memcpy (vfOut->field, vfIn->field, fieldSize[(int)t]) ;
+  if (vfIn->info[(int)t]->isStream)
+    { I64 chunk[8192], n ;
+      oneWriteListBegin (vfOut, t, oneLen(vfIn)) ;
+      while ((n = oneReadListChunk (vfIn, chunk, sizeof(chunk) / vfIn->info[(int)t]->listEltSize)))
+	oneWriteListChunk (vfOut, n, chunk) ;
+      oneWriteListEnd (vfOut) ;
+    }
+  else
+    oneWriteLine (vfOut, t, oneLen(vfIn), oneString(vfIn)) ;
   char *s = oneReadComment (vfIn) ; if (s) oneWriteComment (vfOut, s) ;
 }
 
+/* Conversion is carried out over ranges of the input, which in parallel are nthreads
+ * ranges, each transferred by its own slave reader into its own slave writer, whose parts
+ * are concatenated on close.  Binary input is cut at objects via the object index.  Ascii
+ * input is cut at the first object line after each of nthreads equally spaced byte offsets,
+ * found in parallel by a pre-pass.  Lines between the last object of a range and the next
+ * object line, e.g. group lines, stay with the earlier range, so the output is line-for-line
+ * that of the serial loop.
+ */
+
+typedef struct {
+  OneFile *vfIn, *vfOut ;
+  size_t  *fieldSize ;
+  I64      start, end ;		/* binary: object range, ascii: byte range */
+  bool     isSeek ;		/* go to start even if not a slave */
+  I64     *pass, nPass, iPass ;	/* filtered ascii output: passing objects of each group line */
+  I64      carry ;		/* passing objects before the first group line */
+  char    *save ;		/* filtered output: lines of the current object */
+  I64      saveSize ;
+} Range ;
+
+static OneExpr *filter = 0 ;	/* objects must pass this if set */
+
+static void *findBoundary (void *arg)	/* ascii: move start to next object line */
+{ Range *r = (Range *) arg ;
+  FILE  *f = r->vfIn->f ;
+  int    c = '\n' ;
+
+  if (fseeko (f, r->start-1, SEEK_SET) != 0) die ("failed to seek to %lld", r->start-1) ;
+  while (true)
+    { while (c != '\n' && c != EOF) c = getc (f) ;
+      if (c == EOF) break ;
+      if ((c = getc (f)) == r->vfIn->objectType)
+	{ r->start = ftello (f) - 1 ; return 0 ; }
+    }
+  r->start = ftello (f) ;	/* end of file */
+  return 0 ;
+}
+
+static inline bool isRangeEnd (Range *r, OneFile *vf, I64 lineStart)
+{ if (vf->isBinary)
+    return vf->lineType == vf->objectType && vf->object > r->end ;
+  else
+    return lineStart >= r->end ;
+}
+
+/* With a filter, the lines of each object, from its object line up to the next object or
+ * group line, are read for the filter to record their fields, and saved with oneSaveLine(),
+ * which keeps compressed lists compressed.  If the object passes, its saved lines are
+ * restored and transferred, so lists are only decoded for objects that are written, and the
+ * input is read once.  Lines outside objects, including group lines, are always transferred.
+ *
+ * The count in an ascii group line must be that of the objects written, which is not known
+ * when the line is written.  So for ascii output the ranges are first run without vfOut on a
+ * second reader of the input, to count the objects passing after each group line.
+ */
+
+static void countPass (Range *r, bool isGroup)
+{ if (isGroup)
+    { if (!(r->nPass & (r->nPass-1))) // grow at powers of 2
+	{ I64 *pass = new (2*(r->nPass ? r->nPass : 1), I64) ;
+	  if (r->nPass) { memcpy (pass, r->pass, r->nPass*sizeof(I64)) ; free (r->pass) ; }
+	  r->pass = pass ;
+	}
+      r->pass[r->nPass++] = 0 ;
+    }
+  else if (r->nPass)
+    ++r->pass[r->nPass-1] ;
+  else
+    ++r->carry ;
+}
+
+static void addCarries (Range *r, int n) // objects at the start of a range join the group before
+{ int i, j ;
+  for (i = 1 ; i < n ; ++i)
+    { j = i-1 ;
+      while (j >= 0 && !r[j].nPass) --j ;
+      if (j >= 0) r[j].pass[r[j].nPass-1] += r[i].carry ;
+    }
+}
+
+static I64 saveLine (Range *r, OneFile *vf, I64 at) /* returns the bytes used at r->save+at */
+{ I64 n = oneSaveLine (vf, r->save + at, r->saveSize - at) ;
+  if (n > r->saveSize - at)
+    { char *save = new (2*(at+n), char) ;
+      if (at) memcpy (save, r->save, at) ;
+      free (r->save) ;
+      r->save = save ; r->saveSize = 2*(at+n) ;
+      oneSaveLine (vf, r->save + at, n) ;
+    }
+  return n ;
+}
+
+static void *convertRange (void *arg)
+{ Range      *r = (Range *) arg ;
+  OneFile    *vfIn = r->vfIn, *vfOut = r->vfOut ;
+  OneExprVal *ev = filter ? oneExprValCreate (filter) : 0 ;
+  I64         lineStart ;
+  
+  if (vfIn->share < 0 || r->isSeek)
+    { if (vfIn->isBinary && !oneGotoObject (vfIn, r->start))
+	die ("can't locate to object %lld", r->start) ;
+      if (!vfIn->isBinary && fseeko (vfIn->f, r->start, SEEK_SET) != 0)
+	die ("failed to seek to %lld", r->start) ;
+    }
+
+  lineStart = ftello (vfIn->f) ;
+  oneReadLine (vfIn) ;
+  while (vfIn->lineType && !isRangeEnd (r, vfIn, lineStart))
+    if (!ev || vfIn->lineType != vfIn->objectType)
+      { if (vfIn->lineType == vfIn->groupType && (!vfOut || r->pass))
+	  { if (!vfOut)
+	      countPass (r, true) ;
+	    else if (r->iPass < r->nPass)
+	      oneInt(vfIn,0) = r->pass[r->iPass++] ;
+	  }
+	if (vfOut) transferLine (vfIn, vfOut, r->fieldSize) ;
+	lineStart = ftello (vfIn->f) ;
+	oneReadLine (vfIn) ;
+      }
+    else
+      { I64 n = 0, at ;	/* bytes of the object's lines saved */
+	
+	oneExprClear (ev) ;
+	do
+	  { oneExprRecord (ev, vfIn) ;
+	    if (vfOut) n += saveLine (r, vfIn, n) ;
+	    lineStart = ftello (vfIn->f) ;
+	  } while (oneReadLine (vfIn) && vfIn->lineType != vfIn->objectType
+		   && vfIn->lineType != vfIn->groupType) ;
+	
+	if (!oneExprEval (ev))
+	  continue ;
+	if (!vfOut)
+	  countPass (r, false) ;
+	else
+	  { char end = vfIn->lineType ;	/* the line that ended the object, 0 at the end */
+	    if (end) saveLine (r, vfIn, n) ;
+	    for (at = 0 ; at < n ; )
+	      { at += oneRestoreLine (vfIn, r->save + at) ;
+		transferLine (vfIn, vfOut, r->fieldSize) ;
+	      }
+	    if (end) oneRestoreLine (vfIn, r->save + n) ;
+	    else vfIn->lineType = 0 ;
+	  }
+      }
+
+  if (ev) oneExprValDestroy (ev) ;
+  return 0 ;
+}
+
+static void runRanges (Range *r, int n, bool isParallel)
+{ int        i ;
+  pthread_t *threads ;
+
+  if (!isParallel)
+    { for (i = 0 ; i < n ; ++i) convertRange (&r[i]) ;
+      return ;
+    }
+  threads = new (n, pthread_t) ;
+  for (i = 1 ; i < n ; ++i)
+    pthread_create (&threads[i], 0, convertRange, &r[i]) ;
+  convertRange (&r[0]) ;
+  for (i = 1 ; i < n ; ++i)
+    pthread_join (threads[i], 0) ;
+  free (threads) ;
+}
+
+  /* run the ranges, first on vfCount to count the passing objects of each group if given */
+
+static void convertCounted (Range *r, int n, bool isParallel, OneFile *vfCount)
+{ int i ;
+
+  if (vfCount)
+    { OneFile *vfIn = r[0].vfIn, *vfOut = r[0].vfOut ;
+      for (i = 0 ; i < n ; ++i)
+	{ r[i].vfIn = isParallel ? vfCount + i : vfCount ; r[i].vfOut = 0 ; }
+      runRanges (r, n, isParallel) ;
+      addCarries (r, n) ;
+      for (i = 0 ; i < n ; ++i)
+	{ r[i].vfIn = isParallel ? vfIn + i : vfIn ;
+	  r[i].vfOut = isParallel ? vfOut + i : vfOut ;
+	}
+    }
+  runRanges (r, n, isParallel) ;
+  for (i = 0 ; i < n ; ++i)
+    { free (r[i].pass) ; free (r[i].save) ; }
+}
+
+static void convertRanges (OneFile *vfIn, OneFile *vfOut, int nthreads, size_t *fieldSize,
+			   OneFile *vfCount)
+{ int        i, n = 1 ;
+  Range     *r = new0 (nthreads, Range) ;
+  pthread_t *threads = new (nthreads, pthread_t) ;
+
+  for (i = 0 ; i < nthreads ; ++i)
+    { r[i].vfIn = vfIn + i ; r[i].vfOut = vfOut + i ; r[i].fieldSize = fieldSize ; }
+  r[0].end = I64MAX ;
+  
+  if (vfIn->isBinary && vfIn->isIndexIn && vfIn->objectType)
+    { I64 nObj = vfIn->info[(int)vfIn->objectType]->given.count ;
+      n = nObj < nthreads ? nObj : nthreads ; // every range must have an object
+      if (n < 1) n = 1 ;
+      for (i = 0 ; i < n ; ++i)
+	{ r[i].start = (nObj * i) / n ;
+	  r[i].end = (nObj * (i+1)) / n ;
+	}
+    }
+  else if (!vfIn->isBinary && vfIn->objectType && nthreads > 1)
+    { I64 start = ftello (vfIn->f), size ;
+      if (fseeko (vfIn[1].f, 0, SEEK_END) != 0) die ("failed to seek to end of input") ;
+      size = ftello (vfIn[1].f) - start ;
+      n = nthreads ;
+      r[0].start = start ;
+      for (i = 1 ; i < n ; ++i)
+	{ r[i].start = start + (size * i) / n ;
+	  pthread_create (&threads[i], 0, findBoundary, &r[i]) ;
+	}
+      for (i = 1 ; i < n ; ++i)
+	pthread_join (threads[i], 0) ;
+      for (i = 0 ; i < n-1 ; ++i)
+	r[i].end = r[i+1].start ;
+      r[n-1].end = I64MAX ;
+    }
+
+  free (threads) ;
+  convertCounted (r, n, true, vfCount) ;
+  free (r) ;
+}
+
+/* For multithreaded binary output the list codecs are fixed before any data are written,
+ * taken from the input if binary or else trained on a sample of it, so that output does not
+ * depend on how the lines are divided among threads.  A single thread trains them as usual.
+ */
+
+#define TRAIN_SAMPLE_BYTES (1 << 26)
+
+static void installCodecs (OneFile *vfOut, OneFile *vfIn, char *inFileName,
+			   OneSchema *vs, char *fileType, size_t *fieldSize)
+{ int i ;
+  
+  if (vfIn->isBinary)
+    oneInheritCodecs (vfOut, vfIn) ;
+  else
+    { OneFile *vfSample = oneFileOpenRead (inFileName, vs, fileType, 1) ;
+      if (!vfSample) die ("failed to reopen %s to train codecs", inFileName) ;
+      if (!filter) streamLongLists (vfSample) ;
+      OneFile *vfTrain = oneFileOpenWriteFrom ("/dev/null", vfSample, true, 1) ;
+      if (!vfTrain) die ("failed to open scratch file to train codecs") ;
+      while (ftello (vfSample->f) < TRAIN_SAMPLE_BYTES && oneReadLine (vfSample))
+	transferLine (vfSample, vfTrain, fieldSize) ;
+      oneInheritCodecs (vfOut, vfTrain) ;
+      oneFileClose (vfTrain) ;
+      oneFileClose (vfSample) ;
+    }
+
+  for (i = 0 ; i < (vfOut->share ? vfOut->share : 1) ; ++i)
+    vfOut[i].codecTrainingSize = I64MAX ; // no further training
+}
+
+static OneFile *openInput (int argc, char **argv, OneSchema *vs, char *fileType,
+			   OnePartition *part, int nthreads)
+{
+  if (argc > 1)
+    return oneFileOpenReadCat (argc, argv, vs, fileType, nthreads) ;
+  else if (part)
+    return oneFileOpenReadPartition (argv[0], vs, fileType, part, 1) ;
+  else
+    return oneFileOpenRead (argv[0], vs, fileType, nthreads) ; /* reads the header */
+}
+
 int main (int argc, char **argv)
 {
   I64 i ;
+  int nthreads = 1 ;
   char *fileType = 0 ;
   char *outFileName = "-" ;
   char *schemaFileName = 0 ;
   bool isNoHeader = false, isHeaderOnly = false, isBinary = false, isVerbose = false ;
+  bool isCounts = false ;
   IndexList *objList = 0, *groupList = 0 ;
+  char *filterText = 0, *dropTypes = "" ;
+  char *zoneText = 0, *rangeText = 0, *partText = 0 ;
+  I64 zoneBlock = 1024 ;
   
   timeUpdate (0) ;
 
@@ -71,17 +403,30 @@ int main (int argc, char **argv)
   --argc ; ++argv ;		/* drop the program name */
 
   if (!argc)
-    { fprintf (stderr, "ONEview [options] onefile\n") ;
+    { fprintf (stderr, "ONEview [options] onefile [binary onefile]*\n") ;
       fprintf (stderr, "  -t --type <abc>           file type, e.g. seq, aln - required if no header\n") ;
       fprintf (stderr, "  -S --schema <schemafile>  schema file name\n") ;
       fprintf (stderr, "  -h --noHeader             skip the header in ascii output\n") ;
       fprintf (stderr, "  -H --headerOnly           only write the header (in ascii)\n") ;
       fprintf (stderr, "  -b --binary               write in binary (default is ascii)\n") ;
+      fprintf (stderr, "  -c --counts               ascii output: reserve header counts and fill them in at the end\n") ;
       fprintf (stderr, "  -o --output <filename>    output file name (default stdout)\n") ;
       fprintf (stderr, "  -i --index x[-y](,x[-y])* write specified objects\n") ;
       fprintf (stderr, "  -g --group x[-y](,x[-y])* write specified groups\n") ;
+      fprintf (stderr, "  -T --threads <n>          number of threads for conversion (default 1)\n") ;
+      fprintf (stderr, "  -f --filter <expr>        only write objects passing expr, e.g. 'S.len >= 10000 && W.3 > 0.8'\n") ;
+      fprintf (stderr, "  -x --exclude <abc>        do not write lines of types a, b, c\n") ;
+      fprintf (stderr, "  -z --zoneMap X.k(,Y.k)*   binary output: record min/max of fields per block of objects\n") ;
+      fprintf (stderr, "  -Z --zoneBlock <n>        objects per zone map block (default 1024)\n") ;
+      fprintf (stderr, "  -r --range X.k:lo:hi      only read blocks whose zone map for X.k may hold lo..hi,\n") ;
+      fprintf (stderr, "                            or the objects in lo..hi if the file is sorted on X.k\n") ;
+      fprintf (stderr, "  -P --partition <descr>    only read the partition given by a descriptor from ONEsplit -p\n") ;
       fprintf (stderr, "  -v --verbose              write commentary including timing\n") ;
       fprintf (stderr, "index and group only work for binary files; '-i 0-10' outputs first 10 objects\n") ;
+      fprintf (stderr, "threads need a named input file and are not used with index or group\n") ;
+      fprintf (stderr, "several binary files of the same type are read as one, numbering objects and groups across them\n") ;
+      fprintf (stderr, "filter terms are X.k for field k of the first X line of the object, or X.len for its list length\n") ;
+      fprintf (stderr, "range limits may be empty, e.g. 'S.len:20000:'; combine with a filter to select exactly\n") ;
       exit (0) ;
     }
   
@@ -100,6 +445,8 @@ int main (int argc, char **argv)
       { isHeaderOnly = true ; --argc ; ++argv ; }
     else if (!strcmp (*argv, "-b") || !strcmp (*argv, "--binary"))
       { isBinary = true ; --argc ; ++argv ; }
+    else if (!strcmp (*argv, "-c") || !strcmp (*argv, "--counts"))
+      { isCounts = true ; --argc ; ++argv ; }
     else if (!strcmp (*argv, "-v") || !strcmp (*argv, "--verbose"))
       { isVerbose = true ; --argc ; ++argv ; }
     else if (!strcmp (*argv, "-o") || !strcmp (*argv, "--output"))
@@ -108,37 +455,140 @@ int main (int argc, char **argv)
       { objList = parseIndexList (argv[1]) ; argc -= 2 ; argv += 2 ; }
     else if (!strcmp (*argv, "-g") || !strcmp (*argv, "--group"))
       { groupList = parseIndexList (argv[1]) ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-f") || !strcmp (*argv, "--filter"))
+      { filterText = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-x") || !strcmp (*argv, "--exclude"))
+      { dropTypes = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-z") || !strcmp (*argv, "--zoneMap"))
+      { zoneText = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-Z") || !strcmp (*argv, "--zoneBlock"))
+      { zoneBlock = atoll (argv[1]) ; argc -= 2 ; argv += 2 ;
+	if (zoneBlock < 1) die ("zone map block size %lld must be positive", zoneBlock) ;
+      }
+    else if (!strcmp (*argv, "-r") || !strcmp (*argv, "--range"))
+      { rangeText = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-P") || !strcmp (*argv, "--partition"))
+      { partText = argv[1] ; argc -= 2 ; argv += 2 ; }
+    else if (!strcmp (*argv, "-T") || !strcmp (*argv, "--threads"))
+      { nthreads = atoi (argv[1]) ; argc -= 2 ; argv += 2 ;
+	if (nthreads < 1) die ("number of threads %d must be positive", nthreads) ;
+      }
     else die ("unknown option %s - run without arguments to see options", *argv) ;
 
   if (isBinary) isNoHeader = false ;
   if (isHeaderOnly) isBinary = false ;
     
-  if (argc != 1)
-    die ("need a single data one-code file as argument") ;
+  if (argc < 1)
+    die ("need a data one-code file as argument") ;
 
   OneSchema *vs = 0 ;
   if (schemaFileName && !(vs = oneSchemaCreateFromFile (schemaFileName)))
       die ("failed to read schema file %s", schemaFileName) ;
-  OneFile *vfIn = oneFileOpenRead (argv[0], vs, fileType, 1) ; /* reads the header */
+  if (zoneText && !isBinary)
+    die ("zone maps can only be written to binary output") ;
+  if (objList || groupList || rangeText || partText || isHeaderOnly) nthreads = 1 ;
+  
+  OnePartition part ;
+  if (partText)
+    { if (argc > 1) die ("can't read a partition of several files") ;
+      if (objList || groupList || rangeText)
+	die ("can't combine a partition with selection by index, group or range") ;
+      if (!onePartitionParse (partText, &part))
+	die ("%s is not a partition descriptor from ONEsplit -p", partText) ;
+    }
+  OneFile *vfIn = openInput (argc, argv, vs, fileType, partText ? &part : 0, nthreads) ;
   if (!vfIn) die ("failed to open one file %s", argv[0]) ;
+  if (!vfIn->share) nthreads = 1 ; /* compressed input: the threads only inflated it */
 
-  if ((objList || groupList) && !vfIn->isBinary)
+  if ((objList || groupList || rangeText) && !vfIn->isBinary)
     die ("%s is ascii - you can only access objects and groups by index in binary files", argv[0]) ;
+
+  if (rangeText)
+    { if (objList || groupList)
+	die ("can't combine a zone range with selection by index or group") ;
+      objList = zoneIndexList (vfIn, rangeText) ;
+      if (isVerbose)
+	{ I64 n = 0 ; IndexList *ol ;
+	  for (ol = objList ; ol ; ol = ol->next) n += ol->iN - ol->i0 ;
+	  fprintf (stderr, "range selects %" PRId64 " of %" PRId64 " objects\n",
+		   n, vfIn->info[(int)vfIn->objectType]->given.count) ;
+	}
+    }
+
+  if (filterText)
+    { if (groupList)
+	die ("can't combine a filter with selection by group") ;
+      if (!strcmp (argv[0], "-"))
+	die ("filtering needs a named input file, not stdin") ;
+      if (!vfIn->objectType)
+	die ("can't filter a file without objects") ;
+      if (!(filter = oneExprCreate (vfIn, filterText)))
+	die ("failed to parse filter expression") ;
+    }
+  if (!filter)		/* filtering rereads objects, so needs whole lists */
+    streamLongLists (vfIn) ;
+  for ( ; *dropTypes ; ++dropTypes)
+    if (!vfIn->info[(int)*dropTypes] || !isalpha(*dropTypes))
+      die ("can't exclude %c - not a data line type of %s", *dropTypes, argv[0]) ;
+    else if (*dropTypes == vfIn->objectType)
+      die ("can't exclude the object line type %c", *dropTypes) ;
+    else
+      isDrop[(int)*dropTypes] = true ;
   
-  OneFile *vfOut = oneFileOpenWriteFrom (outFileName, vfIn, isBinary, 1) ;
+  OneFile *vfOut = oneFileOpenWriteFrom (outFileName, vfIn, isBinary, nthreads) ;
   if (!vfOut) die ("failed to open output file %s", outFileName) ;
+  for (i = 0 ; i < 128 ; ++i) // so the ascii header does not report excluded lines
+    if (isDrop[i] || (filter && !isBinary && vfOut->info[i])) // nor those of unfiltered input
+      memset (&vfOut->info[i]->given, 0, sizeof(vfOut->info[i]->given)) ;
+
+  if (vfIn->sortType && !groupList && (!objList || rangeText)) // the order is kept
+    oneSetSorted (vfOut, vfIn->sortType, vfIn->sortField) ;
 
   if (isHeaderOnly)
     oneWriteHeader (vfOut) ;
   else
     { oneAddProvenance (vfOut, "ONEview", "0.0", command, 0) ;
-      if (!isNoHeader) oneWriteHeader (vfOut) ;
       
       static size_t fieldSize[128] ;
       for (i = 0 ; i < 128 ; ++i)
 	if (vfIn->info[i]) fieldSize[i] = vfIn->info[i]->nField*sizeof(OneField) ;
+
+      if (isBinary && nthreads > 1 && strcmp (argv[0], "-"))
+	installCodecs (vfOut, vfIn, argv[0], vs, fileType, fieldSize) ;
+      for (char *z = zoneText ; z && *z ; )
+	{ char t ; int field ;
+	  z = parseZoneTerm (z, &t, &field) ;
+	  if (!oneAddZoneMap (vfOut, t, field, zoneBlock))
+	    die ("can't make a zone map for %c.%d - need an INT field or a list", t, field) ;
+	  if (*z == ',') ++z ;
+	  else if (*z) die ("bad separator %c in zone map list", *z) ;
+	}
+      if (isCounts && !isNoHeader && !oneReserveCounts (vfOut))
+	die ("-c needs output to a file, not a pipe") ;
+      if (!isNoHeader) oneWriteHeader (vfOut) ;
+
+      OneFile *vfCount = 0 ; // a second reader to count the objects passing in each group
+      if (filter && !isBinary && vfIn->groupType
+	  && !(vfCount = openInput (argc, argv, vs, fileType, partText ? &part : 0, nthreads)))
+	die ("failed to reopen %s to count objects in groups", argv[0]) ;
       
-      if (objList)
+      if (filter && (objList || rangeText))
+	{ IndexList *ol ;
+	  int        n = 0 ;
+	  for (ol = objList ; ol ; ol = ol->next) ++n ;
+	  Range *r = new0 (n ? n : 1, Range) ;
+	  for (n = 0, ol = objList ; ol ; ol = ol->next, ++n)
+	    { r[n].vfIn = vfIn ; r[n].vfOut = vfOut ; r[n].fieldSize = fieldSize ;
+	      r[n].start = ol->i0 ; r[n].end = ol->iN ; r[n].isSeek = true ;
+	    }
+	  convertCounted (r, n, false, vfCount) ;
+	  free (r) ;
+	}
+      else if (nthreads > 1 || filter)
+	{ if (isVerbose && nthreads > 1) fprintf (stderr, "converting with %d threads\n", nthreads) ;
+	  convertRanges (vfIn, vfOut, nthreads, fieldSize, vfCount) ;
+	}
+      else if (objList || rangeText)
 	{ while (objList)
 	    { if (!oneGotoObject (vfIn, objList->i0))
 		die ("can't locate to object %lld", objList->i0 ) ;
@@ -169,11 +619,13 @@ int main (int argc, char **argv)
       else
 	while (oneReadLine (vfIn))
 	  transferLine (vfIn, vfOut, fieldSize) ;
+      if (vfCount) oneFileClose (vfCount) ;
     }
   
   oneFileClose (vfIn) ;
   oneFileClose (vfOut) ;
   oneSchemaDestroy (vs) ;
+  if (filter) oneExprDestroy (filter) ;
   
   free (command) ;
   if (isVerbose)
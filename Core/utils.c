@@ -111,6 +111,16 @@ FILE *fopenTag (char* root, char* tag, char* mode)
   return f ;
 }
 
+char *commandLine (int argc, char **argv)
+{
+  int i, totLen = 0 ;
+  for (i = 0 ; i < argc ; ++i) totLen += 1 + strlen(argv[i]) ;
+  char *buf = new (totLen, char) ;
+  strcpy (buf, argv[0]) ;
+  for (i = 1 ; i < argc ; ++i) { strcat (buf, " ") ; strcat (buf, argv[i]) ; }
+  return buf ;
+}
+
 /***************** rusage for timing information ******************/
 
 #include <sys/resource.h>
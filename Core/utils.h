@@ -50,6 +50,7 @@ void *mycalloc (size_t number, size_t size) ;
 char *fgetword (FILE *f) ;	/* not threadsafe */
 FILE *fzopen (const char* path, const char* mode) ; /* will open gzip files silently */
 FILE *fopenTag (char* root, char* tag, char* mode) ;
+char *commandLine (int argc, char **argv) ; /* the arguments joined by spaces, for provenance */
 void timeUpdate (FILE *f) ;	/* print time usage since last call to file */
 void timeTotal (FILE *f) ;	/* print full time usage since first call to timeUpdate */
 
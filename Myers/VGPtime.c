@@ -0,0 +1,685 @@
+/*******************************************************************************************
+ *
+ *  VGPtime: Time the VGP conversion tools on generated data at a range of thread counts
+ *
+ *  Synthetic 10X style paired Illumina reads (fastq) and PacBio subreads (bam) are written
+ *    to a scratch directory and then VGPseq, VGPpair and VGPpacbio are run on them in
+ *    pipeline order with 1, 2, 4, ... up to -T threads.  Dazz2pbr and Dazz2sxs are timed
+ *    on a Dazzler database and .las file if these are given, as they cannot be generated
+ *    here.  VGPcloud is not run, as it reads the S-lines of its binary input directly in a
+ *    layout that ONElib no longer writes and so fails on any .irp file; instead the MSD radix
+ *    sort at the heart of VGPcloud is timed in process.  Each tool is run in a child process
+ *    and its wall time, user & system time and maximum RSS are taken from wait4(), the
+ *    getrusage() accounting of timeUpdate for that child alone: getrusage(RUSAGE_CHILDREN)
+ *    differences as in timeUpdate would do for times, but its maximum RSS is the largest
+ *    of all children so far, not that of the last tool.
+ *    One tab separated line is output per phase and thread count, so that runs of different
+ *    releases can be compared for scaling regressions.
+ *
+ *  Author:  vgp-tools contributors
+ *  Date  :  Oct. 18, 2026
+ *
+ ********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "gene_core.h"
+#include "msd.sort.h"
+
+#include "LIBDEFLATE/libdeflate.h"
+
+static char *Usage[] = { "[-vk] [-s<int(64)>] [-T<int(4)>] [-r<int(1)>] [-d<dir(.)>] [-P<dir>]",
+                         "      [-D<path:db> [-L<align:las>]]"
+                       };
+
+static int   VERBOSE;   //  -v: pass through tool stderr
+static int   KEEP;      //  -k: keep scratch directory
+static int   SIZE;      //  -s: MB of each generated data set
+static int   NTHREADS;  //  -T: maximum thread count
+static int   REPEATS;   //  -r: repetitions of each measurement, the fastest is reported
+static char *TOOLS;     //  -P: directory of the VGP tools, else that of VGPtime, else $PATH
+static char *DAZZ_DB;   //  -D: Dazzler database for Dazz2pbr
+static char *DAZZ_LAS;  //  -L: Dazzler .las file for Dazz2sxs
+
+static char *WORK;      //  Scratch directory
+
+#define READ_LEN    150   //  Illumina read length
+#define BAR_LEN      16   //  10X bar code length, followed by a 7bp linker
+#define PAIRS_PER   200   //  Mean pairs per bar code, > the VGPcloud threshold of 100,
+                          //    so the reads are ready for VGPcloud once it can be timed
+
+#define SUB_MEAN  10000   //  Mean PacBio subread length
+
+static char *DNA = "acgt";
+
+  //  xorshift64* random numbers, so the generated data are the same for every run
+
+static uint64 Seed = 0x9e3779b97f4a7c15ull;
+
+static inline uint64 rand64()
+{ Seed ^= Seed >> 12;
+  Seed ^= Seed << 25;
+  Seed ^= Seed >> 27;
+  return (Seed * 0x2545f4914f6cdd1dull);
+}
+
+static int64 file_size(char *path)
+{ struct stat info;
+
+  if (stat(path,&info) < 0)
+    return (0);
+  return (info.st_size);
+}
+
+static double seconds(struct timeval *tv)
+{ return (tv->tv_sec + 1e-6*tv->tv_usec); }
+
+
+/*******************************************************************************************
+ *
+ *  Data generation
+ *
+ ********************************************************************************************/
+
+  //  Paired reads in <WORK>/reads_1.fastq and reads_2.fastq, the forward reads starting with
+  //    one of npairs/PAIRS_PER bar codes and a linker as expected by VGPcloud.
+
+static void make_illumina()
+{ FILE  *f1, *f2;
+  int64  npairs, nbars, i;
+  uint64 *bars;
+  char   read[READ_LEN+1], qual[READ_LEN+1];
+  int    k;
+
+  npairs = (SIZE*1000000ll) / (4*READ_LEN + 40);
+  nbars  = npairs / PAIRS_PER;
+  if (nbars < 1)
+    nbars = 1;
+
+  bars = (uint64 *) Malloc(sizeof(uint64)*nbars,"Allocating bar codes");
+  if (bars == NULL)
+    exit (1);
+  for (i = 0; i < nbars; i++)
+    bars[i] = rand64();
+
+  f1 = fopen(Catenate(WORK,"/","reads_1",".fastq"),"w");
+  f2 = fopen(Catenate(WORK,"/","reads_2",".fastq"),"w");
+  if (f1 == NULL || f2 == NULL)
+    { fprintf(stderr,"%s: Cannot create fastq files in %s\n",Prog_Name,WORK);
+      exit (1);
+    }
+
+  read[READ_LEN] = qual[READ_LEN] = '\0';
+  for (i = 0; i < npairs; i++)
+    { uint64 bar = bars[rand64() % nbars];
+
+      for (k = 0; k < BAR_LEN; k++)
+        read[k] = DNA[(bar >> 2*k) & 0x3];
+      for ( ; k < READ_LEN; k++)
+        read[k] = DNA[rand64() & 0x3];
+      for (k = 0; k < READ_LEN; k++)
+        qual[k] = "FF:F,FFF"[rand64() & 0x7];
+      fprintf(f1,"@pair%lld/1\n%s\n+\n%s\n",i,read,qual);
+
+      for (k = 0; k < READ_LEN; k++)
+        { read[k] = DNA[rand64() & 0x3];
+          qual[k] = "FF:F,FFF"[rand64() & 0x7];
+        }
+      fprintf(f2,"@pair%lld/2\n%s\n+\n%s\n",i,read,qual);
+    }
+
+  fclose(f2);
+  fclose(f1);
+  free(bars);
+}
+
+  //  Subreads in <WORK>/reads.subreads.bam with the tags VGPpacbio reads, including snr
+  //    and pulse widths so that arrow output (-a) can be timed.  BGZF blocks are compressed
+  //    with libdeflate at level 1 and the host is assumed to be little-endian, as is BAM.
+
+#define BGZF_BLOCK 0xff00
+
+static struct libdeflate_compressor *Bgzf_Comp;
+static uint8 Bgzf_In[BGZF_BLOCK], Bgzf_Out[BGZF_BLOCK+1024];
+static int   Bgzf_Len;
+
+static void bgzf_flush(FILE *f)
+{ uint32 crc, isize;
+  int    dlen;
+
+  dlen = libdeflate_deflate_compress(Bgzf_Comp,Bgzf_In,Bgzf_Len,Bgzf_Out+18,BGZF_BLOCK+1000);
+  memcpy(Bgzf_Out,"\037\213\010\004\0\0\0\0\0\377\006\0BC\002\0",16);
+  Bgzf_Out[16] = (dlen+25) & 0xff;
+  Bgzf_Out[17] = (dlen+25) >> 8;
+  crc   = libdeflate_crc32(0,Bgzf_In,Bgzf_Len);
+  isize = Bgzf_Len;
+  memcpy(Bgzf_Out+18+dlen,&crc,4);
+  memcpy(Bgzf_Out+22+dlen,&isize,4);
+  fwrite(Bgzf_Out,dlen+26,1,f);
+  Bgzf_Len = 0;
+}
+
+static void bgzf_write(FILE *f, void *data, int len)
+{ uint8 *d = (uint8 *) data;
+  int    n;
+
+  while (len > 0)
+    { n = BGZF_BLOCK - Bgzf_Len;
+      if (n > len)
+        n = len;
+      memcpy(Bgzf_In+Bgzf_Len,d,n);
+      Bgzf_Len += n;
+      d   += n;
+      len -= n;
+      if (Bgzf_Len == BGZF_BLOCK)
+        bgzf_flush(f);
+    }
+}
+
+static void make_pacbio()
+{ FILE  *f;
+  int64  total, zmw;
+  uint8 *rec, *r;
+  char   name[64];
+  int    len, k, n;
+  int32  x;
+  uint16 y;
+  float  z;
+
+  f = fopen(Catenate(WORK,"/","reads",".subreads.bam"),"w");
+  if (f == NULL)
+    { fprintf(stderr,"%s: Cannot create bam file in %s\n",Prog_Name,WORK);
+      exit (1);
+    }
+  rec = (uint8 *) Malloc(8*SUB_MEAN+1000,"Allocating bam record");
+  if (rec == NULL)
+    exit (1);
+  Bgzf_Comp = libdeflate_alloc_compressor(1);
+  Bgzf_Len  = 0;
+
+  x = 0;
+  bgzf_write(f,"BAM\001",4);    //  no header text and no reference sequences
+  bgzf_write(f,&x,4);
+  bgzf_write(f,&x,4);
+
+#define PUT(v,size) { memcpy(r,&(v),size); r += size; }
+
+  total = 0;
+  for (zmw = 0; total < SIZE*1000000ll; zmw++)
+    { len = SUB_MEAN/2 + rand64() % SUB_MEAN;
+      n   = sprintf(name,"m54000_200101_000000/%lld/0_%d",zmw,len) + 1;
+
+      r = rec+4;
+      x = -1;             PUT(x,4)    //  refID, pos
+                          PUT(x,4)
+      rec[12] = n;                    //  l_read_name, mapq, bin
+      rec[13] = 255;
+      y = 4680;
+      r = rec+14;         PUT(y,2)
+      y = 0;              PUT(y,2)    //  n_cigar_op, flag
+      y = 4;              PUT(y,2)
+      x = len;            PUT(x,4)
+      x = -1;             PUT(x,4)    //  next refID, pos, tlen
+                          PUT(x,4)
+      x = 0;              PUT(x,4)
+      memcpy(r,name,n);
+      r += n;
+      for (k = 0; k < len; k += 2)    //  4-bit bases, A=1 C=2 G=4 T=8
+        *r++ = (1 << (rand64() & 0x3)) << 4 | (k+1 < len ? 1 << (rand64() & 0x3) : 0);
+      memset(r,0xff,len);             //  no quality values
+      r += len;
+
+      memcpy(r,"npC",3);  r += 3;  *r++ = 1;
+      memcpy(r,"rqf",3);  r += 3;  z = .8 + .01*(rand64() % 10);  PUT(z,4)
+      memcpy(r,"zmi",3);  r += 3;  x = zmw;  PUT(x,4)
+      memcpy(r,"qsi",3);  r += 3;  x = 0;    PUT(x,4)
+      memcpy(r,"qei",3);  r += 3;  x = len;  PUT(x,4)
+      memcpy(r,"snBf",4); r += 4;  x = 4;    PUT(x,4)
+      for (k = 0; k < 4; k++)
+        { z = 4.5 + k;
+          PUT(z,4)
+        }
+      memcpy(r,"pwBC",4); r += 4;  x = len;  PUT(x,4)
+      for (k = 0; k < len; k++)
+        *r++ = 1 + (rand64() % 7);
+
+      x = (r-rec) - 4;
+      memcpy(rec,&x,4);
+      bgzf_write(f,rec,r-rec);
+      total += r-rec;
+    }
+
+  if (Bgzf_Len > 0)
+    bgzf_flush(f);
+  bgzf_flush(f);                      //  empty end-of-file block
+
+  libdeflate_free_compressor(Bgzf_Comp);
+  fclose(f);
+  free(rec);
+}
+
+
+/*******************************************************************************************
+ *
+ *  Running and timing a tool in a child process
+ *
+ ********************************************************************************************/
+
+typedef struct
+  { double wall;     //  seconds
+    double user;
+    double system;
+    int64  maxrss;   //  KB
+  } Timing;
+
+  //  Run tool with argument list args (NULL terminated, args[0] is overwritten) with standard
+  //    output to out if not NULL, adding its resource usage to *t.  Returns 0 if the tool
+  //    failed, so that the remaining phases can still be timed.
+
+static int run_tool(char *tool, char **args, char *out, Timing *t)
+{ struct timeval start, end;
+  struct rusage  usage;
+  pid_t          pid;
+  int            status;
+
+  gettimeofday(&start,NULL);
+  pid = fork();
+  if (pid < 0)
+    { fprintf(stderr,"%s: Cannot fork\n",Prog_Name);
+      exit (1);
+    }
+
+  if (pid == 0)
+    { int fd;
+
+      if (chdir(WORK) < 0)
+        exit (1);
+      if (out != NULL)
+        { fd = open(out,O_WRONLY|O_CREAT|O_TRUNC,0644);
+          if (fd < 0 || dup2(fd,1) < 0)
+            exit (1);
+          close(fd);
+        }
+      if (!VERBOSE)
+        { fd = open("/dev/null",O_WRONLY);
+          if (fd < 0 || dup2(fd,2) < 0)
+            exit (1);
+          close(fd);
+        }
+      args[0] = tool;
+      if (TOOLS != NULL)
+        execv(Catenate(TOOLS,"/",tool,""),args);
+      else
+        execvp(tool,args);
+      _exit (127);
+    }
+
+  if (wait4(pid,&status,0,&usage) < 0)
+    { fprintf(stderr,"%s: Lost child process running %s\n",Prog_Name,tool);
+      exit (1);
+    }
+  gettimeofday(&end,NULL);
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    { if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+        fprintf(stderr,"%s: Cannot execute %s, use -P to give its directory\n",Prog_Name,tool);
+      else
+        fprintf(stderr,"%s: %s failed, rerun with -v to see its messages\n",Prog_Name,tool);
+      return (0);
+    }
+
+  t->wall   += seconds(&end) - seconds(&start);
+  t->user   += seconds(&usage.ru_utime);
+  t->system += seconds(&usage.ru_stime);
+  if (usage.ru_maxrss > t->maxrss)
+    t->maxrss = usage.ru_maxrss;
+  return (1);
+}
+
+  //  The radix sort of VGPcloud on 16-byte records with a 4-byte key, in process
+
+static uint8 *Sort_Data, *Sort_Array;
+static int64  Sort_Parts[256], Sort_Nrec;
+
+#define SORT_REC  16
+
+static void prep_sort()
+{ int64 i, off[256], x;
+
+  Sort_Nrec  = (SIZE*1000000ll) / SORT_REC;
+  Sort_Data  = (uint8 *) Malloc(Sort_Nrec*SORT_REC,"Allocating sort records");
+  Sort_Array = (uint8 *) Malloc(Sort_Nrec*SORT_REC,"Allocating sort array");
+  if (Sort_Data == NULL || Sort_Array == NULL)
+    exit (1);
+
+  for (i = 0; i < Sort_Nrec*SORT_REC; i += 8)
+    *((uint64 *) (Sort_Data+i)) = rand64();
+
+  //  Place records in order of their 1st byte, as VGPcloud does before calling MSD_Sort
+
+  for (i = 0; i < 256; i++)
+    Sort_Parts[i] = 0;
+  for (i = 0; i < Sort_Nrec; i++)
+    Sort_Parts[Sort_Data[i*SORT_REC]] += SORT_REC;
+  x = 0;
+  for (i = 0; i < 256; i++)
+    { off[i] = x;
+      x += Sort_Parts[i];
+    }
+  for (i = 0; i < Sort_Nrec; i++)
+    { uint8 *r = Sort_Data + i*SORT_REC;
+      memcpy(Sort_Array + off[*r],r,SORT_REC);
+      off[*r] += SORT_REC;
+    }
+  memcpy(Sort_Data,Sort_Array,Sort_Nrec*SORT_REC);
+}
+
+static void run_sort(int nthreads, Timing *t)
+{ struct timeval start, end;
+  struct rusage  before, after;
+  int64          parts[256];
+
+  memcpy(Sort_Array,Sort_Data,Sort_Nrec*SORT_REC);
+  memcpy(parts,Sort_Parts,sizeof(parts));
+
+  getrusage(RUSAGE_SELF,&before);
+  gettimeofday(&start,NULL);
+
+  MSD_Sort(Sort_Array,Sort_Nrec,SORT_REC,SORT_REC,4,parts,nthreads);
+
+  gettimeofday(&end,NULL);
+  getrusage(RUSAGE_SELF,&after);
+
+  t->wall   += seconds(&end) - seconds(&start);
+  t->user   += seconds(&after.ru_utime) - seconds(&before.ru_utime);
+  t->system += seconds(&after.ru_stime) - seconds(&before.ru_stime);
+  t->maxrss  = after.ru_maxrss;
+}
+
+
+/*******************************************************************************************
+ *
+ *  Phases
+ *
+ ********************************************************************************************/
+
+typedef enum { SEQ, PAIR, PACBIO, DAZZ2PBR, DAZZ2SXS, SORT, NPHASE } Phase;
+
+static char *Phase_Name[NPHASE] =
+  { "VGPseq", "VGPpair", "VGPpacbio", "Dazz2pbr", "Dazz2sxs", "msd.sort" };
+
+  //  Run phase p once with nthreads threads, returning the input and output bytes.
+  //    Returns 0 if a tool failed.
+
+static int run_phase(Phase p, int nthreads, Timing *t, int64 *in, int64 *out)
+{ char  targ[20];
+  char *args[8];
+
+  sprintf(targ,"-T%d",nthreads);
+  args[1] = targ;
+
+#define SIZE_OF(name) file_size(Catenate(WORK,"/",name,""))
+
+  switch (p)
+  { case SEQ:
+      args[2] = "-q";
+      args[3] = "reads_1.fastq";
+      args[4] = NULL;
+      if (!run_tool("VGPseq",args,"reads_1.seq",t))
+        return (0);
+      args[3] = "reads_2.fastq";
+      if (!run_tool("VGPseq",args,"reads_2.seq",t))
+        return (0);
+      *in  = SIZE_OF("reads_1.fastq") + SIZE_OF("reads_2.fastq");
+      *out = SIZE_OF("reads_1.seq") + SIZE_OF("reads_2.seq");
+      break;
+    case PAIR:
+      args[2] = "reads_1.seq";
+      args[3] = "reads_2.seq";
+      args[4] = NULL;
+      if (!run_tool("VGPpair",args,"reads.irp",t))
+        return (0);
+      *in  = SIZE_OF("reads_1.seq") + SIZE_OF("reads_2.seq");
+      *out = SIZE_OF("reads.irp");
+      break;
+    case PACBIO:
+      args[2] = "-a";
+      args[3] = "reads.subreads.bam";
+      args[4] = NULL;
+      if (!run_tool("VGPpacbio",args,"reads.pbr",t))
+        return (0);
+      *in  = SIZE_OF("reads.subreads.bam");
+      *out = SIZE_OF("reads.pbr");
+      break;
+    case DAZZ2PBR:
+      args[2] = DAZZ_DB;
+      args[3] = NULL;
+      if (!run_tool("Dazz2pbr",args,"dazz.pbr",t))
+        return (0);
+      *in  = file_size(Catenate(PathTo(DAZZ_DB),"/.",Root(DAZZ_DB,".db"),".bps"));
+      *out = SIZE_OF("dazz.pbr");
+      break;
+    case DAZZ2SXS:
+      args[2] = "dazz.pbr";
+      args[3] = DAZZ_LAS;
+      args[4] = NULL;
+      if (!run_tool("Dazz2sxs",args,"dazz.sxs",t))
+        return (0);
+      *in  = SIZE_OF("dazz.pbr") + file_size(DAZZ_LAS);
+      *out = SIZE_OF("dazz.sxs");
+      break;
+    case SORT:
+      if (Sort_Data == NULL)     //  allocated last, as a child's max RSS includes its parent's
+        prep_sort();
+      run_sort(nthreads,t);
+      *in  = *out = Sort_Nrec*SORT_REC;
+      break;
+    default:
+      break;
+  }
+  return (1);
+}
+
+  //  Remove the scratch directory and everything in it
+
+static void remove_work()
+{ DIR           *dir;
+  struct dirent *ent;
+
+  dir = opendir(WORK);
+  if (dir == NULL)
+    return;
+  while ((ent = readdir(dir)) != NULL)
+    if (strcmp(ent->d_name,".") != 0 && strcmp(ent->d_name,"..") != 0)
+      unlink(Catenate(WORK,"/",ent->d_name,""));
+  closedir(dir);
+  rmdir(WORK);
+}
+
+
+/*******************************************************************************************
+ *
+ *  Main
+ *
+ ********************************************************************************************/
+
+int main(int argc, char *argv[])
+{ char *dir;
+  int   nthr, threads[32];
+
+  //  Process command line arguments
+
+  { int   i, j, k;
+    int   flags[128];
+    char *eptr;
+
+    ARG_INIT("VGPtime")
+
+    SIZE     = 64;
+    NTHREADS = 4;
+    REPEATS  = 1;
+    dir      = ".";
+    TOOLS    = NULL;
+    DAZZ_DB  = NULL;
+    DAZZ_LAS = NULL;
+
+    j = 1;
+    for (i = 1; i < argc; i++)
+      if (argv[i][0] == '-')
+        switch (argv[i][1])
+        { default:
+            ARG_FLAGS("vk")
+            break;
+          case 's':
+            ARG_POSITIVE(SIZE,"Data set size")
+            break;
+          case 'T':
+            ARG_POSITIVE(NTHREADS,"Number of threads")
+            break;
+          case 'r':
+            ARG_POSITIVE(REPEATS,"Number of repetitions")
+            break;
+          case 'd':
+            dir = argv[i]+2;
+            break;
+          case 'P':
+            TOOLS = argv[i]+2;
+            break;
+          case 'D':
+            DAZZ_DB = argv[i]+2;
+            break;
+          case 'L':
+            DAZZ_LAS = argv[i]+2;
+            break;
+        }
+      else
+        argv[j++] = argv[i];
+    argc = j;
+
+    VERBOSE = flags['v'];
+    KEEP    = flags['k'];
+
+    if (argc != 1 || (DAZZ_LAS != NULL && DAZZ_DB == NULL))
+      { fprintf(stderr,"\nUsage: %s %s\n",Prog_Name,Usage[0]);
+        fprintf(stderr,"       %*s %s\n",(int) strlen(Prog_Name),"",Usage[1]);
+        fprintf(stderr,"\n");
+        fprintf(stderr,"      -v: Pass through the messages of the tools\n");
+        fprintf(stderr,"      -k: Keep the scratch directory and all files in it\n");
+        fprintf(stderr,"      -s: MB of Illumina and of PacBio data to generate\n");
+        fprintf(stderr,"      -T: Time with 1, 2, 4, ... up to this many threads\n");
+        fprintf(stderr,"      -r: Repeat each measurement and report the fastest\n");
+        fprintf(stderr,"      -d: Directory in which to make the scratch directory\n");
+        fprintf(stderr,"      -P: Directory of the VGP tools\n");
+        fprintf(stderr,"      -D: Dazzler database to time Dazz2pbr on\n");
+        fprintf(stderr,"      -L: Dazzler .las file of the -D database to time Dazz2sxs on\n");
+        exit (1);
+      }
+
+    //  Tools in the same directory as VGPtime are preferred if it was invoked by path
+
+    if (TOOLS == NULL && index(argv[0],'/') != NULL)
+      TOOLS = PathTo(argv[0]);
+    if (TOOLS != NULL && TOOLS[0] != '/')
+      { char cwd[4096];
+        if (getcwd(cwd,4096) == NULL)
+          exit (1);
+        TOOLS = Strdup(Catenate(cwd,"/",TOOLS,""),"Allocating tool path");
+      }
+    if (DAZZ_DB != NULL && DAZZ_DB[0] != '/')
+      { char cwd[4096];
+        if (getcwd(cwd,4096) == NULL)
+          exit (1);
+        DAZZ_DB = Strdup(Catenate(cwd,"/",DAZZ_DB,""),"Allocating db path");
+        if (DAZZ_LAS != NULL && DAZZ_LAS[0] != '/')
+          DAZZ_LAS = Strdup(Catenate(cwd,"/",DAZZ_LAS,""),"Allocating las path");
+      }
+
+    nthr = 0;
+    for (k = 1; k < NTHREADS && nthr < 31; k *= 2)
+      threads[nthr++] = k;
+    threads[nthr++] = NTHREADS;
+  }
+
+  //  Make scratch directory and generate the data sets
+
+  WORK = Strdup(Catenate(dir,"/","VGPtime.XXXXXX",""),"Allocating scratch name");
+  if (mkdtemp(WORK) == NULL)
+    { fprintf(stderr,"%s: Cannot make scratch directory in %s\n",Prog_Name,dir);
+      exit (1);
+    }
+  if (WORK[0] != '/')
+    { char cwd[4096];
+      if (getcwd(cwd,4096) == NULL)
+        exit (1);
+      WORK = Strdup(Catenate(cwd,"/",WORK,""),"Allocating scratch name");
+    }
+
+  if (VERBOSE)
+    fprintf(stderr,"  Generating %d MB of Illumina and of PacBio data in %s\n",SIZE,WORK);
+  make_illumina();
+  make_pacbio();
+
+  //  Time each phase at each thread count, in pipeline order so each phase has its input
+
+  { Phase  p;
+    int    i, r;
+    double base;
+
+    printf("#phase\tthreads\tin_bytes\tout_bytes\twall_s\tuser_s\tsystem_s\tcpu/wall");
+    printf("\tmax_RSS_KB\tMB/s\tspeedup\n");
+    fflush(stdout);
+
+    for (p = 0; p < NPHASE; p++)
+      { if ((p == DAZZ2PBR && DAZZ_DB == NULL) || (p == DAZZ2SXS && DAZZ_LAS == NULL))
+          continue;
+        base = 0.;
+        for (i = 0; i < nthr; i++)
+          { Timing best, t;
+            int64  in, out;
+
+            memset(&best,0,sizeof(Timing));
+            in = out = 0;
+
+            if (VERBOSE)
+              fprintf(stderr,"  Timing %s with %d threads\n",Phase_Name[p],threads[i]);
+            for (r = 0; r < REPEATS; r++)
+              { memset(&t,0,sizeof(Timing));
+                if (!run_phase(p,threads[i],&t,&in,&out))
+                  break;
+                if (r == 0 || t.wall < best.wall)
+                  best = t;
+              }
+            if (r < REPEATS)
+              break;
+            if (i == 0)
+              base = best.wall;
+
+            printf("%s\t%d\t%lld\t%lld\t%.3f\t%.3f\t%.3f\t%.2f\t%lld\t%.1f\t%.2f\n",
+                   Phase_Name[p],threads[i],in,out,best.wall,best.user,best.system,
+                   (best.user+best.system)/best.wall,best.maxrss,in/(1e6*best.wall),
+                   base/best.wall);
+            fflush(stdout);
+          }
+      }
+  }
+
+  if (KEEP)
+    fprintf(stderr,"  Files kept in %s\n",WORK);
+  else
+    remove_work();
+
+  free(Sort_Data);
+  free(Sort_Array);
+
+  exit (0);
+}
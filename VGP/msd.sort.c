@@ -339,6 +339,13 @@ void MSD_Sort(uint8 *array, int64 nelem, int rsize, int dsize, int ksize, int64
           off = sum;
         }
     }
+  while (n < nthreads)     //  fewer occupied buckets than threads: idle the rest
+    { parms[n].array  = array;
+      parms[n].npart  = 0;
+      parms[n].parts  = Parts;
+      parms[n].offset = off;
+      n += 1;
+    }
 
 #ifdef DEBUG
   for (x = 0; x < nthreads; x++)